@@ -21,28 +21,35 @@
 #ifndef hpp_rshell_AppendRedirectionCommand
 #define hpp_rshell_AppendRedirectionCommand
 
-#include "Command.hpp"
-#include <memory>
+#include "RedirectionCommand.hpp"
 #include <string>
 
 namespace rshell {
 
-/// \brief Command to be executed with a replaced standard output in append
-/// mode
-class AppendRedirectionCommand : public Command
+/// \brief Command to be executed with a replaced output descriptor in
+/// append mode
+class AppendRedirectionCommand : public RedirectionCommand
 {
 public:
-    std::unique_ptr<Command> primary; //!< Primary command to execute
     std::string path; //!< Path to append to
 
+    /// \brief Whether or not the standard error is replaced along with the
+    /// descriptor, as in "foo &>> bar"
+    bool isCombined{false};
+
+    /// \brief Constructs a new instance of the \ref AppendRedirectionCommand
+    /// class replacing the standard output
+    AppendRedirectionCommand();
+
     /// \brief Destructs the \ref AppendRedirectionCommand instance
     virtual ~AppendRedirectionCommand();
 
-    /// \brief Executes the command using the given executor
-    /// \param executor executor to use for execution
-    /// \param waitMode wait mode to use when executing
-    /// \return exit code of the command
-    virtual int execute(Executor& executor, WaitMode waitMode) override;
+    /// \brief Applies the redirection alone to a context
+    /// \param executor executor to create streams on
+    /// \param context context to redirect
+    /// \return redirected context
+    virtual ExecutionContext redirect(Executor& executor,
+            const ExecutionContext& context) const override;
 };
 
 } // namespace rshell
@@ -0,0 +1,565 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "CacheBuiltinCommand.hpp"
+#include "Executor.hpp"
+#include "ExecutorJob.hpp"
+#include "ExecutorStream.hpp"
+#include "Parser.hpp"
+#include "utility/sha256.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+using namespace rshell;
+
+/// \brief Size of the buffer files are read into
+constexpr std::size_t bufferSize = 65536;
+
+/// \brief Record following the standard output in each entry of the store
+struct Trailer
+{
+    char magic[12]; //!< Identifies the entry as a result of the cache
+    std::int32_t exitCode; //!< Exit code of the command
+};
+
+/// \brief Magic string identifying entries of the store, including the
+/// version of their format
+constexpr char trailerMagic[12] = "rshcache-v1";
+
+/// \brief Whether or not the calling thread is executing the command in a
+/// subshell of its own
+thread_local bool isInSubshell = false;
+
+/// \brief Appends a field to a key, prefixed by its length so that no two
+/// sequences of fields are hashed alike
+/// \param key key to append to
+/// \param field field to append
+void hashField(utility::sha256& key, const std::string& field)
+{
+    std::uint64_t size = field.size();
+    unsigned char prefix[8];
+    for (auto i = 0; i < 8; ++i) {
+        prefix[i] = static_cast<unsigned char>(size >> (56 - i * 8));
+    }
+
+    key.update(prefix, sizeof(prefix));
+    key.update(field);
+}
+
+/// \brief Hashes the contents of a file
+/// \param path path of the file
+/// \return hash of the contents, or an empty string if the file cannot be
+/// read
+std::string hashContents(const std::string& path)
+{
+    auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        return {};
+    }
+
+    utility::sha256 hash;
+    char buffer[bufferSize];
+    ssize_t count;
+    while ((count = ::read(file, buffer, sizeof(buffer))) != 0) {
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            ::close(file);
+            return {};
+        }
+
+        hash.update(buffer, count);
+    }
+
+    ::close(file);
+    return hash.hex_digest();
+}
+
+/// \brief Describes the modification time and size of a file
+/// \param path path of the file
+/// \return description of the file, or an empty string if it is missing
+std::string describeFile(const std::string& path)
+{
+    struct stat status;
+    if (::stat(path.c_str(), &status) < 0) {
+        return {};
+    }
+
+    return std::to_string(status.st_mtim.tv_sec) + "." +
+        std::to_string(status.st_mtim.tv_nsec) + " " +
+        std::to_string(status.st_size);
+}
+
+/// \brief Gets the default directory of the store
+/// \return path of the directory
+std::string defaultDirectory()
+{
+    if (auto cache = std::getenv("XDG_CACHE_HOME")) {
+        if (*cache != '\0') {
+            return std::string{cache} + "/rshell";
+        }
+    }
+
+    if (auto home = std::getenv("HOME")) {
+        if (*home != '\0') {
+            return std::string{home} + "/.cache/rshell";
+        }
+    }
+
+    return "/tmp/rshell-cache-" + std::to_string(::getuid());
+}
+
+/// \brief Creates a directory along with any missing parents
+/// \param path path of the directory
+/// \return whether or not the directory exists
+bool createDirectories(const std::string& path)
+{
+    for (auto end = path.find('/', 1); ; end = path.find('/', end + 1)) {
+        auto prefix = path.substr(0, end);
+        if (::mkdir(prefix.c_str(), 0700) < 0 && errno != EEXIST) {
+            return false;
+        }
+
+        if (end == std::string::npos) {
+            return true;
+        }
+    }
+}
+
+/// \brief Determines whether a name is that of an entry of the store
+/// \param name name to check
+/// \return whether or not the name is a key
+bool isKey(const char* name)
+{
+    auto length = std::strlen(name);
+    return length == 64 &&
+        std::all_of(name, name + length, [](char c)
+        {
+            return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+        });
+}
+
+/// \brief Takes the lock on an entry of the store, waiting while another
+/// invocation holds it
+/// \param path path of the lock file
+/// \return descriptor holding the lock, or -1 on failure
+///
+/// Lock files are removed as they are released, so a lock taken on a file
+/// that has since been removed is taken again on its replacement.
+int lockEntry(const std::string& path)
+{
+    for (;;) {
+        auto file = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        if (file < 0) {
+            return -1;
+        }
+
+        while (::flock(file, LOCK_EX) < 0) {
+            if (errno != EINTR) {
+                ::close(file);
+                return -1;
+            }
+        }
+
+        struct stat held;
+        struct stat current;
+        if (::fstat(file, &held) == 0 && ::stat(path.c_str(), &current) == 0 &&
+                held.st_dev == current.st_dev &&
+                held.st_ino == current.st_ino) {
+            return file;
+        }
+
+        ::close(file);
+    }
+}
+
+/// \brief Takes the lock on an entry of the store unless another invocation
+/// holds it
+/// \param path path of the lock file
+/// \return descriptor holding the lock, or -1 if it is held or on failure
+int tryLockEntry(const std::string& path)
+{
+    auto file = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (file < 0) {
+        return -1;
+    }
+
+    struct stat held;
+    struct stat current;
+    if (::flock(file, LOCK_EX | LOCK_NB) == 0 && ::fstat(file, &held) == 0 &&
+            ::stat(path.c_str(), &current) == 0 &&
+            held.st_dev == current.st_dev &&
+            held.st_ino == current.st_ino) {
+        return file;
+    }
+
+    ::close(file);
+    return -1;
+}
+
+/// \brief Releases the lock on an entry of the store
+/// \param path path of the lock file
+/// \param file descriptor holding the lock
+///
+/// The lock file is removed while still held, so that the store holds only
+/// its entries.  An invocation waiting on the removed file then takes the
+/// lock again on a new one.
+void unlockEntry(const std::string& path, int file)
+{
+    ::unlink(path.c_str());
+    ::close(file);
+}
+
+/// \brief Copies the start of a file to the standard output
+/// \param file descriptor of the file
+/// \param size number of bytes to copy
+void copyOutput(int file, off_t size)
+{
+    std::cout.flush();
+
+    // Prefer copying within the kernel, falling back to reading and writing
+    // where the standard output does not support it
+    off_t offset = 0;
+    while (offset < size) {
+        auto count = ::sendfile(STDOUT_FILENO, file, &offset, size - offset);
+        if (count <= 0) {
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            break;
+        }
+    }
+
+    char buffer[bufferSize];
+    while (offset < size) {
+        auto count = ::pread(file, buffer, std::min<off_t>(sizeof(buffer),
+                    size - offset), offset);
+        if (count <= 0) {
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            return;
+        }
+
+        for (ssize_t written = 0; written < count; ) {
+            auto result = ::write(STDOUT_FILENO, buffer + written,
+                    count - written);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                return;
+            }
+
+            written += result;
+        }
+
+        offset += count;
+    }
+}
+
+/// \brief Replays an entry of the store to the standard output
+/// \param path path of the entry
+/// \param exitCode exit code of the entry
+/// \return whether or not the entry exists and is valid
+bool replay(const std::string& path, int& exitCode)
+{
+    auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        return false;
+    }
+
+    Trailer trailer;
+    struct stat status;
+    if (::fstat(file, &status) < 0 ||
+            status.st_size < static_cast<off_t>(sizeof(trailer)) ||
+            ::pread(file, &trailer, sizeof(trailer),
+                status.st_size - sizeof(trailer)) !=
+            static_cast<ssize_t>(sizeof(trailer)) ||
+            std::memcmp(trailer.magic, trailerMagic, sizeof(trailerMagic)) !=
+            0) {
+        ::close(file);
+        return false;
+    }
+
+    // Mark the entry as recently used, so that eviction spares it
+    ::futimens(file, nullptr);
+
+    copyOutput(file, status.st_size - sizeof(trailer));
+    ::close(file);
+    exitCode = trailer.exitCode;
+    return true;
+}
+
+/// \brief Evicts the least recently used entries of the store until the
+/// remaining entries fit in the budget
+/// \param directory path of the directory of the store
+/// \param limit budget in bytes
+void evict(const std::string& directory, std::size_t limit)
+{
+    auto stream = ::opendir(directory.c_str());
+    if (stream == nullptr) {
+        return;
+    }
+
+    struct Entry
+    {
+        timespec used; //!< Time the entry was last used
+        off_t size; //!< Size of the entry in bytes
+        std::string name; //!< Name of the entry
+    };
+
+    std::vector<Entry> entries;
+    std::size_t total = 0;
+    while (auto entry = ::readdir(stream)) {
+        struct stat status;
+        if (isKey(entry->d_name) && ::fstatat(::dirfd(stream), entry->d_name,
+                    &status, 0) == 0) {
+            entries.push_back({status.st_mtim, status.st_size,
+                    entry->d_name});
+            total += status.st_size;
+        }
+    }
+
+    ::closedir(stream);
+
+    std::sort(std::begin(entries), std::end(entries),
+            [](const Entry& a, const Entry& b)
+            {
+                return a.used.tv_sec != b.used.tv_sec ?
+                    a.used.tv_sec < b.used.tv_sec :
+                    a.used.tv_nsec < b.used.tv_nsec;
+            });
+
+    // Entries whose lock is held are being refreshed, so they are spared
+    for (auto&& entry : entries) {
+        if (total <= limit) {
+            break;
+        }
+
+        auto path = directory + "/" + entry.name;
+        auto lock = tryLockEntry(path + ".lock");
+        if (lock >= 0) {
+            if (::unlink(path.c_str()) == 0) {
+                total -= entry.size;
+            }
+
+            unlockEntry(path + ".lock", lock);
+        }
+    }
+}
+
+}
+
+namespace rshell {
+
+CacheBuiltinCommand::~CacheBuiltinCommand() = default;
+
+int CacheBuiltinCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    // Results are replayed through the standard output of the process
+    // executing the command, so should the context replace it, the command
+    // executes in a subshell where it is in place.  An executor without
+    // subshells executes it here regardless
+    if (context.stream(STDOUT_FILENO) != nullptr && !isInSubshell) {
+        isInSubshell = true;
+        try {
+            auto exitCode = executor.executeSubshell(*this, context,
+                    waitMode);
+            isInSubshell = false;
+            return exitCode;
+        }
+        catch (...) {
+            isInSubshell = false;
+            throw;
+        }
+    }
+
+    // Hash the declared inputs in the order given, each option followed by
+    // its value
+    utility::sha256 key;
+    hashField(key, trailerMagic);
+    char* directory = ::getcwd(nullptr, 0);
+    hashField(key, directory != nullptr ? directory : "");
+    std::free(directory);
+
+    std::size_t index = 0;
+    for (; index < arguments.size(); index += 2) {
+        auto& option = arguments[index];
+        if (option == "--") {
+            ++index;
+            break;
+        }
+
+        if (option != "-i" && option != "-m" && option != "-e") {
+            break;
+        }
+
+        if (index + 1 == arguments.size()) {
+            std::cerr << "rshell: cache: " << option << ": value expected\n";
+            return 1;
+        }
+
+        auto& value = arguments[index + 1];
+        std::string input;
+        if (option == "-i") {
+            input = hashContents(value);
+        }
+        else if (option == "-m") {
+            input = describeFile(value);
+        }
+        else if (context.variable(value, input)) {
+            input.insert(0, "=");
+        }
+
+        hashField(key, option);
+        hashField(key, value);
+        hashField(key, input);
+    }
+
+    if (index == arguments.size()) {
+        std::cerr << "rshell: cache: usage: cache [-i path] [-m path] "
+            "[-e name] program [argument...]\n";
+        return 1;
+    }
+
+    auto command = Parser::createExecutableCommand(arguments[index]);
+    command->program = arguments[index];
+    command->arguments.assign(std::begin(arguments) + index + 1,
+            std::end(arguments));
+    for (auto argument = std::begin(arguments) + index;
+            argument != std::end(arguments); ++argument) {
+        hashField(key, *argument);
+    }
+
+    auto run = [&](const ExecutionContext& context)
+    {
+        return command->isExternal() ?
+            command->execute(executor, context, WaitMode::Wait) :
+            executor.executeSubshell(*command, context, WaitMode::Wait);
+    };
+
+    // A store that cannot be used leaves the command uncached
+    auto store = executor.cacheDirectory().empty() ? defaultDirectory() :
+        executor.cacheDirectory();
+    if (!createDirectories(store)) {
+        std::perror(("rshell: cache: " + store).c_str());
+        return run(context);
+    }
+
+    // Replay the entry if it exists.  Otherwise, take its lock and check
+    // again, as another invocation may have stored it meanwhile
+    auto entry = store + "/" + key.hex_digest();
+    int exitCode;
+    if (replay(entry, exitCode)) {
+        return exitCode;
+    }
+
+    auto lock = lockEntry(entry + ".lock");
+    if (lock < 0) {
+        std::perror(("rshell: cache: " + store).c_str());
+        return run(context);
+    }
+
+    if (replay(entry, exitCode)) {
+        unlockEntry(entry + ".lock", lock);
+        return exitCode;
+    }
+
+    // Capture the standard output of the command in a file which becomes
+    // the entry once its trailer is appended
+    auto captured = entry + ".tmp";
+    try {
+        exitCode = run(context.withStream(STDOUT_FILENO,
+                    executor.createOutputFileStream(captured)));
+    }
+    catch (...) {
+        ::unlink(captured.c_str());
+        unlockEntry(entry + ".lock", lock);
+        throw;
+    }
+
+    auto file = ::open(captured.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+    struct stat status;
+    if (file < 0 || ::fstat(file, &status) < 0) {
+        if (file >= 0) {
+            ::close(file);
+        }
+
+        ::unlink(captured.c_str());
+        unlockEntry(entry + ".lock", lock);
+        return exitCode;
+    }
+
+    auto isStored = false;
+    if (exitCode >= 0 && exitCode < ExecutorJob::timeoutExitCode) {
+        Trailer trailer;
+        std::memcpy(trailer.magic, trailerMagic, sizeof(trailerMagic));
+        trailer.exitCode = exitCode;
+        isStored = ::write(file, &trailer, sizeof(trailer)) ==
+            static_cast<ssize_t>(sizeof(trailer)) &&
+            ::rename(captured.c_str(), entry.c_str()) == 0;
+    }
+
+    if (!isStored) {
+        ::unlink(captured.c_str());
+    }
+
+    unlockEntry(entry + ".lock", lock);
+    copyOutput(file, status.st_size);
+    ::close(file);
+
+    if (isStored) {
+        evict(store, executor.cacheLimit());
+    }
+
+    return exitCode;
+}
+
+void CacheBuiltinCommand::prepare(Executor& executor)
+{
+    // Builtins execute within the shell and require no preparation
+}
+
+bool CacheBuiltinCommand::isExternal() const
+{
+    return false;
+}
+
+} // namespace rshell
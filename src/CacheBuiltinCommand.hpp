@@ -0,0 +1,76 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::CacheBuiltinCommand
+/// class
+
+#ifndef hpp_rshell_CacheBuiltinCommand
+#define hpp_rshell_CacheBuiltinCommand
+
+#include "ExecutableCommand.hpp"
+
+namespace rshell {
+
+/// \brief Represents an invocation of the cache builtin command
+///
+/// The cache command executes a deterministic command once and replays its
+/// standard output and exit code from an on-disk store thereafter, as in
+/// "cache -i input.txt generate input.txt".  Results are keyed by the
+/// SHA-256 hash of the working directory, the program and its arguments,
+/// and the declared inputs; standard input is not part of the key.
+/// Concurrent invocations with one key, whether by threads or processes,
+/// are coalesced under a lock on the entry, so the command executes once
+/// and the others replay its result.  Results with exit codes of
+/// \ref ExecutorJob::timeoutExitCode and above, which report how the
+/// command was stopped rather than its result, are not kept.  Once a result
+/// is stored, the least recently used results beyond the budget of the
+/// store are evicted.
+///
+/// The options, each of which may be given any number of times, are as
+/// follows:
+///
+/// - -i path: a file whose contents are an input of the command
+/// - -m path: a file whose modification time and size are an input
+/// - -e name: an environment variable whose value is an input
+class CacheBuiltinCommand : public ExecutableCommand
+{
+public:
+    /// \brief Destructs the \ref CacheBuiltinCommand instance
+    virtual ~CacheBuiltinCommand();
+
+    /// \brief Executes the command using the given executor
+    /// \param executor executor to use for execution
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the cached command
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Prepares the command for repeated execution using the given
+    /// executor
+    /// \param executor executor to prepare with
+    virtual void prepare(Executor& executor) override;
+
+    /// \brief Gets a value indicating whether or not the command only starts
+    /// an external program
+    /// \return \c false, as builtins execute within the shell
+    virtual bool isExternal() const override;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_CacheBuiltinCommand
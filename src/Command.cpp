@@ -20,4 +20,19 @@ namespace rshell {
 
 Command::~Command() = default;
 
+int Command::executeRedirected(Executor& executor, const ExecutionContext&,
+        const ExecutionContext& redirected, WaitMode waitMode)
+{
+    return execute(executor, redirected, waitMode);
+}
+
+void Command::prepare(Executor& executor)
+{
+}
+
+bool Command::isExternal() const
+{
+    return false;
+}
+
 } // namespace rshell
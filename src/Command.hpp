@@ -25,6 +25,7 @@
 namespace rshell {
 
 // Forward declarations
+class ExecutionContext;
 class Executor;
 
 /// \brief Serves as the abstract base class in the composite pattern of the
@@ -37,9 +38,40 @@ public:
 
     /// \brief Executes the command using the given executor
     /// \param executor executor to use for execution
+    /// \param context context to execute the command within
     /// \param waitMode wait mode to use when executing
     /// \return exit code of the command
-    virtual int execute(Executor& executor, WaitMode waitMode) = 0;
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) = 0;
+
+    /// \brief Executes the command using the given executor, with the
+    /// redirections written after it already applied
+    /// \param executor executor to use for execution
+    /// \param context context preceding the redirections
+    /// \param redirected context with the redirections applied
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the command
+    ///
+    /// The default implementation executes the command within the
+    /// redirected context.
+    virtual int executeRedirected(Executor& executor,
+            const ExecutionContext& context,
+            const ExecutionContext& redirected, WaitMode waitMode);
+
+    /// \brief Prepares the command for repeated execution using the given
+    /// executor
+    /// \param executor executor to prepare with
+    ///
+    /// The default implementation does nothing.
+    virtual void prepare(Executor& executor);
+
+    /// \brief Gets a value indicating whether or not the command only starts
+    /// an external program, so that executing it in continue mode never
+    /// blocks the shell
+    /// \return whether or not the command is external
+    ///
+    /// The default implementation returns \c false.
+    virtual bool isExternal() const;
 };
 
 } // namespace rshell
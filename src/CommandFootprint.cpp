@@ -0,0 +1,337 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "CommandFootprint.hpp"
+#include "AppendRedirectionCommand.hpp"
+#include "ConjunctiveCommand.hpp"
+#include "CoprocBuiltinCommand.hpp"
+#include "DisjunctiveCommand.hpp"
+#include "ExecutableCommand.hpp"
+#include "ExecBuiltinCommand.hpp"
+#include "ExitBuiltinCommand.hpp"
+#include "FanInCommand.hpp"
+#include "FanOutCommand.hpp"
+#include "InputRedirectionCommand.hpp"
+#include "OutputRedirectionCommand.hpp"
+#include "PipeStatusBuiltinCommand.hpp"
+#include "PipeCommand.hpp"
+#include "ProcessSubstitutionCommand.hpp"
+#include "RaceCommand.hpp"
+#include "RedirectionCommand.hpp"
+#include "SequentialCommand.hpp"
+#include "SetBuiltinCommand.hpp"
+#include "TestBuiltinCommand.hpp"
+#include "UsesBuiltinCommand.hpp"
+#include <sstream>
+#include <vector>
+
+namespace {
+
+/// \brief Normalizes a path lexically so that equivalent spellings of the
+/// same relative or absolute path compare equal
+/// \param path path to normalize
+/// \return normalized path
+///
+/// Empty and "." components are removed, as are ".." components that
+/// follow a named component.  Symbolic links are not resolved.
+std::string normalize(const std::string& path)
+{
+    std::vector<std::string> components;
+    std::istringstream is{path};
+    std::string component;
+    while (std::getline(is, component, '/')) {
+        if (component.empty() || component == ".") {
+            continue;
+        }
+
+        if (component == ".." && !components.empty() &&
+                components.back() != "..") {
+            components.pop_back();
+            continue;
+        }
+
+        components.push_back(component);
+    }
+
+    std::string result = !path.empty() && path.front() == '/' ? "/" : "";
+    for (auto&& component : components) {
+        if (!result.empty() && result.back() != '/') {
+            result += '/';
+        }
+
+        result += component;
+    }
+
+    return result.empty() ? "." : result;
+}
+
+/// \brief Determines whether or not a redirection path addresses a
+/// coprocess rather than a file
+/// \param path path of the redirection
+/// \return whether or not the path addresses a coprocess
+bool addressesCoprocess(const std::string& path)
+{
+    return !path.empty() && path[0] == '%';
+}
+
+/// \brief Determines whether or not two sets of paths have a common member
+/// \param a first set of paths
+/// \param b second set of paths
+/// \return whether or not the sets intersect
+bool intersects(const std::set<std::string>& a,
+        const std::set<std::string>& b)
+{
+    auto i = std::begin(a);
+    auto j = std::begin(b);
+    while (i != std::end(a) && j != std::end(b)) {
+        if (*i < *j) {
+            ++i;
+        }
+        else if (*j < *i) {
+            ++j;
+        }
+        else {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}
+
+namespace rshell {
+
+CommandFootprint CommandFootprint::analyze(const Command& command)
+{
+    CommandFootprint footprint;
+    footprint.collect(command);
+    return footprint;
+}
+
+bool CommandFootprint::conflictsWith(const CommandFootprint& other) const
+{
+    // Barriers conflict with everything.  Otherwise, two commands conflict
+    // when either writes a path that the other reads or writes
+    return _isBarrier || other._isBarrier
+        || intersects(_writes, other._writes)
+        || intersects(_writes, other._reads)
+        || intersects(_reads, other._writes);
+}
+
+void CommandFootprint::addRead(const std::string& path)
+{
+    _reads.insert(normalize(path));
+}
+
+void CommandFootprint::addWrite(const std::string& path)
+{
+    _writes.insert(normalize(path));
+}
+
+void CommandFootprint::setBarrier()
+{
+    _isBarrier = true;
+}
+
+void CommandFootprint::merge(const CommandFootprint& other)
+{
+    _reads.insert(std::begin(other._reads), std::end(other._reads));
+    _writes.insert(std::begin(other._writes), std::end(other._writes));
+    _isBarrier = _isBarrier || other._isBarrier;
+}
+
+void CommandFootprint::collect(const Command& command)
+{
+    // Builtins that alter or report the state of the shell must run within
+    // it, in sequence
+    if (dynamic_cast<const CoprocBuiltinCommand*>(&command) != nullptr ||
+            dynamic_cast<const ExecBuiltinCommand*>(&command) != nullptr ||
+            dynamic_cast<const ExitBuiltinCommand*>(&command) != nullptr ||
+            dynamic_cast<const SetBuiltinCommand*>(&command) != nullptr ||
+            dynamic_cast<const PipeStatusBuiltinCommand*>(&command) !=
+                nullptr) {
+        setBarrier();
+        return;
+    }
+
+    // The test builtin reads every path it is given
+    if (auto test = dynamic_cast<const TestBuiltinCommand*>(&command)) {
+        for (auto&& arg : test->arguments) {
+            if (arg != "-e" && arg != "-f" && arg != "-d" && arg != "]") {
+                addRead(arg);
+            }
+        }
+
+        return;
+    }
+
+    // The uses builtin declares the footprint of its command explicitly
+    if (auto uses = dynamic_cast<const UsesBuiltinCommand*>(&command)) {
+        auto annotation = uses->annotation();
+        for (auto&& path : annotation.reads) {
+            addRead(path);
+        }
+
+        for (auto&& path : annotation.writes) {
+            addWrite(path);
+        }
+
+        return;
+    }
+
+    // Any other program may read or write whatever its arguments name.  As
+    // there is no telling which arguments are paths, each is taken as both
+    // read and written, with an option contributing the value it assigns
+    if (auto executable =
+            dynamic_cast<const ExecutableCommand*>(&command)) {
+        for (auto&& arg : executable->arguments) {
+            auto value = arg;
+            if (!arg.empty() && arg[0] == '-') {
+                auto assignment = arg.find('=');
+                if (assignment == std::string::npos) {
+                    continue;
+                }
+
+                value = arg.substr(assignment + 1);
+            }
+
+            if (!value.empty()) {
+                addRead(value);
+                addWrite(value);
+            }
+        }
+
+        return;
+    }
+
+    // Redirections contribute their paths, then the footprint of their
+    // primary command.  A coprocess is both read and written by every
+    // redirection addressing it, as its requests and replies interleave
+    if (auto input = dynamic_cast<const InputRedirectionCommand*>(&command)) {
+        addRead(input->path);
+        if (addressesCoprocess(input->path)) {
+            addWrite(input->path);
+        }
+
+        if (input->primary != nullptr) {
+            collect(*input->primary);
+        }
+
+        return;
+    }
+
+    if (auto output =
+            dynamic_cast<const OutputRedirectionCommand*>(&command)) {
+        addWrite(output->path);
+        if (addressesCoprocess(output->path)) {
+            addRead(output->path);
+        }
+
+        if (output->primary != nullptr) {
+            collect(*output->primary);
+        }
+
+        return;
+    }
+
+    if (auto append =
+            dynamic_cast<const AppendRedirectionCommand*>(&command)) {
+        addWrite(append->path);
+        if (addressesCoprocess(append->path)) {
+            addRead(append->path);
+        }
+
+        if (append->primary != nullptr) {
+            collect(*append->primary);
+        }
+
+        return;
+    }
+
+    // Process substitutions contribute the footprints of both commands
+    if (auto substitution =
+            dynamic_cast<const ProcessSubstitutionCommand*>(&command)) {
+        if (substitution->primary != nullptr) {
+            collect(*substitution->primary);
+        }
+
+        if (substitution->command != nullptr) {
+            collect(*substitution->command);
+        }
+
+        return;
+    }
+
+    if (auto redirection =
+            dynamic_cast<const RedirectionCommand*>(&command)) {
+        if (redirection->primary != nullptr) {
+            collect(*redirection->primary);
+        }
+
+        return;
+    }
+
+    // Compositions contribute the footprints of all of their commands
+    if (auto sequential = dynamic_cast<const SequentialCommand*>(&command)) {
+        for (auto&& child : sequential->sequence) {
+            if (child != nullptr) {
+                collect(*child);
+            }
+        }
+
+        return;
+    }
+
+    const Command* primary = nullptr;
+    const Command* secondary = nullptr;
+    if (auto conjunctive =
+            dynamic_cast<const ConjunctiveCommand*>(&command)) {
+        primary = conjunctive->primary.get();
+        secondary = conjunctive->secondary.get();
+    }
+    else if (auto disjunctive =
+            dynamic_cast<const DisjunctiveCommand*>(&command)) {
+        primary = disjunctive->primary.get();
+        secondary = disjunctive->secondary.get();
+    }
+    else if (auto race = dynamic_cast<const RaceCommand*>(&command)) {
+        primary = race->primary.get();
+        secondary = race->secondary.get();
+    }
+    else if (auto pipe = dynamic_cast<const PipeCommand*>(&command)) {
+        primary = pipe->primary.get();
+        secondary = pipe->secondary.get();
+    }
+    else if (auto fanOut = dynamic_cast<const FanOutCommand*>(&command)) {
+        primary = fanOut->primary.get();
+        secondary = fanOut->secondary.get();
+    }
+    else if (auto fanIn = dynamic_cast<const FanInCommand*>(&command)) {
+        primary = fanIn->primary.get();
+        secondary = fanIn->secondary.get();
+    }
+
+    if (primary != nullptr) {
+        collect(*primary);
+    }
+
+    if (secondary != nullptr) {
+        collect(*secondary);
+    }
+}
+
+} // namespace rshell
@@ -0,0 +1,94 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::CommandFootprint class
+
+#ifndef hpp_rshell_CommandFootprint
+#define hpp_rshell_CommandFootprint
+
+#include <set>
+#include <string>
+
+namespace rshell {
+
+// Forward declarations
+class Command;
+
+/// \brief Describes the file system paths a command reads and writes
+///
+/// Footprints are derived from the redirections within a command, from the
+/// annotations given to the uses builtin, and from the arguments of other
+/// programs, each of which is conservatively taken as a path both read and
+/// written.  A program that reaches paths its arguments do not name, such
+/// as through a script, is to be annotated with the uses builtin.
+class CommandFootprint
+{
+public:
+    /// \brief Analyzes the given command to determine its footprint
+    /// \param command command to analyze
+    /// \return footprint of the command
+    static CommandFootprint analyze(const Command& command);
+
+    /// \brief Gets a reference to the set of paths read by the command
+    /// \return reference to the set of read paths
+    const std::set<std::string>& reads() const noexcept { return _reads; }
+
+    /// \brief Gets a reference to the set of paths written by the command
+    /// \return reference to the set of written paths
+    const std::set<std::string>& writes() const noexcept { return _writes; }
+
+    /// \brief Gets a value indicating whether or not the command affects the
+    /// state of the shell itself
+    /// \return whether or not the command is a barrier
+    ///
+    /// Barrier commands must execute within the shell after all previous
+    /// commands have finished and before any following command starts.
+    bool isBarrier() const noexcept { return _isBarrier; }
+
+    /// \brief Determines whether or not the command conflicts with another
+    /// \param other footprint of the other command
+    /// \return whether or not the commands must execute in order
+    bool conflictsWith(const CommandFootprint& other) const;
+
+    /// \brief Adds a path to the set of read paths
+    /// \param path path read by the command
+    void addRead(const std::string& path);
+
+    /// \brief Adds a path to the set of written paths
+    /// \param path path written by the command
+    void addWrite(const std::string& path);
+
+    /// \brief Marks the command as a barrier
+    void setBarrier();
+
+    /// \brief Merges the footprint of another command into this one
+    /// \param other footprint to merge
+    void merge(const CommandFootprint& other);
+
+private:
+    std::set<std::string> _reads; //!< Paths read by the command
+    std::set<std::string> _writes; //!< Paths written by the command
+    bool _isBarrier{false}; //!< Whether or not the command is a barrier
+
+    /// \brief Analyzes the given command, merging its footprint into this one
+    /// \param command command to analyze
+    void collect(const Command& command);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_CommandFootprint
@@ -0,0 +1,214 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "CompiledCommand.hpp"
+#include "ExecutorJob.hpp"
+#include "ExitException.hpp"
+#include "Parser.hpp"
+#include "PosixExecutor.hpp"
+#include "Tokenizer.hpp"
+#include "utility/make_unique.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using utility::make_unique;
+
+namespace {
+
+/// \brief Waits for a process to exit, up to a timeout
+/// \param pid process to wait for
+/// \param status status of the process, if it exited
+/// \param timeout time to wait for
+/// \return whether or not the process exited within the timeout
+bool waitFor(pid_t pid, int& status, std::chrono::milliseconds timeout)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+
+#ifdef SYS_pidfd_open
+    // A process descriptor becomes readable when the process exits, which
+    // allows waiting with a timeout and no polling interval
+    auto file = static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+    if (file >= 0) {
+        while (true) {
+            auto remaining = std::chrono::duration_cast<
+                std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now());
+            pollfd entry{file, POLLIN, 0};
+            auto count = ::poll(&entry, 1, static_cast<int>(
+                        std::max<long long>(remaining.count(), 0)));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            ::close(file);
+            return count > 0 && waitpid(pid, &status, 0) == pid;
+        }
+    }
+#endif
+
+    // Without process descriptors, poll the process with a short interval
+    while (std::chrono::steady_clock::now() < deadline) {
+        auto result = waitpid(pid, &status, WNOHANG);
+        if (result == pid) {
+            return true;
+        }
+        else if (result < 0 && errno != EINTR) {
+            return false;
+        }
+
+        ::usleep(1000);
+    }
+
+    return false;
+}
+
+}
+
+namespace rshell {
+
+constexpr int CompiledCommand::timeoutExitCode;
+
+CompiledCommand::CompiledCommand(const std::string& text)
+    : _text{text}
+    , _executor{make_unique<PosixExecutor>()}
+{
+    std::istringstream is{text};
+    Tokenizer tokenizer{is};
+    tokenizer.apply();
+    if (!tokenizer.isValid()) {
+        throw std::runtime_error{"incomplete command"};
+    }
+
+    _command = Parser{tokenizer.tokens()}.apply();
+    if (_command != nullptr) {
+        _command->prepare(*_executor);
+    }
+}
+
+CompiledCommand::~CompiledCommand() = default;
+
+int CompiledCommand::execute(const Options& options)
+{
+    // A replaced environment is carried by the context, in which programs
+    // are located along its own PATH rather than the prepared locations.
+    // Building it here keeps that allocation out of the subshell.
+    ExecutionContext context;
+    if (options.replacesEnvironment) {
+        context = context.withEnvironment(options.environment);
+    }
+
+    // Flush the standard streams so that their buffered contents are not
+    // duplicated into the subshell
+    std::cout.flush();
+    std::cerr.flush();
+
+    auto pid = fork();
+    if (pid == 0) {
+        work(options, context);
+    }
+    else if (pid < 0) {
+        std::perror("rshell: fork failed");
+        throw std::runtime_error{"unable to fork"};
+    }
+
+    // Place the subshell in its own process group from both sides, so that
+    // the group exists however the two processes are scheduled
+    ::setpgid(pid, pid);
+
+    int status;
+    if (options.timeout.count() > 0) {
+        if (!waitFor(pid, status, options.timeout)) {
+            // Give the group a chance to exit cleanly before killing it,
+            // then sweep whatever of it outlived the subshell
+            ::kill(-pid, SIGTERM);
+            if (!waitFor(pid, status, ExecutorJob::terminationGrace)) {
+                ::kill(-pid, SIGKILL);
+                waitpid(pid, &status, 0);
+            }
+
+            ::kill(-pid, SIGKILL);
+            return timeoutExitCode;
+        }
+    }
+    else if (waitpid(pid, &status, 0) < 0) {
+        std::perror("rshell: wait failed");
+        throw std::runtime_error{"error while waiting"};
+    }
+
+    if (WIFEXITED(status)) {
+        return WEXITSTATUS(status);
+    }
+
+    return 128 + WTERMSIG(status);
+}
+
+int CompiledCommand::execute()
+{
+    return execute(Options{});
+}
+
+void CompiledCommand::work(const Options& options,
+        const ExecutionContext& context)
+{
+    ::setpgid(0, 0);
+
+    // Move the descriptors out of the way before placing them, so that
+    // descriptors given in any order are placed correctly
+    int files[] = {
+        ::fcntl(options.input, F_DUPFD_CLOEXEC, 3),
+        ::fcntl(options.output, F_DUPFD_CLOEXEC, 3),
+        ::fcntl(options.error, F_DUPFD_CLOEXEC, 3),
+    };
+    for (auto slot = 0; slot < 3; ++slot) {
+        if (files[slot] < 0 || ::dup2(files[slot], slot) < 0) {
+            std::perror("rshell: unable to set up standard streams");
+            _exit(1);
+        }
+
+        ::close(files[slot]);
+    }
+
+    auto exitCode = 0;
+    try {
+        if (_command != nullptr) {
+            exitCode = _executor->execute(*_command, context);
+        }
+    }
+    catch (const ExitException& e) {
+        exitCode = e.exitCode();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "rshell: error: " << e.what() << '\n';
+        exitCode = 1;
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+    _exit(exitCode);
+}
+
+} // namespace rshell
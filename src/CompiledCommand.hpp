@@ -0,0 +1,119 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::CompiledCommand class
+
+#ifndef hpp_rshell_CompiledCommand
+#define hpp_rshell_CompiledCommand
+
+#include "Command.hpp"
+#include "ExecutionContext.hpp"
+#include "Executor.hpp"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rshell {
+
+/// \brief Command string compiled once for repeated execution by an
+/// embedding program
+///
+/// Compiling tokenizes, parses, and prepares the command string, so that
+/// each execution only forks a subshell and executes the parsed command in
+/// it.  The subshell receives the descriptors, environment, and timeout
+/// given for that execution, leaving the state of the calling process
+/// untouched.
+///
+/// The subshell is a fork of the calling process that goes on to run the
+/// executor, which allocates, uses iostreams, and may throw before it
+/// executes any program.  Only the calling thread survives the fork, so a
+/// multithreaded embedding program must not execute a compiled command
+/// while another of its threads may hold a lock that those facilities
+/// need, such as one of its own locks taken around allocation or output.
+class CompiledCommand
+{
+public:
+    /// \brief Options for a single execution of a compiled command
+    struct Options
+    {
+        int input{0}; //!< Descriptor to use as the standard input
+        int output{1}; //!< Descriptor to use as the standard output
+        int error{2}; //!< Descriptor to use as the standard error
+
+        /// \brief Whether or not to replace the environment of the subshell
+        /// with \ref environment
+        bool replacesEnvironment{false};
+
+        /// \brief Environment of the subshell as "name=value" entries
+        std::vector<std::string> environment;
+
+        /// \brief Time after which the execution is terminated, or zero for
+        /// no limit
+        std::chrono::milliseconds timeout{0};
+    };
+
+    /// \brief Exit code reported when an execution exceeds its timeout
+    static constexpr int timeoutExitCode = 124;
+
+    /// \brief Constructs a new instance of the \ref CompiledCommand class
+    /// from a command string
+    /// \param text command string to compile
+    /// \throw std::runtime_error if the command string is not well-formed
+    explicit CompiledCommand(const std::string& text);
+
+    /// \brief Destructs the \ref CompiledCommand instance
+    ~CompiledCommand();
+
+    CompiledCommand(const CompiledCommand&) = delete;
+    CompiledCommand& operator=(const CompiledCommand&) = delete;
+
+    /// \brief Gets the command string the command was compiled from
+    /// \return command string
+    const std::string& text() const noexcept { return _text; }
+
+    /// \brief Executes the command in a subshell
+    /// \param options options for the execution
+    /// \return exit code of the command, or \ref timeoutExitCode if the
+    /// execution exceeded its timeout
+    /// \throw std::runtime_error if the subshell could not be created
+    ///
+    /// The subshell leads its own process group, which is terminated as a
+    /// whole when the timeout expires and killed if any of it remains after
+    /// \ref ExecutorJob::terminationGrace.
+    int execute(const Options& options);
+
+    /// \brief Executes the command in a subshell with the standard streams
+    /// of the calling process and no timeout
+    /// \return exit code of the command
+    int execute();
+
+private:
+    std::string _text; //!< Command string the command was compiled from
+    std::unique_ptr<Executor> _executor; //!< Executor for the command
+    std::unique_ptr<Command> _command; //!< Parsed command, if not empty
+
+    /// \brief Executes the command within the forked subshell
+    /// \param options options for the execution
+    /// \param context context to execute the command in
+    [[noreturn]] void work(const Options& options,
+            const ExecutionContext& context);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_CompiledCommand
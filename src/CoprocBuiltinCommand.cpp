@@ -0,0 +1,131 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "CoprocBuiltinCommand.hpp"
+#include "Executor.hpp"
+#include "Parser.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+/// \brief Determines whether a coprocess name may be addressed by a
+/// redirection
+/// \param name name to check
+/// \return whether or not the name is valid
+bool isValidName(const std::string& name)
+{
+    return !name.empty() && std::all_of(std::begin(name), std::end(name),
+            [](char c)
+            {
+                return std::isalnum(static_cast<unsigned char>(c)) ||
+                    c == '_' || c == '-';
+            });
+}
+
+/// \brief Whether or not the calling thread is executing the command in a
+/// subshell of its own
+thread_local bool isInSubshell = false;
+
+}
+
+namespace rshell {
+
+CoprocBuiltinCommand::~CoprocBuiltinCommand() = default;
+
+int CoprocBuiltinCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    if (arguments.empty()) {
+        // The listing is written to the standard output of the process
+        // executing the command, so should the context replace it, the
+        // command executes in a subshell where it is in place
+        if (context.stream(STDOUT_FILENO) != nullptr && !isInSubshell) {
+            isInSubshell = true;
+            try {
+                auto exitCode = executor.executeSubshell(*this, context,
+                        waitMode);
+                isInSubshell = false;
+                return exitCode;
+            }
+            catch (...) {
+                isInSubshell = false;
+                throw;
+            }
+        }
+
+        for (auto&& name : executor.coprocessNames()) {
+            std::cout << name << '\n';
+        }
+
+        std::cout.flush();
+        return 0;
+    }
+
+    if (arguments[0] == "-c") {
+        if (arguments.size() != 2) {
+            std::cerr << "rshell: coproc: usage: coproc -c name\n";
+            return 1;
+        }
+
+        JobStatus status;
+        if (!executor.closeCoprocess(arguments[1], status)) {
+            std::cerr << "rshell: coproc: " << arguments[1]
+                << ": no such coprocess\n";
+            return 1;
+        }
+
+        return status.exitCode;
+    }
+
+    if (arguments.size() < 2) {
+        std::cerr << "rshell: coproc: usage: coproc name program "
+            "[argument...]\n";
+        return 1;
+    }
+
+    if (!isValidName(arguments[0])) {
+        std::cerr << "rshell: coproc: " << arguments[0]
+            << ": invalid name\n";
+        return 1;
+    }
+
+    auto command = Parser::createExecutableCommand(arguments[1]);
+    command->program = arguments[1];
+    command->arguments.assign(std::begin(arguments) + 2,
+            std::end(arguments));
+
+    // Flush the standard output so that its buffered contents are not
+    // duplicated into a coprocess executing in a subshell
+    std::cout.flush();
+    if (!executor.startCoprocess(arguments[0], *command, context)) {
+        std::cerr << "rshell: coproc: " << arguments[0]
+            << ": already running\n";
+        return 1;
+    }
+
+    return 0;
+}
+
+bool CoprocBuiltinCommand::isExternal() const
+{
+    return false;
+}
+
+} // namespace rshell
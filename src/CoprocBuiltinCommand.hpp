@@ -0,0 +1,60 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::CoprocBuiltinCommand
+/// class
+
+#ifndef hpp_rshell_CoprocBuiltinCommand
+#define hpp_rshell_CoprocBuiltinCommand
+
+#include "ExecutableCommand.hpp"
+
+namespace rshell {
+
+/// \brief Represents an invocation of the coproc builtin command
+///
+/// The coproc command starts a long-lived program as a coprocess, as in
+/// "coproc name program argument...", with pipes to its standard input and
+/// from its standard output that remain open across commands.  Later
+/// redirections address the coprocess as "%name": an output redirection
+/// writes to its input and an input redirection reads from its output, so
+/// that many requests pass through one process.  "coproc -c name" closes
+/// the input of the coprocess and waits for it, exiting with its exit code,
+/// and "coproc" alone lists the running coprocesses.
+class CoprocBuiltinCommand : public ExecutableCommand
+{
+public:
+    /// \brief Destructs the \ref CoprocBuiltinCommand instance
+    virtual ~CoprocBuiltinCommand();
+
+    /// \brief Executes the command using the given executor
+    /// \param executor executor to use for execution
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return zero once started, or the exit code of a closed coprocess
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Gets a value indicating whether or not the command only starts
+    /// an external program
+    /// \return \c false, as builtins execute within the shell
+    virtual bool isExternal() const override;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_CoprocBuiltinCommand
@@ -0,0 +1,296 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "Daemon.hpp"
+#include "DaemonConnection.hpp"
+#include "ExitException.hpp"
+#include "Parser.hpp"
+#include "Tokenizer.hpp"
+#include "utility/make_unique.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using utility::make_unique;
+
+namespace {
+
+/// \brief Closes every file descriptor in a sequence
+/// \param files file descriptors to close
+void closeAll(const std::vector<int>& files)
+{
+    for (auto file : files) {
+        ::close(file);
+    }
+}
+
+/// \brief Writes an error message to the client's standard error
+/// \param file client standard error descriptor
+/// \param message error message to write
+void report(int file, const std::string& message)
+{
+    auto text = "rshell: error: " + message + '\n';
+    if (::write(file, text.data(), text.size()) < 0) {
+        // Nothing more can be done if the client's stream is unusable
+    }
+}
+
+}
+
+namespace rshell {
+
+constexpr std::size_t Daemon::cacheCapacity;
+constexpr std::chrono::seconds Daemon::requestTimeout;
+
+Daemon::Daemon(Executor& executor)
+    : _executor(executor)
+{
+}
+
+int Daemon::serve(const std::string& path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof address.sun_path) {
+        std::cerr << "rshell: error: socket path is too long\n";
+        return 1;
+    }
+
+    std::strcpy(address.sun_path, path.c_str());
+
+    auto listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listener < 0) {
+        std::perror("rshell: unable to create socket");
+        return 1;
+    }
+
+    auto bound = ::bind(listener, reinterpret_cast<sockaddr*>(&address),
+            sizeof address) == 0;
+    if (!bound && errno == EADDRINUSE) {
+        // A socket that refuses connections was left by a daemon that is no
+        // longer running and may be replaced
+        auto socket = DaemonConnection::connect(path);
+        if (socket >= 0) {
+            ::close(socket);
+            ::close(listener);
+            std::cerr << "rshell: error: a daemon is already serving "
+                << path << '\n';
+            return 1;
+        }
+
+        ::unlink(path.c_str());
+        bound = ::bind(listener, reinterpret_cast<sockaddr*>(&address),
+                sizeof address) == 0;
+    }
+
+    if (!bound || ::listen(listener, SOMAXCONN) != 0) {
+        std::perror("rshell: unable to listen on socket");
+        ::close(listener);
+        return 1;
+    }
+
+    while (true) {
+        // Reap finished request handlers without blocking
+        while (::waitpid(-1, nullptr, WNOHANG) > 0) {
+        }
+
+        // Wait on the listener and on each connection whose request is yet
+        // to arrive, waking in time for the earliest deadline
+        std::vector<pollfd> entries{{listener, POLLIN, 0}};
+        auto timeout = std::chrono::milliseconds{1000};
+        auto now = std::chrono::steady_clock::now();
+        for (auto&& pending : _pending) {
+            entries.push_back({pending.connection->socket(), POLLIN, 0});
+            timeout = std::min(timeout, std::chrono::duration_cast<
+                    std::chrono::milliseconds>(pending.deadline - now));
+        }
+
+        auto count = ::poll(entries.data(), entries.size(),
+                static_cast<int>(std::max<long long>(timeout.count(), 0)));
+        if (count < 0 && errno != EINTR) {
+            std::perror("rshell: unable to poll socket");
+            break;
+        }
+
+        receive(listener, entries);
+        if (count > 0 && (entries[0].revents & POLLIN) != 0) {
+            admit(listener);
+        }
+    }
+
+    ::close(listener);
+    ::unlink(path.c_str());
+    return 1;
+}
+
+Command* Daemon::lookup(const std::string& text)
+{
+    auto cached = _commands.find(text);
+    if (cached != std::end(_commands)) {
+        return cached->second.get();
+    }
+
+    std::istringstream is{text};
+    Tokenizer tokenizer{is};
+    tokenizer.apply();
+    if (!tokenizer.isValid()) {
+        throw std::runtime_error{"incomplete command"};
+    }
+
+    auto command = Parser{tokenizer.tokens()}.apply();
+    if (command != nullptr) {
+        command->prepare(_executor);
+    }
+
+    // Bound the cache by starting over once it is full, which is adequate
+    // for services that submit a small working set of command strings
+    if (_commands.size() >= cacheCapacity) {
+        _commands.clear();
+    }
+
+    auto pointer = command.get();
+    _commands[text] = std::move(command);
+    return pointer;
+}
+
+void Daemon::admit(int listener)
+{
+    auto socket = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+    if (socket < 0) {
+        if (errno != EINTR && errno != ECONNABORTED) {
+            std::perror("rshell: unable to accept connection");
+        }
+
+        return;
+    }
+
+    // Submitted commands run with the privileges of the daemon, so only its
+    // own user may submit them
+    ucred credentials;
+    socklen_t size = sizeof credentials;
+    if (::getsockopt(socket, SOL_SOCKET, SO_PEERCRED, &credentials,
+                &size) != 0 || credentials.uid != ::getuid()) {
+        std::cerr << "rshell: refused connection from another user\n";
+        ::close(socket);
+        return;
+    }
+
+    Pending pending;
+    pending.connection = make_unique<DaemonConnection>(socket);
+    pending.deadline = std::chrono::steady_clock::now() + requestTimeout;
+    _pending.push_back(std::move(pending));
+}
+
+void Daemon::receive(int listener, const std::vector<pollfd>& entries)
+{
+    // The first entry is the listener, followed by the pending connections.
+    // Each is removed before being handled, so that the forked handler
+    // closes only the connections that remain pending
+    auto now = std::chrono::steady_clock::now();
+    for (auto i = _pending.size(); i-- > 0;) {
+        auto& pending = _pending[i];
+        auto state = entries[i + 1].revents != 0 ?
+            pending.connection->receiveRequest(pending.text, pending.files) :
+            RequestState::Partial;
+        if (state == RequestState::Partial && now < pending.deadline) {
+            continue;
+        }
+
+        auto request = std::move(pending);
+        _pending.erase(std::begin(_pending) + i);
+        if (state == RequestState::Complete) {
+            handle(listener, request);
+        }
+        else {
+            closeAll(request.files);
+        }
+    }
+}
+
+void Daemon::handle(int listener, Pending& request)
+{
+    auto& connection = *request.connection;
+    auto& files = request.files;
+
+    // Parse in the daemon itself so that the cache persists across requests
+    Command* command;
+    try {
+        command = lookup(request.text);
+    }
+    catch (const std::exception& e) {
+        report(files[2], e.what());
+        connection.sendStatus(1);
+        closeAll(files);
+        return;
+    }
+
+    auto pid = ::fork();
+    if (pid < 0) {
+        report(files[2], std::strerror(errno));
+        connection.sendStatus(1);
+    }
+    else if (pid == 0) {
+        ::close(listener);
+        for (auto&& pending : _pending) {
+            ::close(pending.connection->socket());
+            closeAll(pending.files);
+        }
+
+        // Adopt the client's working directory and standard streams
+        auto exitCode = 1;
+        if (::fchdir(files[3]) == 0 &&
+                ::dup2(files[0], STDIN_FILENO) >= 0 &&
+                ::dup2(files[1], STDOUT_FILENO) >= 0 &&
+                ::dup2(files[2], STDERR_FILENO) >= 0) {
+            closeAll(files);
+
+            try {
+                exitCode = command != nullptr
+                    ? _executor.execute(*command)
+                    : 0;
+            }
+            catch (const ExitException& e) {
+                exitCode = e.exitCode();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "rshell: error: " << e.what() << '\n';
+            }
+        }
+        else {
+            report(files[2], std::strerror(errno));
+        }
+
+        std::cout.flush();
+        std::cerr.flush();
+        connection.sendStatus(exitCode);
+        _exit(0);
+    }
+
+    closeAll(files);
+}
+
+} // namespace rshell
@@ -0,0 +1,116 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::Daemon class
+
+#ifndef hpp_rshell_Daemon
+#define hpp_rshell_Daemon
+
+#include "Command.hpp"
+#include "DaemonConnection.hpp"
+#include "Executor.hpp"
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <poll.h>
+
+namespace rshell {
+
+/// \brief Serves command strings submitted over a Unix domain socket with a
+/// single, persistent shell
+///
+/// The daemon keeps the parse of each distinct command string, prepared
+/// against the executor, so that repeated submissions skip tokenizing,
+/// parsing, and program lookup.  Each request executes in its own forked
+/// handler, allowing requests to execute concurrently, with the standard
+/// streams and working directory passed by the client.
+///
+/// Requests are received as they arrive from any number of clients at once,
+/// so a client that is slow to send its request delays no other.  Only
+/// clients running as the user of the daemon are served.
+class Daemon
+{
+public:
+    /// \brief Maximum number of parsed commands kept in the cache
+    static constexpr std::size_t cacheCapacity = 256;
+
+    /// \brief Time a client is given to send its whole request once
+    /// connected
+    static constexpr std::chrono::seconds requestTimeout{5};
+
+    /// \brief Constructs a new instance of the \ref Daemon class
+    /// \param executor executor with which to execute commands
+    explicit Daemon(Executor& executor);
+
+    /// \brief Listens on the given socket path and serves requests until the
+    /// daemon is terminated
+    /// \param path path of the socket to listen on
+    /// \return exit code of the daemon
+    ///
+    /// A stale socket left at the path by a previous daemon is replaced.
+    /// The method fails if another daemon is listening on the path.
+    int serve(const std::string& path);
+
+private:
+    /// \brief Connection whose request is being received
+    struct Pending
+    {
+        /// \brief Connection accepted from the client
+        std::unique_ptr<DaemonConnection> connection;
+
+        std::string text; //!< Command string received so far
+        std::vector<int> files; //!< Descriptors received with the request
+
+        /// \brief Time after which the connection is dropped
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    Executor& _executor; //!< Executor with which to execute commands
+    std::vector<Pending> _pending; //!< Connections awaiting their request
+
+    /// \brief Cache of parsed and prepared commands by command string
+    std::map<std::string, std::unique_ptr<Command>> _commands;
+
+    /// \brief Gets the parsed command for a command string, parsing and
+    /// preparing it if it is not cached
+    /// \param text command string
+    /// \return parsed command, or \c null if the command string is empty
+    Command* lookup(const std::string& text);
+
+    /// \brief Accepts a connection from a client of the same user
+    /// \param listener listening socket
+    void admit(int listener);
+
+    /// \brief Receives what has arrived of the pending requests, handling
+    /// those that are complete and dropping those that failed or whose
+    /// deadline has passed
+    /// \param listener listening socket, closed in the request handlers
+    /// \param entries poll results for the pending connections, in order
+    void receive(int listener, const std::vector<pollfd>& entries);
+
+    /// \brief Handles a received request
+    /// \param listener listening socket, closed in the request handler
+    /// \param request connection and request, whose descriptors are closed
+    void handle(int listener, Pending& request);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_Daemon
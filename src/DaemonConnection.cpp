@@ -0,0 +1,204 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "DaemonConnection.hpp"
+#include "utility/read_write_all.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using utility::read_all;
+using utility::write_all;
+
+namespace {
+
+/// \brief Upper bound on the length of a command string in a request
+constexpr std::uint32_t maxCommandLength = 1 << 20;
+
+}
+
+namespace rshell {
+
+constexpr std::size_t DaemonConnection::fileCount;
+
+DaemonConnection::DaemonConnection(int socket)
+    : _socket{socket}
+{
+}
+
+DaemonConnection::~DaemonConnection()
+{
+    if (_socket >= 0) {
+        ::close(_socket);
+    }
+}
+
+std::string DaemonConnection::defaultPath()
+{
+    auto path = std::getenv("RSHELL_SOCKET");
+    if (path != nullptr && *path != '\0') {
+        return path;
+    }
+
+    return "/tmp/rshell-" + std::to_string(::getuid()) + ".sock";
+}
+
+int DaemonConnection::connect(const std::string& path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof address.sun_path) {
+        return -1;
+    }
+
+    std::strcpy(address.sun_path, path.c_str());
+
+    auto socket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (socket < 0) {
+        return -1;
+    }
+
+    if (::connect(socket, reinterpret_cast<sockaddr*>(&address),
+                sizeof address) != 0) {
+        ::close(socket);
+        return -1;
+    }
+
+    return socket;
+}
+
+bool DaemonConnection::sendRequest(const std::string& command,
+        const std::vector<int>& files)
+{
+    if (command.size() > maxCommandLength || files.size() != fileCount) {
+        return false;
+    }
+
+    // The length of the command travels with the descriptors so that the
+    // daemon receives both in a single message
+    std::uint32_t length = command.size();
+    iovec vector{&length, sizeof length};
+
+    char control[CMSG_SPACE(fileCount * sizeof(int))] = {};
+    msghdr message{};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof control;
+
+    auto header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(fileCount * sizeof(int));
+    std::memcpy(CMSG_DATA(header), files.data(), fileCount * sizeof(int));
+
+    if (::sendmsg(_socket, &message, MSG_NOSIGNAL) !=
+            static_cast<ssize_t>(sizeof length)) {
+        return false;
+    }
+
+    return write_all(_socket, command.data(), command.size());
+}
+
+RequestState DaemonConnection::receiveRequest(std::string& command,
+        std::vector<int>& files)
+{
+    // The length of the command arrives with the descriptors, after which
+    // the command is read as far as it has arrived
+    if (!_hasHeader) {
+        std::uint32_t length = 0;
+        iovec vector{&length, sizeof length};
+
+        char control[CMSG_SPACE(fileCount * sizeof(int))] = {};
+        msghdr message{};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof control;
+
+        auto count = ::recvmsg(_socket, &message,
+                MSG_CMSG_CLOEXEC | MSG_DONTWAIT);
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK ||
+                    errno == EINTR)) {
+            return RequestState::Partial;
+        }
+
+        // Take ownership of any descriptors received, even if the request
+        // turns out to be malformed, so that the caller can close them
+        files.clear();
+        for (auto header = CMSG_FIRSTHDR(&message); header != nullptr;
+                header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level == SOL_SOCKET &&
+                    header->cmsg_type == SCM_RIGHTS) {
+                auto size = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                auto data = reinterpret_cast<const int*>(CMSG_DATA(header));
+                files.insert(std::end(files), data, data + size);
+            }
+        }
+
+        if (count != static_cast<ssize_t>(sizeof length) ||
+                (message.msg_flags & MSG_CTRUNC) != 0 ||
+                files.size() != fileCount || length > maxCommandLength) {
+            return RequestState::Failed;
+        }
+
+        _hasHeader = true;
+        _received = 0;
+        command.resize(length);
+    }
+
+    while (_received < command.size()) {
+        auto count = ::recv(_socket, &command[_received],
+                command.size() - _received, MSG_DONTWAIT);
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return RequestState::Partial;
+        }
+        else if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (count <= 0) {
+            return RequestState::Failed;
+        }
+
+        _received += count;
+    }
+
+    return RequestState::Complete;
+}
+
+bool DaemonConnection::sendStatus(int exitCode)
+{
+    std::int32_t status = exitCode;
+    return write_all(_socket, &status, sizeof status);
+}
+
+bool DaemonConnection::receiveStatus(int& exitCode)
+{
+    std::int32_t status;
+    if (!read_all(_socket, &status, sizeof status)) {
+        return false;
+    }
+
+    exitCode = status;
+    return true;
+}
+
+} // namespace rshell
@@ -0,0 +1,116 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::DaemonConnection class
+
+#ifndef hpp_rshell_DaemonConnection
+#define hpp_rshell_DaemonConnection
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace rshell {
+
+/// \brief Progress of a request being received by the daemon
+enum class RequestState
+{
+    Partial, //!< More of the request is expected
+    Complete, //!< The whole request has been received
+    Failed //!< The connection failed or the request was malformed
+};
+
+/// \brief Connection between a client and the shell daemon over a Unix
+/// domain socket
+///
+/// A request consists of a command string and the file descriptors the
+/// command is to use as its standard input, output, and error, followed by
+/// a descriptor for its working directory.  The descriptors are passed with
+/// SCM_RIGHTS ancillary data.  The response is the exit code of the command.
+class DaemonConnection
+{
+public:
+    /// \brief Number of file descriptors passed with each request
+    static constexpr std::size_t fileCount = 4;
+
+    /// \brief Constructs a new instance of the \ref DaemonConnection class on
+    /// the given connected socket
+    /// \param socket connected socket, which the connection takes ownership
+    /// of
+    explicit DaemonConnection(int socket);
+
+    /// \brief Destructs the \ref DaemonConnection instance, closing the
+    /// socket
+    ~DaemonConnection();
+
+    DaemonConnection(const DaemonConnection&) = delete;
+    DaemonConnection& operator=(const DaemonConnection&) = delete;
+
+    /// \brief Gets the default path of the daemon socket
+    /// \return value of the RSHELL_SOCKET environment variable if it is set,
+    /// otherwise a per-user path within /tmp
+    static std::string defaultPath();
+
+    /// \brief Connects to the daemon listening at the given path
+    /// \param path path of the daemon socket
+    /// \return connected socket, or -1 on failure
+    static int connect(const std::string& path);
+
+    /// \brief Gets the socket of the connection
+    /// \return socket file descriptor
+    int socket() const noexcept { return _socket; }
+
+    /// \brief Sends a request to the daemon
+    /// \param command command string to execute
+    /// \param files standard input, output, error, and working directory
+    /// descriptors for the command
+    /// \return whether or not the request was sent
+    bool sendRequest(const std::string& command, const std::vector<int>& files);
+
+    /// \brief Receives the part of a request from a client that has arrived,
+    /// without waiting on the client
+    /// \param command command string, received in full once the request is
+    /// \param files received descriptors, which the caller must close
+    /// \return \ref RequestState::Complete once the whole request has been
+    /// received, \ref RequestState::Partial while more of it is expected,
+    /// or \ref RequestState::Failed if the client closed the connection or
+    /// sent a malformed request
+    ///
+    /// The same command string and descriptors are to be passed to each call
+    /// on the connection until the request is complete or failed.
+    RequestState receiveRequest(std::string& command,
+            std::vector<int>& files);
+
+    /// \brief Sends the exit code of a command to the client
+    /// \param exitCode exit code of the command
+    /// \return whether or not the exit code was sent
+    bool sendStatus(int exitCode);
+
+    /// \brief Receives the exit code of a command from the daemon
+    /// \param exitCode exit code of the command
+    /// \return whether or not the exit code was received
+    bool receiveStatus(int& exitCode);
+
+private:
+    int _socket; //!< Connected socket
+    bool _hasHeader{false}; //!< Whether the request header was received
+    std::size_t _received{0}; //!< Bytes of the command string received
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_DaemonConnection
@@ -0,0 +1,45 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "DependencyGraph.hpp"
+#include "Command.hpp"
+#include <utility>
+
+namespace rshell {
+
+DependencyGraph::DependencyGraph(
+        const std::vector<std::unique_ptr<Command>>& sequence)
+{
+    for (auto&& command : sequence) {
+        if (command == nullptr) {
+            continue;
+        }
+
+        // Add an edge from every earlier command that conflicts with this
+        // one.  Edges are never removed, so the graph is acyclic by
+        // construction and its order is a valid sequential schedule
+        Node node{command.get(), CommandFootprint::analyze(*command), {}};
+        for (std::size_t i = 0; i < _nodes.size(); ++i) {
+            if (node.footprint.conflictsWith(_nodes[i].footprint)) {
+                node.dependencies.push_back(i);
+            }
+        }
+
+        _nodes.push_back(std::move(node));
+    }
+}
+
+} // namespace rshell
@@ -0,0 +1,85 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::DependencyGraph class
+
+#ifndef hpp_rshell_DependencyGraph
+#define hpp_rshell_DependencyGraph
+
+#include "CommandFootprint.hpp"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace rshell {
+
+// Forward declarations
+class Command;
+
+/// \brief Directed acyclic graph of the ordering constraints between the
+/// commands of a sequence
+///
+/// A command depends on every earlier command in the sequence whose
+/// footprint conflicts with its own.  Commands without a path between them
+/// in the graph may execute concurrently.
+class DependencyGraph
+{
+public:
+    /// \brief Constructs a new instance of the \ref DependencyGraph class on
+    /// the given sequence of commands
+    /// \param sequence sequence of commands to analyze
+    ///
+    /// Null commands in the sequence are omitted from the graph.
+    explicit DependencyGraph(
+            const std::vector<std::unique_ptr<Command>>& sequence);
+
+    /// \brief Gets the number of commands in the graph
+    /// \return number of commands
+    std::size_t size() const noexcept { return _nodes.size(); }
+
+    /// \brief Gets a reference to a command in the graph
+    /// \param i index of the command
+    /// \return reference to the command
+    Command& command(std::size_t i) const { return *_nodes[i].command; }
+
+    /// \brief Gets a reference to the footprint of a command in the graph
+    /// \param i index of the command
+    /// \return reference to the footprint
+    const CommandFootprint& footprint(std::size_t i) const
+    { return _nodes[i].footprint; }
+
+    /// \brief Gets a reference to the dependencies of a command in the graph
+    /// \param i index of the command
+    /// \return reference to the indices of the commands it depends upon
+    const std::vector<std::size_t>& dependencies(std::size_t i) const
+    { return _nodes[i].dependencies; }
+
+private:
+    /// \brief Vertex of the graph
+    struct Node
+    {
+        Command* command; //!< Command represented by the vertex
+        CommandFootprint footprint; //!< Footprint of the command
+        std::vector<std::size_t> dependencies; //!< Incoming edges
+    };
+
+    std::vector<Node> _nodes; //!< Vertices in sequence order
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_DependencyGraph
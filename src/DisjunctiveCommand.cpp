@@ -22,18 +22,30 @@ namespace rshell {
 
 DisjunctiveCommand::~DisjunctiveCommand() = default;
 
-int DisjunctiveCommand::execute(Executor& executor, WaitMode waitMode)
+int DisjunctiveCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
 {
     if (primary == nullptr || secondary == nullptr) {
         throw std::runtime_error{"incomplete DisjunctiveCommand"};
     }
 
-    auto exitCode = primary->execute(executor, waitMode);
+    auto exitCode = primary->execute(executor, context, waitMode);
     if (exitCode != 0) {
-        exitCode = secondary->execute(executor, waitMode);
+        exitCode = secondary->execute(executor, context, waitMode);
     }
 
     return exitCode;
 }
 
+void DisjunctiveCommand::prepare(Executor& executor)
+{
+    if (primary != nullptr) {
+        primary->prepare(executor);
+    }
+
+    if (secondary != nullptr) {
+        secondary->prepare(executor);
+    }
+}
+
 } // namespace rshell
@@ -0,0 +1,64 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "DuplicateRedirectionCommand.hpp"
+#include "Executor.hpp"
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <unistd.h>
+
+namespace rshell {
+
+DuplicateRedirectionCommand::DuplicateRedirectionCommand()
+    : RedirectionCommand{STDOUT_FILENO}
+{
+}
+
+DuplicateRedirectionCommand::~DuplicateRedirectionCommand() = default;
+
+ExecutionContext DuplicateRedirectionCommand::redirect(Executor& executor,
+        const ExecutionContext& context) const
+{
+    if (source < 0) {
+        std::shared_ptr<ExecutorStream> stream{
+            executor.createClosedStream(mode)};
+        if (stream == nullptr) {
+            throw std::runtime_error{"unable to close descriptors on this "
+                "executor"};
+        }
+
+        return context.withStream(slot, std::move(stream));
+    }
+
+    // A descriptor already replaced within the context shares its stream;
+    // one inherited from the shell is copied
+    auto found = context.streams().find(source);
+    if (found != std::end(context.streams())) {
+        return context.withStream(slot, found->second);
+    }
+
+    std::shared_ptr<ExecutorStream> stream{
+        executor.createDuplicateStream(source, mode)};
+    if (stream == nullptr) {
+        throw std::runtime_error{"unable to duplicate descriptors on this "
+            "executor"};
+    }
+
+    return context.withStream(slot, std::move(stream));
+}
+
+} // namespace rshell
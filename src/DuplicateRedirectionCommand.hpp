@@ -0,0 +1,59 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the
+/// \ref rshell::DuplicateRedirectionCommand class
+
+#ifndef hpp_rshell_DuplicateRedirectionCommand
+#define hpp_rshell_DuplicateRedirectionCommand
+
+#include "ExecutorStream.hpp"
+#include "RedirectionCommand.hpp"
+
+namespace rshell {
+
+/// \brief Command to be executed with a descriptor replaced by a copy of
+/// another, as in "foo 2>&1", or closed, as in "foo 2>&-"
+class DuplicateRedirectionCommand : public RedirectionCommand
+{
+public:
+    /// \brief Descriptor to copy, or -1 to close the descriptor instead
+    int source{-1};
+
+    /// \brief Input/output mode of the copy
+    ExecutorStream::Mode mode{ExecutorStream::Mode::Output};
+
+    /// \brief Constructs a new instance of the
+    /// \ref DuplicateRedirectionCommand class replacing the standard output
+    DuplicateRedirectionCommand();
+
+    /// \brief Destructs the \ref DuplicateRedirectionCommand instance
+    virtual ~DuplicateRedirectionCommand();
+
+    /// \brief Applies the redirection alone to a context
+    /// \param executor executor to create streams on
+    /// \param context context to redirect
+    /// \return redirected context
+    /// \throw std::runtime_error if the executor cannot copy or close
+    /// descriptors
+    virtual ExecutionContext redirect(Executor& executor,
+            const ExecutionContext& context) const override;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_DuplicateRedirectionCommand
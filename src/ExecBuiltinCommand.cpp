@@ -0,0 +1,68 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "ExecBuiltinCommand.hpp"
+#include "ExecutionContext.hpp"
+#include "Executor.hpp"
+#include <iostream>
+#include <iterator>
+
+namespace rshell {
+
+ExecBuiltinCommand::~ExecBuiltinCommand() = default;
+
+int ExecBuiltinCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    return executeRedirected(executor, context, context, waitMode);
+}
+
+int ExecBuiltinCommand::executeRedirected(Executor& executor,
+        const ExecutionContext& context, const ExecutionContext& redirected,
+        WaitMode)
+{
+    if (!arguments.empty()) {
+        std::cerr << "rshell: exec: replacing the shell with a program is "
+            "not supported\n";
+        return 1;
+    }
+
+    // Place each stream the redirections of the command replaced on the
+    // descriptor of the shell.  Streams the context already held belong to
+    // a surrounding command, and last only as long as it does
+    for (auto&& stream : redirected.streams()) {
+        auto previous = context.streams().find(stream.first);
+        if (previous != std::end(context.streams()) &&
+                previous->second == stream.second) {
+            continue;
+        }
+
+        if (!executor.redirectShell(stream.first, *stream.second)) {
+            std::cerr << "rshell: exec: redirecting the shell is not "
+                "supported by this executor\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+bool ExecBuiltinCommand::isExternal() const
+{
+    return false;
+}
+
+} // namespace rshell
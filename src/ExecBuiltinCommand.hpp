@@ -0,0 +1,69 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::ExecBuiltinCommand
+/// class
+
+#ifndef hpp_rshell_ExecBuiltinCommand
+#define hpp_rshell_ExecBuiltinCommand
+
+#include "ExecutableCommand.hpp"
+
+namespace rshell {
+
+/// \brief Represents an invocation of the exec builtin command
+///
+/// The exec command applies the redirections written after it to the
+/// descriptors of the shell itself, as in "exec >> log 2>&1" and
+/// "exec 3< file", so that later commands inherit the open descriptors
+/// rather than opening their files again.  Only the descriptors its own
+/// redirections replace change; those a surrounding command redirected are
+/// left alone.
+class ExecBuiltinCommand : public ExecutableCommand
+{
+public:
+    /// \brief Destructs the \ref ExecBuiltinCommand instance
+    virtual ~ExecBuiltinCommand();
+
+    /// \brief Executes the command using the given executor
+    /// \param executor executor to use for execution
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return zero on success, nonzero on failure
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Executes the command using the given executor, with the
+    /// redirections written after it already applied
+    /// \param executor executor to use for execution
+    /// \param context context preceding the redirections
+    /// \param redirected context with the redirections applied
+    /// \param waitMode wait mode to use when executing
+    /// \return zero on success, nonzero on failure
+    virtual int executeRedirected(Executor& executor,
+            const ExecutionContext& context,
+            const ExecutionContext& redirected, WaitMode waitMode) override;
+
+    /// \brief Gets a value indicating whether or not the command only starts
+    /// an external program
+    /// \return \c false, as builtins execute within the shell
+    virtual bool isExternal() const override;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_ExecBuiltinCommand
@@ -21,9 +21,20 @@ namespace rshell {
 
 ExecutableCommand::~ExecutableCommand() = default;
 
-int ExecutableCommand::execute(Executor& executor, WaitMode waitMode)
+int ExecutableCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
 {
-    return executor.execute(*this, waitMode);
+    return executor.execute(*this, context, waitMode);
+}
+
+void ExecutableCommand::prepare(Executor& executor)
+{
+    executor.prepare(*this);
+}
+
+bool ExecutableCommand::isExternal() const
+{
+    return true;
 }
 
 } // namespace rshell
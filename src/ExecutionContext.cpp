@@ -0,0 +1,157 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "ExecutionContext.hpp"
+#include "ExecutorJob.hpp"
+#include "ExecutorStream.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+extern char** environ;
+
+namespace rshell {
+
+ExecutionContext::ExecutionContext() = default;
+
+ExecutorStream* ExecutionContext::stream(int slot) const
+{
+    auto stream = _streams.find(slot);
+    return stream != std::end(_streams) ? stream->second.get() : nullptr;
+}
+
+ExecutionContext ExecutionContext::withStream(int slot,
+        std::shared_ptr<ExecutorStream> stream) const
+{
+    auto context = *this;
+    context._streams[slot] = std::move(stream);
+    return context;
+}
+
+ExecutionContext ExecutionContext::forSubshell() const
+{
+    auto context = *this;
+    context._streams.clear();
+    context._jobHandler.reset();
+    context._isGroupLeader = false;
+    return context;
+}
+
+ExecutionContext::Environment ExecutionContext::environment() const
+{
+    if (_environment != nullptr) {
+        return *_environment;
+    }
+
+    Environment environment;
+    for (auto entry = environ; entry != nullptr && *entry != nullptr;
+            ++entry) {
+        environment.push_back(*entry);
+    }
+
+    return environment;
+}
+
+bool ExecutionContext::variable(const std::string& name,
+        std::string& value) const
+{
+    if (_environment == nullptr) {
+        auto result = std::getenv(name.c_str());
+        if (result != nullptr) {
+            value = result;
+        }
+
+        return result != nullptr;
+    }
+
+    for (auto&& entry : *_environment) {
+        if (entry.size() > name.size() && entry[name.size()] == '=' &&
+                entry.compare(0, name.size(), name) == 0) {
+            value = entry.substr(name.size() + 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+ExecutionContext ExecutionContext::withEnvironment(
+        Environment environment) const
+{
+    auto context = *this;
+    context._environment =
+        std::make_shared<const Environment>(std::move(environment));
+    return context;
+}
+
+ExecutionContext ExecutionContext::withVariable(const std::string& name,
+        const std::string& value) const
+{
+    auto environment = this->environment();
+    auto entry = name + '=' + value;
+
+    auto isReplaced = false;
+    for (auto&& existing : environment) {
+        if (existing.size() > name.size() && existing[name.size()] == '=' &&
+                existing.compare(0, name.size(), name) == 0) {
+            existing = entry;
+            isReplaced = true;
+        }
+    }
+
+    if (!isReplaced) {
+        environment.push_back(entry);
+    }
+
+    return withEnvironment(std::move(environment));
+}
+
+void ExecutionContext::adopt(std::unique_ptr<ExecutorJob> job) const
+{
+    if (_jobHandler != nullptr) {
+        (*_jobHandler)(std::move(job));
+    }
+}
+
+ExecutionContext ExecutionContext::withJobHandler(JobHandler handler) const
+{
+    auto context = *this;
+    context._jobHandler =
+        std::make_shared<const JobHandler>(std::move(handler));
+    return context;
+}
+
+bool ExecutionContext::isPastDeadline() const
+{
+    return hasDeadline() && Clock::now() >= _deadline;
+}
+
+ExecutionContext ExecutionContext::withDeadline(
+        Clock::time_point deadline) const
+{
+    auto context = *this;
+    context._deadline = std::min(_deadline, deadline);
+    return context;
+}
+
+ExecutionContext ExecutionContext::withGroupLeader() const
+{
+    auto context = *this;
+    context._isGroupLeader = true;
+    return context;
+}
+
+} // namespace rshell
@@ -0,0 +1,194 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::ExecutionContext class
+
+#ifndef hpp_rshell_ExecutionContext
+#define hpp_rshell_ExecutionContext
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rshell {
+
+// Forward declarations
+class ExecutorJob;
+class ExecutorStream;
+
+/// \brief Immutable state for one execution of a command: the streams that
+/// replace the descriptors of executed programs, their environment, and the
+/// time by which they must finish
+///
+/// Commands derive a new context for each subcommand instead of modifying
+/// state shared through the executor, so any number of threads may execute
+/// subtrees against one executor, each with its own context.  Contexts are
+/// cheap to copy; the streams within them are shared and closed once the
+/// last context referring to them is destroyed.
+///
+/// A context may also carry a job handler, which adopts the jobs that
+/// commands executed in continue mode within it leave running, so that
+/// their starter may wait for them later.
+///
+/// A deadline is an absolute time, so every command nested within a scope
+/// given one shares what remains of its budget.  A nested deadline may only
+/// shorten it.
+class ExecutionContext
+{
+public:
+    /// \brief Type of the mapping from descriptor slots to streams
+    using StreamMap = std::map<int, std::shared_ptr<ExecutorStream>>;
+
+    /// \brief Type of an environment as "name=value" entries
+    using Environment = std::vector<std::string>;
+
+    /// \brief Type of clock measuring deadlines
+    using Clock = std::chrono::steady_clock;
+
+    /// \brief Type of function adopting jobs left running in continue mode
+    using JobHandler = std::function<void(std::unique_ptr<ExecutorJob>)>;
+
+    /// \brief Constructs a new instance of the \ref ExecutionContext class
+    /// with no replaced descriptors and the environment of the shell
+    ExecutionContext();
+
+    /// \brief Gets the mapping from descriptor slots to streams
+    /// \return mapping of replaced descriptors
+    const StreamMap& streams() const noexcept { return _streams; }
+
+    /// \brief Gets the stream replacing a descriptor
+    /// \param slot descriptor to get the stream for
+    /// \return stream replacing the descriptor, or \c null if the descriptor
+    /// is inherited from the shell
+    ExecutorStream* stream(int slot) const;
+
+    /// \brief Derives a context in which a descriptor is replaced by a stream
+    /// \param slot descriptor to replace
+    /// \param stream stream to replace the descriptor with
+    /// \return derived context
+    ExecutionContext withStream(int slot,
+            std::shared_ptr<ExecutorStream> stream) const;
+
+    /// \brief Derives the context of a subshell, in which the streams of the
+    /// context have been activated on the descriptors of the subshell
+    /// \return derived context with the same environment and deadline, no
+    /// replaced descriptors, no job handler, and processes left in the group
+    /// of the subshell
+    ExecutionContext forSubshell() const;
+
+    /// \brief Gets a value indicating whether or not the context replaces the
+    /// environment of the shell
+    /// \return whether or not the environment is replaced
+    bool hasEnvironment() const noexcept { return _environment != nullptr; }
+
+    /// \brief Gets the environment of executed programs
+    /// \return environment of the context if it is replaced, otherwise the
+    /// current environment of the shell
+    Environment environment() const;
+
+    /// \brief Gets the value of an environment variable
+    /// \param name name of the variable
+    /// \param value value of the variable, if it is set
+    /// \return whether or not the variable is set
+    bool variable(const std::string& name, std::string& value) const;
+
+    /// \brief Derives a context with the given environment
+    /// \param environment environment of executed programs
+    /// \return derived context
+    ExecutionContext withEnvironment(Environment environment) const;
+
+    /// \brief Derives a context in which an environment variable is set
+    /// \param name name of the variable
+    /// \param value value of the variable
+    /// \return derived context
+    ExecutionContext withVariable(const std::string& name,
+            const std::string& value) const;
+
+    /// \brief Gets a value indicating whether or not jobs left running in
+    /// continue mode are adopted
+    /// \return whether or not the context has a job handler
+    bool hasJobHandler() const noexcept { return _jobHandler != nullptr; }
+
+    /// \brief Hands a job left running in continue mode to the job handler
+    /// \param job job to hand over
+    ///
+    /// The job is abandoned if the context has no job handler.
+    void adopt(std::unique_ptr<ExecutorJob> job) const;
+
+    /// \brief Derives a context in which jobs left running in continue mode
+    /// are handed to the given handler
+    /// \param handler function adopting the jobs
+    /// \return derived context
+    ExecutionContext withJobHandler(JobHandler handler) const;
+
+    /// \brief Gets the time by which commands executed within the context
+    /// must finish
+    /// \return deadline, or the latest representable time if there is none
+    Clock::time_point deadline() const noexcept { return _deadline; }
+
+    /// \brief Gets a value indicating whether or not commands executed within
+    /// the context must finish by a deadline
+    /// \return whether or not the context has a deadline
+    bool hasDeadline() const noexcept
+    {
+        return _deadline != Clock::time_point::max();
+    }
+
+    /// \brief Gets a value indicating whether or not the deadline of the
+    /// context has passed, leaving no time for further commands
+    /// \return whether or not the deadline has passed
+    bool isPastDeadline() const;
+
+    /// \brief Derives a context whose commands must finish by the given time,
+    /// or by the deadline of the context if it is sooner
+    /// \param deadline time by which the commands must finish
+    /// \return derived context
+    ExecutionContext withDeadline(Clock::time_point deadline) const;
+
+    /// \brief Gets a value indicating whether or not each process started
+    /// within the context leads a process group of its own
+    /// \return whether or not started processes lead process groups
+    bool isGroupLeader() const noexcept { return _isGroupLeader; }
+
+    /// \brief Derives a context in which each process started leads a
+    /// process group of its own, so that it may be stopped along with
+    /// everything it starts
+    /// \return derived context
+    ExecutionContext withGroupLeader() const;
+
+private:
+    StreamMap _streams; //!< Streams replacing descriptors, by slot
+
+    /// \brief Replaced environment, or \c null to use that of the shell
+    std::shared_ptr<const Environment> _environment;
+
+    /// \brief Function adopting jobs left running, or \c null to abandon them
+    std::shared_ptr<const JobHandler> _jobHandler;
+
+    /// \brief Time by which commands must finish, if any
+    Clock::time_point _deadline{Clock::time_point::max()};
+
+    /// \brief Whether or not started processes lead process groups
+    bool _isGroupLeader{false};
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_ExecutionContext
@@ -15,24 +15,303 @@
 // SOFTWARE.
 
 #include "Executor.hpp"
+#include "DependencyGraph.hpp"
+#include "ExecutorFan.hpp"
+#include "ExecutorJob.hpp"
+#include "ExecutorPipeBuffer.hpp"
+#include "ExecutorPipeRelay.hpp"
+#include "ExecutorRace.hpp"
+#include "ExecutorStream.hpp"
+#include <stdexcept>
+#include <utility>
+#include <unistd.h>
 
 namespace rshell {
 
 Executor::~Executor() = default;
 
-void Executor::setInputStream(ExecutorStream* inputStream)
+void Executor::setConcurrency(std::size_t concurrency)
 {
-    _inputStream = inputStream;
+    _concurrency = concurrency;
 }
 
-void Executor::setOutputStream(ExecutorStream* outputStream)
+void Executor::setPipefail(bool isPipefail)
 {
-    _outputStream = outputStream;
+    _isPipefail = isPipefail;
+}
+
+void Executor::setPipeCapacity(std::size_t capacity)
+{
+    _pipeCapacity = capacity;
+}
+
+void Executor::setPipeGrowth(bool isPipeGrowth)
+{
+    _isPipeGrowth = isPipeGrowth;
+}
+
+void Executor::setPipeProfile(bool isPipeProfile)
+{
+    _isPipeProfile = isPipeProfile;
+}
+
+constexpr std::size_t Executor::defaultPipeBufferLimit;
+
+void Executor::setPipeBufferLimit(std::size_t limit)
+{
+    _pipeBufferLimit = limit;
+}
+
+constexpr std::size_t Executor::defaultCacheLimit;
+
+void Executor::setCacheDirectory(std::string directory)
+{
+    _cacheDirectory = std::move(directory);
+}
+
+void Executor::setCacheLimit(std::size_t limit)
+{
+    _cacheLimit = limit;
+}
+
+std::vector<JobStatus> Executor::pipeStatus() const
+{
+    std::lock_guard<std::mutex> lock{_pipeStatusMutex};
+    return _pipeStatus;
+}
+
+void Executor::setPipeStatus(std::vector<JobStatus> statuses)
+{
+    std::lock_guard<std::mutex> lock{_pipeStatusMutex};
+    _pipeStatus = std::move(statuses);
+}
+
+int Executor::pipeExitCode(const std::vector<JobStatus>& statuses) const
+{
+    if (_isPipefail) {
+        for (auto status = statuses.rbegin(); status != statuses.rend();
+                ++status) {
+            if (status->exitCode != 0) {
+                return status->exitCode;
+            }
+        }
+    }
+
+    return statuses.back().exitCode;
+}
+
+std::unique_ptr<ExecutorPipeRelay> Executor::createPipeRelay()
+{
+    return nullptr;
+}
+
+std::unique_ptr<ExecutorPipeBuffer> Executor::createPipeBuffer(
+        std::shared_ptr<ExecutorPipe>, std::shared_ptr<ExecutorPipe>)
+{
+    return nullptr;
+}
+
+std::unique_ptr<ExecutorFan> Executor::createFanOut(
+        std::shared_ptr<ExecutorPipe>,
+        std::vector<std::shared_ptr<ExecutorPipe>>)
+{
+    return nullptr;
+}
+
+std::unique_ptr<ExecutorFan> Executor::createFanIn(
+        std::vector<std::shared_ptr<ExecutorPipe>>,
+        std::shared_ptr<ExecutorPipe>)
+{
+    return nullptr;
+}
+
+std::unique_ptr<ExecutorRace> Executor::createRace(
+        std::vector<std::shared_ptr<ExecutorPipe>>,
+        std::shared_ptr<ExecutorStream>)
+{
+    return nullptr;
+}
+
+std::unique_ptr<ExecutorStream> Executor::createDuplicateStream(int,
+        ExecutorStream::Mode)
+{
+    return nullptr;
+}
+
+std::unique_ptr<ExecutorStream> Executor::createClosedStream(
+        ExecutorStream::Mode)
+{
+    return nullptr;
+}
+
+std::unique_ptr<ExecutorStream> Executor::createDocumentStream(
+        const std::string&)
+{
+    return nullptr;
+}
+
+bool Executor::redirectShell(int, ExecutorStream&)
+{
+    return false;
 }
 
 int Executor::execute(Command& command, WaitMode waitMode)
 {
-    return command.execute(*this, waitMode);
+    return execute(command, ExecutionContext{}, waitMode);
+}
+
+int Executor::execute(Command& command, const ExecutionContext& context,
+        WaitMode waitMode)
+{
+    return command.execute(*this, context, waitMode);
+}
+
+int Executor::executeSubshell(Command& command,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    return command.execute(*this, context, waitMode);
+}
+
+void Executor::start(Command& command, const ExecutionContext& context)
+{
+    if (command.isExternal()) {
+        command.execute(*this, context, WaitMode::Continue);
+    }
+    else {
+        executeSubshell(command, context, WaitMode::Continue);
+    }
+}
+
+bool Executor::startCoprocess(const std::string& name, Command& command,
+        const ExecutionContext& context)
+{
+    std::lock_guard<std::mutex> lock{_coprocessesMutex};
+    if (_coprocesses.count(name) != 0) {
+        return false;
+    }
+
+    // The coprocess holds the ends of the pipes it uses, while the shell
+    // keeps the other ends open for later redirections
+    Coprocess coprocess;
+    std::shared_ptr<ExecutorPipe> input{createPipe()};
+    std::shared_ptr<ExecutorPipe> output{createPipe()};
+    auto started = context
+        .withStream(STDIN_FILENO, {input, &input->inputStream()})
+        .withStream(STDOUT_FILENO, {output, &output->outputStream()})
+        .withJobHandler([&](std::unique_ptr<ExecutorJob> job)
+                {
+                    coprocess.job = std::move(job);
+                });
+
+    start(command, started);
+    input->inputStream().close();
+    output->outputStream().close();
+    coprocess.input = std::move(input);
+    coprocess.output = std::move(output);
+    _coprocesses[name] = std::move(coprocess);
+    return true;
+}
+
+std::shared_ptr<ExecutorStream> Executor::coprocessStream(
+        const std::string& path, ExecutorStream::Mode mode) const
+{
+    if (path.empty() || path[0] != '%') {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock{_coprocessesMutex};
+    auto found = _coprocesses.find(path.substr(1));
+    if (found == std::end(_coprocesses)) {
+        throw std::runtime_error{"no such coprocess: " + path.substr(1)};
+    }
+
+    // The stream shares ownership of the pipe, so that it outlives a
+    // coprocess closed while the redirection is in use
+    auto& coprocess = found->second;
+    switch (mode) {
+        case ExecutorStream::Mode::Input:
+            return {coprocess.output, &coprocess.output->inputStream()};
+
+        case ExecutorStream::Mode::Output:
+            break;
+    }
+
+    return {coprocess.input, &coprocess.input->outputStream()};
+}
+
+bool Executor::closeCoprocess(const std::string& name, JobStatus& status)
+{
+    Coprocess coprocess;
+    {
+        std::lock_guard<std::mutex> lock{_coprocessesMutex};
+        auto found = _coprocesses.find(name);
+        if (found == std::end(_coprocesses)) {
+            return false;
+        }
+
+        coprocess = std::move(found->second);
+        _coprocesses.erase(found);
+    }
+
+    // The end of its input tells the coprocess to finish, while its output
+    // remains open until it has, so that it is not stopped by a broken pipe
+    coprocess.input->outputStream().close();
+    status = coprocess.job != nullptr ? coprocess.job->wait() : JobStatus{};
+    return true;
+}
+
+std::vector<std::shared_ptr<ExecutorStream>>
+Executor::coprocessStreams() const
+{
+    std::lock_guard<std::mutex> lock{_coprocessesMutex};
+    std::vector<std::shared_ptr<ExecutorStream>> streams;
+    for (auto&& coprocess : _coprocesses) {
+        auto& input = coprocess.second.input;
+        auto& output = coprocess.second.output;
+        streams.emplace_back(input, &input->outputStream());
+        streams.emplace_back(output, &output->inputStream());
+    }
+
+    return streams;
+}
+
+std::vector<std::string> Executor::coprocessNames() const
+{
+    std::lock_guard<std::mutex> lock{_coprocessesMutex};
+    std::vector<std::string> names;
+    for (auto&& coprocess : _coprocesses) {
+        names.push_back(coprocess.first);
+    }
+
+    return names;
+}
+
+std::vector<JobStatus> Executor::wait(
+        std::vector<std::unique_ptr<ExecutorJob>>& jobs)
+{
+    std::vector<JobStatus> statuses(jobs.size());
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        if (jobs[i] != nullptr) {
+            statuses[i] = jobs[i]->wait();
+        }
+    }
+
+    return statuses;
+}
+
+void Executor::prepare(ExecutableCommand& command)
+{
+}
+
+int Executor::execute(DependencyGraph& graph,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    auto exitCode = 0;
+    for (std::size_t i = 0; i < graph.size(); ++i) {
+        exitCode = graph.command(i).execute(*this, context, waitMode);
+    }
+
+    return exitCode;
 }
 
 } // namespace rshell
@@ -21,15 +21,27 @@
 #define hpp_rshell_Executor
 
 #include "ExecutableCommand.hpp"
-#include "ExecutorStreamSet.hpp"
+#include "ExecutionContext.hpp"
+#include "ExecutorJob.hpp"
+#include "ExecutorPipe.hpp"
+#include "ExecutorStream.hpp"
+#include "JobStatus.hpp"
 #include "WaitMode.hpp"
+#include <cstddef>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace rshell {
 
 // Forward declarations
-class ExecutorPipe;
-class ExecutorStream;
+class DependencyGraph;
+class ExecutorFan;
+class ExecutorPipeBuffer;
+class ExecutorPipeRelay;
+class ExecutorRace;
 
 /// \brief Serves as the abstract base class in the strategy pattern of the
 /// execution algorithm
@@ -39,29 +51,181 @@ public:
     /// \brief Destructs the \ref Executor instance
     virtual ~Executor();
 
-    /// \brief Gets a reference to the set of open streams
-    /// \return reference to set of open streams
-    ExecutorStreamSet& streamSet() noexcept { return _streamSet; }
+    /// \brief Gets the maximum number of independent sequential commands to
+    /// execute concurrently
+    /// \return maximum number of concurrent commands
+    std::size_t concurrency() const noexcept { return _concurrency; }
 
-    /// \brief Gets the stream to replace stdin
-    /// \return pointer to input stream
-    ExecutorStream* inputStream() const noexcept { return _inputStream; }
+    /// \brief Sets the maximum number of independent sequential commands to
+    /// execute concurrently
+    /// \param concurrency maximum number of concurrent commands
+    ///
+    /// A concurrency of one, the default, disables concurrent execution.
+    void setConcurrency(std::size_t concurrency);
 
-    /// \brief Sets the stream to replace stdin
-    /// \param inputStream pointer to input stream
-    void setInputStream(ExecutorStream* inputStream);
+    /// \brief Gets a value indicating whether or not a pipeline fails when
+    /// any of its stages fails
+    /// \return whether or not pipefail mode is enabled
+    bool isPipefail() const noexcept { return _isPipefail; }
 
-    /// \brief Gets the stream to replace stdout
-    /// \return pointer to output stream
-    ExecutorStream* outputStream() const noexcept { return _outputStream; }
+    /// \brief Sets a value indicating whether or not a pipeline fails when
+    /// any of its stages fails
+    /// \param isPipefail whether or not to enable pipefail mode
+    ///
+    /// In pipefail mode, the exit code of a pipeline is that of its last
+    /// failing stage.  Otherwise, the default, it is that of its last stage.
+    void setPipefail(bool isPipefail);
 
-    /// \brief Sets the stream to replace stdout
-    /// \param outputStream pointer to output stream
-    void setOutputStream(ExecutorStream* outputStream);
+    /// \brief Gets the default capacity of the pipes created by the executor
+    /// \return capacity in bytes, or zero for the default of the system
+    std::size_t pipeCapacity() const noexcept { return _pipeCapacity; }
+
+    /// \brief Sets the default capacity of the pipes created by the executor
+    /// \param capacity capacity in bytes, or zero for the default of the
+    /// system
+    void setPipeCapacity(std::size_t capacity);
+
+    /// \brief Gets a value indicating whether or not the pipes between the
+    /// stages of a pipeline grow while they are full
+    /// \return whether or not pipe growth mode is enabled
+    bool isPipeGrowth() const noexcept { return _isPipeGrowth; }
+
+    /// \brief Sets a value indicating whether or not the pipes between the
+    /// stages of a pipeline grow while they are full
+    /// \param isPipeGrowth whether or not to enable pipe growth mode
+    ///
+    /// Executors that cannot observe their pipes ignore this mode.
+    void setPipeGrowth(bool isPipeGrowth);
+
+    /// \brief Gets a value indicating whether or not pipelines are profiled
+    /// \return whether or not pipe profiling mode is enabled
+    bool isPipeProfile() const noexcept { return _isPipeProfile; }
+
+    /// \brief Sets a value indicating whether or not pipelines are profiled
+    /// \param isPipeProfile whether or not to enable pipe profiling mode
+    ///
+    /// In pipe profiling mode, the pipes of a pipeline pass through a relay
+    /// created by the executor, and a report of the traffic through each
+    /// and the stage the others waited on is written to standard error.
+    /// Executors that cannot relay pipes ignore this mode.
+    void setPipeProfile(bool isPipeProfile);
+
+    /// \brief Default bytes a buffered pipe holds in memory before spilling
+    /// to a file
+    static constexpr std::size_t defaultPipeBufferLimit = 16777216;
+
+    /// \brief Gets the bytes a buffered pipe holds in memory before spilling
+    /// to a file
+    /// \return memory limit in bytes
+    std::size_t pipeBufferLimit() const noexcept { return _pipeBufferLimit; }
+
+    /// \brief Sets the bytes a buffered pipe holds in memory before spilling
+    /// to a file
+    /// \param limit memory limit in bytes
+    void setPipeBufferLimit(std::size_t limit);
+
+    /// \brief Default bytes of results the command result cache keeps
+    static constexpr std::size_t defaultCacheLimit = 268435456;
+
+    /// \brief Gets the directory of the command result cache
+    /// \return path of the directory, or an empty string for the default
+    const std::string& cacheDirectory() const noexcept
+    {
+        return _cacheDirectory;
+    }
+
+    /// \brief Sets the directory of the command result cache
+    /// \param directory path of the directory, or an empty string for the
+    /// default
+    void setCacheDirectory(std::string directory);
+
+    /// \brief Gets the bytes of results the command result cache keeps
+    /// before evicting the least recently used
+    /// \return eviction budget in bytes
+    std::size_t cacheLimit() const noexcept { return _cacheLimit; }
+
+    /// \brief Sets the bytes of results the command result cache keeps
+    /// before evicting the least recently used
+    /// \param limit eviction budget in bytes
+    void setCacheLimit(std::size_t limit);
+
+    /// \brief Gets the statuses of the stages of the last pipeline executed
+    /// \return statuses in stage order
+    std::vector<JobStatus> pipeStatus() const;
+
+    /// \brief Sets the statuses of the stages of the last pipeline executed
+    /// \param statuses statuses in stage order
+    void setPipeStatus(std::vector<JobStatus> statuses);
+
+    /// \brief Determines the exit code of a pipeline from its stages
+    /// \param statuses statuses of the stages
+    /// \return exit code of the last failing stage in pipefail mode,
+    /// otherwise that of the last stage
+    int pipeExitCode(const std::vector<JobStatus>& statuses) const;
 
     /// \brief Creates a new pipe on the executor
+    /// \param capacity capacity of the pipe in bytes, or zero for the
+    /// default capacity of the executor
     /// \return pointer to new pipe
-    virtual std::unique_ptr<ExecutorPipe> createPipe() = 0;
+    virtual std::unique_ptr<ExecutorPipe> createPipe(
+            std::size_t capacity = 0) = 0;
+
+    /// \brief Creates a new relay for profiling the pipes of the executor
+    /// \return pointer to new relay, or \c null if the executor cannot
+    /// relay its pipes
+    ///
+    /// The default implementation returns \c null.
+    virtual std::unique_ptr<ExecutorPipeRelay> createPipeRelay();
+
+    /// \brief Creates a new buffer passing one pipe of the executor into
+    /// another, so that the writer of the first never waits on the reader of
+    /// the second
+    /// \param input pipe whose read end the buffer takes
+    /// \param output pipe whose write end the buffer takes
+    /// \return pointer to new buffer, or \c null if the executor cannot
+    /// buffer its pipes
+    ///
+    /// The default implementation returns \c null.
+    virtual std::unique_ptr<ExecutorPipeBuffer> createPipeBuffer(
+            std::shared_ptr<ExecutorPipe> input,
+            std::shared_ptr<ExecutorPipe> output);
+
+    /// \brief Creates a new fan duplicating one pipe of the executor into
+    /// several
+    /// \param input pipe whose read end the fan takes
+    /// \param outputs pipes whose write ends the fan takes
+    /// \return pointer to new fan, or \c null if the executor cannot fan
+    /// its pipes
+    ///
+    /// The default implementation returns \c null.
+    virtual std::unique_ptr<ExecutorFan> createFanOut(
+            std::shared_ptr<ExecutorPipe> input,
+            std::vector<std::shared_ptr<ExecutorPipe>> outputs);
+
+    /// \brief Creates a new fan merging several pipes of the executor into
+    /// one a line at a time
+    /// \param inputs pipes whose read ends the fan takes
+    /// \param output pipe whose write end the fan takes
+    /// \return pointer to new fan, or \c null if the executor cannot fan
+    /// its pipes
+    ///
+    /// The default implementation returns \c null.
+    virtual std::unique_ptr<ExecutorFan> createFanIn(
+            std::vector<std::shared_ptr<ExecutorPipe>> inputs,
+            std::shared_ptr<ExecutorPipe> output);
+
+    /// \brief Creates a new race passing on the output of one of several
+    /// commands of the executor
+    /// \param inputs pipes whose read ends the race takes, one per command
+    /// \param output stream to pass the chosen output to, or \c null for the
+    /// standard output of the shell
+    /// \return pointer to new race, or \c null if the executor cannot race
+    /// its commands
+    ///
+    /// The default implementation returns \c null.
+    virtual std::unique_ptr<ExecutorRace> createRace(
+            std::vector<std::shared_ptr<ExecutorPipe>> inputs,
+            std::shared_ptr<ExecutorStream> output);
 
     /// \brief Creates a new input file stream on the executor
     /// \param path path to open the stream on
@@ -81,23 +245,190 @@ public:
     virtual std::unique_ptr<ExecutorStream> createAppendFileStream(
             const std::string& path) = 0;
 
-    /// \brief Executes the abstract command given
+    /// \brief Creates a new stream on a copy of a descriptor of the shell,
+    /// as in "foo 2>&1" where the standard output is not redirected
+    /// \param file descriptor of the shell to copy
+    /// \param mode input/output mode of the stream
+    /// \return pointer to new stream, or \c null if the executor cannot copy
+    /// descriptors of the shell
+    ///
+    /// The default implementation returns \c null.
+    virtual std::unique_ptr<ExecutorStream> createDuplicateStream(int file,
+            ExecutorStream::Mode mode);
+
+    /// \brief Creates a new stream closing the descriptor it replaces, as in
+    /// "foo 2>&-"
+    /// \param mode input/output mode of the stream
+    /// \return pointer to new stream, or \c null if the executor cannot
+    /// close descriptors
+    ///
+    /// The default implementation returns \c null.
+    virtual std::unique_ptr<ExecutorStream> createClosedStream(
+            ExecutorStream::Mode mode);
+
+    /// \brief Creates a new input stream reading the given text, as in
+    /// "foo <<EOF" and "foo <<< bar"
+    /// \param text text to read
+    /// \return pointer to new stream, or \c null if the executor cannot
+    /// read text of the shell
+    ///
+    /// The default implementation returns \c null.
+    virtual std::unique_ptr<ExecutorStream> createDocumentStream(
+            const std::string& text);
+
+    /// \brief Places a stream on a descriptor of the shell itself, which
+    /// later commands inherit, as in "exec >> log"
+    /// \param slot descriptor of the shell to replace
+    /// \param stream stream to place on the descriptor
+    /// \return whether or not the descriptor was replaced, which it is not
+    /// if the executor does not execute commands on descriptors of the shell
+    ///
+    /// The default implementation returns \c false.
+    virtual bool redirectShell(int slot, ExecutorStream& stream);
+
+    /// \brief Executes the abstract command given with the standard streams
+    /// and environment of the shell
+    /// \param command command to execute
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the command
+    int execute(Command& command, WaitMode waitMode = WaitMode::Wait);
+
+    /// \brief Executes the abstract command given within a context
     /// \param command command to execute
+    /// \param context context to execute the command within
     /// \param waitMode wait mode to use when executing
     /// \return exit code of the command
-    virtual int execute(Command& command, WaitMode waitMode = WaitMode::Wait);
+    virtual int execute(Command& command, const ExecutionContext& context,
+            WaitMode waitMode = WaitMode::Wait);
+
+    /// \brief Executes the abstract command given in a subshell of the shell
+    /// \param command command to execute
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the command, or zero if not waiting
+    ///
+    /// Executing a composite command or builtin in a subshell in continue
+    /// mode returns as soon as the subshell has started, as for external
+    /// programs.  The default implementation executes the command within the
+    /// shell.
+    virtual int executeSubshell(Command& command,
+            const ExecutionContext& context,
+            WaitMode waitMode = WaitMode::Wait);
+
+    /// \brief Starts the abstract command given in continue mode, such as a
+    /// stage of a pipeline, without waiting for it to finish
+    /// \param command command to start
+    /// \param context context to execute the command within
+    ///
+    /// Commands other than external programs, such as scopes, nested pipes,
+    /// and builtins, would otherwise execute to completion within the shell
+    /// before returning, so they execute in subshells.
+    void start(Command& command, const ExecutionContext& context);
+
+    /// \brief Starts the abstract command given as a coprocess, whose
+    /// standard input and output are pipes to and from the shell that remain
+    /// open across commands
+    /// \param name name by which later redirections address the coprocess
+    /// \param command command to start
+    /// \param context context to execute the command within
+    /// \return whether or not the coprocess was started, which it is not if
+    /// a coprocess of the same name is running
+    bool startCoprocess(const std::string& name, Command& command,
+            const ExecutionContext& context);
+
+    /// \brief Gets a stream to or from a coprocess for a redirection
+    /// \param path path of the redirection, which addresses a coprocess as
+    /// "%name"
+    /// \param mode mode of the redirection; an input redirection reads the
+    /// standard output of the coprocess and an output redirection writes its
+    /// standard input
+    /// \return stream of the coprocess, or \c null if the path does not
+    /// address a coprocess
+    /// \throw std::runtime_error if no coprocess of the name is running
+    std::shared_ptr<ExecutorStream> coprocessStream(const std::string& path,
+            ExecutorStream::Mode mode) const;
+
+    /// \brief Closes the standard input of a coprocess, then waits for it to
+    /// finish
+    /// \param name name of the coprocess
+    /// \param status status of the finished coprocess
+    /// \return whether or not a coprocess of the name was running
+    bool closeCoprocess(const std::string& name, JobStatus& status);
+
+    /// \brief Gets the streams the shell holds to and from the running
+    /// coprocesses, which subshells must keep open for later redirections
+    /// \return streams of the coprocesses
+    std::vector<std::shared_ptr<ExecutorStream>> coprocessStreams() const;
+
+    /// \brief Gets the names of the running coprocesses
+    /// \return names in order
+    std::vector<std::string> coprocessNames() const;
+
+    /// \brief Executes the graph of sequential commands given
+    /// \param graph graph of commands to execute
+    /// \param context context to execute the commands within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the last command in the graph
+    ///
+    /// The default implementation executes the commands one at a time in
+    /// sequence order.
+    virtual int execute(DependencyGraph& graph,
+            const ExecutionContext& context,
+            WaitMode waitMode = WaitMode::Wait);
 
     /// \brief Executes the individual command given
     /// \param command command to execute
+    /// \param context context to execute the command within
     /// \param waitMode wait mode to use when executing
     /// \return exit code of the command
+    ///
+    /// Implementations must not modify state shared between executions, as
+    /// any number of threads may execute commands at once, each within its
+    /// own context.
     virtual int execute(ExecutableCommand& command,
+            const ExecutionContext& context,
             WaitMode waitMode = WaitMode::Wait) = 0;
 
+    /// \brief Waits for every job given to finish
+    /// \param jobs jobs to wait for, any of which may be \c null
+    /// \return status of each job, in the order given
+    ///
+    /// The default implementation waits for the jobs one at a time in the
+    /// order given; null jobs have a default status.
+    virtual std::vector<JobStatus> wait(
+            std::vector<std::unique_ptr<ExecutorJob>>& jobs);
+
+    /// \brief Prepares the individual command given for repeated execution
+    /// \param command command to prepare
+    ///
+    /// The default implementation does nothing.
+    virtual void prepare(ExecutableCommand& command);
+
 protected:
-    ExecutorStreamSet _streamSet; //!< Set of open streams to close
-    ExecutorStream* _inputStream{nullptr}; //!< Stream to replace stdin
-    ExecutorStream* _outputStream{nullptr}; //!< Stream to replace stdout
+    std::size_t _concurrency{1}; //!< Maximum number of concurrent commands
+    bool _isPipefail{false}; //!< Whether or not pipefail mode is enabled
+    std::size_t _pipeCapacity{0}; //!< Default capacity of pipes
+    bool _isPipeGrowth{false}; //!< Whether or not pipe growth is enabled
+    bool _isPipeProfile{false}; //!< Whether or not pipe profiling is enabled
+    /// \brief Memory limit of buffered pipes
+    std::size_t _pipeBufferLimit{defaultPipeBufferLimit};
+    std::string _cacheDirectory; //!< Directory of the result cache
+    std::size_t _cacheLimit{defaultCacheLimit}; //!< Budget of the cache
+
+    mutable std::mutex _pipeStatusMutex; //!< Guards the pipeline statuses
+    std::vector<JobStatus> _pipeStatus; //!< Statuses of the last pipeline
+
+private:
+    /// \brief Represents a process started with pipes to and from the shell
+    struct Coprocess
+    {
+        std::shared_ptr<ExecutorPipe> input; //!< Pipe to the standard input
+        std::shared_ptr<ExecutorPipe> output; //!< Pipe from the output
+        std::unique_ptr<ExecutorJob> job; //!< Job of the process
+    };
+
+    mutable std::mutex _coprocessesMutex; //!< Guards the coprocesses
+    std::map<std::string, Coprocess> _coprocesses; //!< Coprocesses by name
 };
 
 } // namespace rshell
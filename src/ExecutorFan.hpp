@@ -0,0 +1,47 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::ExecutorFan class
+
+#ifndef hpp_rshell_ExecutorFan
+#define hpp_rshell_ExecutorFan
+
+namespace rshell {
+
+/// \brief Abstract base class for fans moving data from one pipe of an
+/// executor to several or from several pipes to one
+///
+/// The fan holds the ends of its pipes that the stages joined by it do not
+/// use, and closes each once the data through it has ended.
+class ExecutorFan
+{
+public:
+    /// \brief Destructs the \ref ExecutorFan instance
+    ///
+    /// Finishes the fan if it has started.
+    virtual ~ExecutorFan();
+
+    /// \brief Starts moving data through the fan
+    virtual void start() = 0;
+
+    /// \brief Waits for the data through the fan to end
+    virtual void finish() = 0;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_ExecutorFan
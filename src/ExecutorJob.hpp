@@ -0,0 +1,58 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::ExecutorJob class
+
+#ifndef hpp_rshell_ExecutorJob
+#define hpp_rshell_ExecutorJob
+
+#include "JobStatus.hpp"
+#include <chrono>
+
+namespace rshell {
+
+/// \brief Abstract base class for commands started by an executor in
+/// continue mode that remain to be waited for
+class ExecutorJob
+{
+public:
+    /// \brief Exit code reported for a job stopped at its deadline
+    static constexpr int timeoutExitCode = 124;
+
+    /// \brief Time a job is given to exit once terminated at its deadline
+    /// before it is killed
+    static constexpr std::chrono::seconds terminationGrace{1};
+
+    /// \brief Destructs the \ref ExecutorJob instance
+    ///
+    /// A job destroyed before it has been waited for is abandoned.
+    virtual ~ExecutorJob();
+
+    /// \brief Waits for the job to finish
+    /// \return status of the finished job
+    virtual JobStatus wait() = 0;
+
+    /// \brief Asks the job to stop early
+    ///
+    /// The job must still be waited for.  The default implementation does
+    /// nothing, leaving the job to finish on its own.
+    virtual void cancel();
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_ExecutorJob
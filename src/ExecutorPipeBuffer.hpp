@@ -0,0 +1,49 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::ExecutorPipeBuffer
+/// class
+
+#ifndef hpp_rshell_ExecutorPipeBuffer
+#define hpp_rshell_ExecutorPipeBuffer
+
+namespace rshell {
+
+/// \brief Abstract base class for buffers passing data from one pipe of an
+/// executor to another, absorbing whatever the reader is not yet ready for
+///
+/// The buffer holds the read end of the first pipe and the write end of the
+/// second, so the writer of the first never waits on the reader of the
+/// second.
+class ExecutorPipeBuffer
+{
+public:
+    /// \brief Destructs the \ref ExecutorPipeBuffer instance
+    ///
+    /// Finishes the buffer if it has started.
+    virtual ~ExecutorPipeBuffer();
+
+    /// \brief Starts passing data through the buffer
+    virtual void start() = 0;
+
+    /// \brief Waits for the data through the buffer to end
+    virtual void finish() = 0;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_ExecutorPipeBuffer
@@ -0,0 +1,63 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::ExecutorPipeRelay class
+
+#ifndef hpp_rshell_ExecutorPipeRelay
+#define hpp_rshell_ExecutorPipeRelay
+
+#include "PipeProfile.hpp"
+#include <memory>
+#include <vector>
+
+namespace rshell {
+
+// Forward declarations
+class ExecutorPipe;
+
+/// \brief Abstract base class for relays passing data between pairs of pipes
+/// of an executor while measuring the traffic through them
+///
+/// A relay splits each pipe of a pipeline in two, so that it observes every
+/// byte passing from one stage to the next and how long each stage waits on
+/// the other.
+class ExecutorPipeRelay
+{
+public:
+    /// \brief Destructs the \ref ExecutorPipeRelay instance
+    virtual ~ExecutorPipeRelay();
+
+    /// \brief Adds a pair of pipes to the relay, which takes ownership of the
+    /// read end of the first and the write end of the second
+    /// \param input pipe written by the earlier stage
+    /// \param output pipe read by the later stage
+    ///
+    /// Pairs may only be added before the relay starts.
+    virtual void add(std::shared_ptr<ExecutorPipe> input,
+            std::shared_ptr<ExecutorPipe> output) = 0;
+
+    /// \brief Starts relaying data between each pair of pipes
+    virtual void start() = 0;
+
+    /// \brief Waits for every pair of pipes to reach the end of its data
+    /// \return profile of each pair, in the order added
+    virtual std::vector<PipeProfile> finish() = 0;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_ExecutorPipeRelay
@@ -0,0 +1,56 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::ExecutorRace class
+
+#ifndef hpp_rshell_ExecutorRace
+#define hpp_rshell_ExecutorRace
+
+#include <cstddef>
+
+namespace rshell {
+
+/// \brief Abstract base class for races collecting the output of several
+/// commands of an executor and passing on that of one of them
+///
+/// The race holds the read ends of one pipe per command, and holds their
+/// data back until the command whose output is to be kept is known.
+class ExecutorRace
+{
+public:
+    /// \brief Destructs the \ref ExecutorRace instance
+    ///
+    /// Finishes the race if it has started.
+    virtual ~ExecutorRace();
+
+    /// \brief Starts collecting the data through the race
+    virtual void start() = 0;
+
+    /// \brief Chooses the pipe whose data is passed on
+    /// \param index index of the pipe
+    ///
+    /// The data of every other pipe is discarded, and the pipes closed.
+    virtual void commit(std::size_t index) = 0;
+
+    /// \brief Waits for the data of the chosen pipe to end, or discards the
+    /// data of every pipe if none was chosen
+    virtual void finish() = 0;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_ExecutorRace
@@ -22,9 +22,6 @@
 
 namespace rshell {
 
-// Forward declarations
-class Executor;
-
 /// \brief Abstract base class for individual input/output streams within
 /// executors
 class ExecutorStream
@@ -44,9 +41,10 @@ public:
     /// \return input/output mode
     Mode mode() const noexcept { return _mode; }
 
-    /// \brief Activates the stream within the given executor
-    /// \param executor executor to activate on
-    virtual void activate(Executor& executor) = 0;
+    /// \brief Activates the stream on the given descriptor of the calling
+    /// process
+    /// \param slot descriptor to replace with the stream
+    virtual void activate(int slot) = 0;
 
     /// \brief Closes the stream
     virtual void close() = 0;
@@ -1,69 +0,0 @@
-// rshell
-// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
-//
-// Permission to use, copy, modify, and/or distribute this software for any
-// purpose with or without fee is hereby granted, provided that the above
-// copyright notice and this permission notice appear in all copies.
-//
-// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
-// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
-// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
-// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
-// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
-// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
-// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
-// SOFTWARE.
-
-/// \file
-/// \brief Contains the interface to the \ref rshell::ExecutorStreamSet class
-
-#ifndef hpp_rshell_ExecutorStreamSet
-#define hpp_rshell_ExecutorStreamSet
-
-#include <set>
-
-namespace rshell {
-
-// Forward declarations
-class ExecutorPipe;
-class ExecutorStream;
-
-/// \brief Container wrapper for automating the closure of executor streams
-class ExecutorStreamSet
-{
-public:
-    /// \brief Gets a reference to the stream container
-    /// \return reference to the stream container
-    const std::set<ExecutorStream*>& streams() const noexcept
-    { return _streams; }
-
-    /// \brief Inserts a pipe into the set
-    /// \param pipe pipe to insert
-    ///
-    /// Inserts both the input and output streams.
-    void insert(ExecutorPipe& pipe);
-
-    /// \brief Inserts a stream into the set
-    /// \param stream stream to insert
-    void insert(ExecutorStream& stream);
-
-    /// \brief Erases a pipe from the set
-    /// \param pipe pipe to erase
-    ///
-    /// Erases both the input and output pipes.
-    void erase(ExecutorPipe& pipe);
-
-    /// \brief Erases a stream from the set
-    /// \param stream stream to erase
-    void erase(ExecutorStream& stream);
-
-    /// \brief Closes all streams in the set
-    void close();
-
-private:
-    std::set<ExecutorStream*> _streams; //!< Stream container
-};
-
-} // namespace rshell
-
-#endif // hpp_rshell_ExecutorStreamSet
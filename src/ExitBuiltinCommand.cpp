@@ -24,7 +24,8 @@ namespace rshell {
 
 ExitBuiltinCommand::~ExitBuiltinCommand() = default;
 
-int ExitBuiltinCommand::execute(Executor& executor, WaitMode waitMode)
+int ExitBuiltinCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
 {
     int exitCode = 0;
 
@@ -48,4 +49,14 @@ int ExitBuiltinCommand::execute(Executor& executor, WaitMode waitMode)
     throw ExitException{exitCode};
 }
 
+void ExitBuiltinCommand::prepare(Executor& executor)
+{
+    // Builtins execute within the shell and require no preparation
+}
+
+bool ExitBuiltinCommand::isExternal() const
+{
+    return false;
+}
+
 } // namespace rshell
@@ -37,9 +37,21 @@ public:
 
     /// \brief Executes the command using the given executor
     /// \param executor executor to use for execution
+    /// \param context context to execute the command within
     /// \param waitMode wait mode to use when executing
     /// \return exit code of the command
-    virtual int execute(Executor& executor, WaitMode waitMode) override;
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Prepares the command for repeated execution using the given
+    /// executor
+    /// \param executor executor to prepare with
+    virtual void prepare(Executor& executor) override;
+
+    /// \brief Gets a value indicating whether or not the command only starts
+    /// an external program
+    /// \return \c false, as builtins execute within the shell
+    virtual bool isExternal() const override;
 };
 
 } // namespace rshell
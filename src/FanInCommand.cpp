@@ -0,0 +1,142 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "FanInCommand.hpp"
+#include "Executor.hpp"
+#include "ExecutorFan.hpp"
+#include "ExecutorJob.hpp"
+#include "ExecutorPipe.hpp"
+#include "ExecutorStream.hpp"
+#include "SequentialCommand.hpp"
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using namespace rshell;
+
+/// \brief Lists the commands joined to one end of a fan
+/// \param command scope of commands, or a single command
+/// \return each command of the scope, or the single command
+std::vector<Command*> partsOf(Command& command)
+{
+    std::vector<Command*> parts;
+    auto scope = dynamic_cast<SequentialCommand*>(&command);
+    if (scope == nullptr) {
+        parts.push_back(&command);
+        return parts;
+    }
+
+    for (auto&& part : scope->sequence) {
+        if (part != nullptr) {
+            parts.push_back(part.get());
+        }
+    }
+
+    return parts;
+}
+
+}
+
+namespace rshell {
+
+FanInCommand::~FanInCommand() = default;
+
+int FanInCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode)
+{
+    if (primary == nullptr || secondary == nullptr) {
+        throw std::runtime_error{"incomplete FanInCommand"};
+    }
+
+    // Each command of a scope writes the input, as in "(a; b) *| c"
+    auto writers = partsOf(*primary);
+
+    std::vector<std::shared_ptr<ExecutorPipe>> inputs;
+    for (std::size_t i = 0; i < writers.size(); ++i) {
+        inputs.emplace_back(executor.createPipe());
+    }
+
+    std::shared_ptr<ExecutorPipe> output{executor.createPipe()};
+    auto fan = executor.createFanIn(inputs, output);
+    if (fan == nullptr) {
+        throw std::runtime_error{"executor cannot fan in pipes"};
+    }
+
+    // Start the fan, then every command in continue mode, each adopting its
+    // job into its place in the job list, and wait until each has
+    // terminated.  The fan starts first, as a command executing within the
+    // shell may need its data before returning.  The commands hold their
+    // own copies of the ends they use, so the shell closes them, leaving
+    // the others to the fan
+    std::vector<std::unique_ptr<ExecutorJob>> jobs(writers.size() + 1);
+    auto adopt = [&](std::size_t index)
+    {
+        auto slot = &jobs[index];
+        return context.withJobHandler([slot](std::unique_ptr<ExecutorJob> job)
+        {
+            *slot = std::move(job);
+        });
+    };
+
+    fan->start();
+    try {
+        for (std::size_t i = 0; i < writers.size(); ++i) {
+            auto& input = inputs[i];
+            executor.start(*writers[i], adopt(i).withStream(STDOUT_FILENO,
+                    std::shared_ptr<ExecutorStream>{input,
+                    &input->outputStream()}));
+            input->outputStream().close();
+        }
+
+        executor.start(*secondary, adopt(writers.size()).withStream(
+                    STDIN_FILENO, std::shared_ptr<ExecutorStream>{output,
+                    &output->inputStream()}));
+        output->inputStream().close();
+    }
+    catch (...) {
+        // The fan must see the data end before it can be finished
+        for (auto&& input : inputs) {
+            input->outputStream().close();
+        }
+
+        output->inputStream().close();
+        throw;
+    }
+
+    auto statuses = executor.wait(jobs);
+    fan->finish();
+
+    auto exitCode = executor.pipeExitCode(statuses);
+    executor.setPipeStatus(std::move(statuses));
+    return exitCode;
+}
+
+void FanInCommand::prepare(Executor& executor)
+{
+    if (primary != nullptr) {
+        primary->prepare(executor);
+    }
+
+    if (secondary != nullptr) {
+        secondary->prepare(executor);
+    }
+}
+
+} // namespace rshell
@@ -0,0 +1,58 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::FanInCommand class
+
+#ifndef hpp_rshell_FanInCommand
+#define hpp_rshell_FanInCommand
+
+#include "Command.hpp"
+#include <memory>
+
+namespace rshell {
+
+/// \brief Command to be executed with a fan merging the output of each
+/// command of the primary scope a line at a time into the input of the
+/// secondary command
+class FanInCommand : public Command
+{
+public:
+    /// \brief Scope of commands whose output to merge, or a single command
+    std::unique_ptr<Command> primary;
+
+    std::unique_ptr<Command> secondary; //!< Command reading the merged output
+
+    /// \brief Destructs the \ref FanInCommand instance
+    virtual ~FanInCommand();
+
+    /// \brief Executes the command using the given executor
+    /// \param executor executor to use for execution
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the command
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Prepares the command for repeated execution using the given
+    /// executor
+    /// \param executor executor to prepare with
+    virtual void prepare(Executor& executor) override;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_FanInCommand
@@ -0,0 +1,202 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "FanOutCommand.hpp"
+#include "Executor.hpp"
+#include "ExecutorFan.hpp"
+#include "ExecutorJob.hpp"
+#include "ExecutorPipe.hpp"
+#include "ExecutorStream.hpp"
+#include "FanInCommand.hpp"
+#include "SequentialCommand.hpp"
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using namespace rshell;
+
+/// \brief Lists the commands joined to one end of a fan
+/// \param command scope of commands, or a single command
+/// \return each command of the scope, or the single command
+std::vector<Command*> partsOf(Command& command)
+{
+    std::vector<Command*> parts;
+    auto scope = dynamic_cast<SequentialCommand*>(&command);
+    if (scope == nullptr) {
+        parts.push_back(&command);
+        return parts;
+    }
+
+    for (auto&& part : scope->sequence) {
+        if (part != nullptr) {
+            parts.push_back(part.get());
+        }
+    }
+
+    return parts;
+}
+
+}
+
+namespace rshell {
+
+FanOutCommand::~FanOutCommand() = default;
+
+int FanOutCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode)
+{
+    if (primary == nullptr || secondary == nullptr) {
+        throw std::runtime_error{"incomplete FanOutCommand"};
+    }
+
+    // Each command of a scope reads the output, as in "a |* (b; c)".  Should
+    // the scope be merged again, as in "a |* (b; c) *| d", each command also
+    // writes the input of the merge
+    auto merge = dynamic_cast<FanInCommand*>(secondary.get());
+    if (merge != nullptr &&
+            (merge->primary == nullptr || merge->secondary == nullptr)) {
+        throw std::runtime_error{"incomplete FanInCommand"};
+    }
+
+    auto readers = merge != nullptr ? partsOf(*merge->primary) :
+        partsOf(*secondary);
+
+    std::shared_ptr<ExecutorPipe> input{executor.createPipe()};
+    std::vector<std::shared_ptr<ExecutorPipe>> outputs;
+    std::vector<std::shared_ptr<ExecutorPipe>> merged;
+    for (std::size_t i = 0; i < readers.size(); ++i) {
+        outputs.emplace_back(executor.createPipe());
+        if (merge != nullptr) {
+            merged.emplace_back(executor.createPipe());
+        }
+    }
+
+    auto fan = executor.createFanOut(input, outputs);
+    if (fan == nullptr) {
+        throw std::runtime_error{"executor cannot fan out pipes"};
+    }
+
+    std::shared_ptr<ExecutorPipe> mergedOutput;
+    std::unique_ptr<ExecutorFan> mergeFan;
+    if (merge != nullptr) {
+        mergedOutput = executor.createPipe();
+        mergeFan = executor.createFanIn(merged, mergedOutput);
+        if (mergeFan == nullptr) {
+            throw std::runtime_error{"executor cannot fan in pipes"};
+        }
+    }
+
+    // Start the fans, then every command in continue mode, each adopting
+    // its job into its place in the job list, and wait until each has
+    // terminated.  The fans start first, as a command executing within the
+    // shell may need their data before returning.  The commands hold their
+    // own copies of the ends they use, so the shell closes them, leaving
+    // the others to the fans
+    std::vector<std::unique_ptr<ExecutorJob>> jobs(readers.size() +
+            (merge != nullptr ? 2 : 1));
+    auto adopt = [&](std::size_t index)
+    {
+        auto slot = &jobs[index];
+        return context.withJobHandler([slot](std::unique_ptr<ExecutorJob> job)
+        {
+            *slot = std::move(job);
+        });
+    };
+
+    auto closeAll = [&]
+    {
+        input->outputStream().close();
+        for (auto&& output : outputs) {
+            output->inputStream().close();
+        }
+
+        for (auto&& output : merged) {
+            output->outputStream().close();
+        }
+
+        if (mergedOutput != nullptr) {
+            mergedOutput->inputStream().close();
+        }
+    };
+
+    fan->start();
+    if (mergeFan != nullptr) {
+        mergeFan->start();
+    }
+
+    try {
+        executor.start(*primary, adopt(0).withStream(STDOUT_FILENO,
+                std::shared_ptr<ExecutorStream>{input,
+                &input->outputStream()}));
+        input->outputStream().close();
+        for (std::size_t i = 0; i < readers.size(); ++i) {
+            auto& output = outputs[i];
+            auto reader = adopt(i + 1).withStream(STDIN_FILENO,
+                    std::shared_ptr<ExecutorStream>{output,
+                    &output->inputStream()});
+            if (merge != nullptr) {
+                reader = reader.withStream(STDOUT_FILENO,
+                        std::shared_ptr<ExecutorStream>{merged[i],
+                        &merged[i]->outputStream()});
+            }
+
+            executor.start(*readers[i], reader);
+            output->inputStream().close();
+            if (merge != nullptr) {
+                merged[i]->outputStream().close();
+            }
+        }
+
+        if (merge != nullptr) {
+            executor.start(*merge->secondary, adopt(readers.size() + 1)
+                    .withStream(STDIN_FILENO, std::shared_ptr<ExecutorStream>{
+                    mergedOutput, &mergedOutput->inputStream()}));
+        }
+    }
+    catch (...) {
+        // The fans must see the data end before they can be finished
+        closeAll();
+        throw;
+    }
+
+    closeAll();
+    auto statuses = executor.wait(jobs);
+    fan->finish();
+    if (mergeFan != nullptr) {
+        mergeFan->finish();
+    }
+
+    auto exitCode = executor.pipeExitCode(statuses);
+    executor.setPipeStatus(std::move(statuses));
+    return exitCode;
+}
+
+void FanOutCommand::prepare(Executor& executor)
+{
+    if (primary != nullptr) {
+        primary->prepare(executor);
+    }
+
+    if (secondary != nullptr) {
+        secondary->prepare(executor);
+    }
+}
+
+} // namespace rshell
@@ -0,0 +1,53 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "HereDocumentCommand.hpp"
+#include "Executor.hpp"
+#include "ExecutorStream.hpp"
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <unistd.h>
+
+namespace rshell {
+
+HereDocumentCommand::HereDocumentCommand()
+    : RedirectionCommand{STDIN_FILENO}
+{
+}
+
+HereDocumentCommand::~HereDocumentCommand() = default;
+
+ExecutionContext HereDocumentCommand::redirect(Executor& executor,
+        const ExecutionContext& context) const
+{
+    if (!hasText) {
+        throw std::runtime_error{"incomplete HereDocumentCommand"};
+    }
+
+    // The text is stored anew on every execution, so that each reads it
+    // from the beginning
+    std::shared_ptr<ExecutorStream> stream{
+        executor.createDocumentStream(isString ? text + '\n' : text)};
+    if (stream == nullptr) {
+        throw std::runtime_error{"here-documents are not supported on this "
+            "executor"};
+    }
+
+    return context.withStream(slot, std::move(stream));
+}
+
+} // namespace rshell
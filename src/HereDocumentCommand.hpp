@@ -0,0 +1,60 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::HereDocumentCommand
+/// class
+
+#ifndef hpp_rshell_HereDocumentCommand
+#define hpp_rshell_HereDocumentCommand
+
+#include "RedirectionCommand.hpp"
+#include <string>
+
+namespace rshell {
+
+/// \brief Command to be executed with an input descriptor reading text
+/// given within the command, as in "foo <<EOF" and "foo <<< bar"
+class HereDocumentCommand : public RedirectionCommand
+{
+public:
+    std::string text; //!< Text to read
+    bool hasText{false}; //!< Whether or not the text has been given
+
+    /// \brief Whether or not the text is a here-string, as in "foo <<< bar",
+    /// which is read with a line feed appended
+    bool isString{false};
+
+    /// \brief Constructs a new instance of the \ref HereDocumentCommand
+    /// class replacing the standard input
+    HereDocumentCommand();
+
+    /// \brief Destructs the \ref HereDocumentCommand instance
+    virtual ~HereDocumentCommand();
+
+    /// \brief Applies the redirection alone to a context
+    /// \param executor executor to create streams on
+    /// \param context context to redirect
+    /// \return redirected context
+    /// \throw std::runtime_error if the executor cannot read text of the
+    /// shell
+    virtual ExecutionContext redirect(Executor& executor,
+            const ExecutionContext& context) const override;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_HereDocumentCommand
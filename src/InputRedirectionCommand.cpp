@@ -17,30 +17,37 @@
 #include "InputRedirectionCommand.hpp"
 #include "Executor.hpp"
 #include "ExecutorStream.hpp"
+#include <memory>
 #include <stdexcept>
+#include <utility>
+#include <unistd.h>
 
 namespace rshell {
 
+InputRedirectionCommand::InputRedirectionCommand()
+    : RedirectionCommand{STDIN_FILENO}
+{
+}
+
 InputRedirectionCommand::~InputRedirectionCommand() = default;
 
-int InputRedirectionCommand::execute(Executor& executor, WaitMode waitMode)
+ExecutionContext InputRedirectionCommand::redirect(Executor& executor,
+        const ExecutionContext& context) const
 {
-    if (primary == nullptr || path.empty()) {
+    if (path.empty()) {
         throw std::runtime_error{"incomplete InputRedirectionCommand"};
     }
 
-    // Create the input file stream
-    auto stream = executor.createInputFileStream(path);
-    executor.streamSet().insert(*stream.get());
-
-    // Make the stream the input stream for the executor and execute the
-    // command
-    executor.setInputStream(stream.get());
-    auto exitCode = primary->execute(executor, waitMode);
-    executor.setInputStream(nullptr);
+    // Replace the descriptor with the file stream, or the stream of the
+    // coprocess the path addresses.  The stream is closed once the last
+    // context referring to it is destroyed
+    auto stream = executor.coprocessStream(path,
+            ExecutorStream::Mode::Input);
+    if (stream == nullptr) {
+        stream = executor.createInputFileStream(path);
+    }
 
-    executor.streamSet().erase(*stream.get());
-    return exitCode;
+    return context.withStream(slot, std::move(stream));
 }
 
 } // namespace rshell
@@ -21,27 +21,30 @@
 #ifndef hpp_rshell_InputRedirectionCommand
 #define hpp_rshell_InputRedirectionCommand
 
-#include "Command.hpp"
-#include <memory>
+#include "RedirectionCommand.hpp"
 #include <string>
 
 namespace rshell {
 
-/// \brief Command to be executed with a replaced standard input
-class InputRedirectionCommand : public Command
+/// \brief Command to be executed with a replaced input descriptor
+class InputRedirectionCommand : public RedirectionCommand
 {
 public:
-    std::unique_ptr<Command> primary; //!< Primary command to execute
     std::string path; //!< Path to input from
 
+    /// \brief Constructs a new instance of the \ref InputRedirectionCommand
+    /// class replacing the standard input
+    InputRedirectionCommand();
+
     /// \brief Destructs the \ref InputRedirectionCommand instance
     virtual ~InputRedirectionCommand();
 
-    /// \brief Executes the command using the given executor
-    /// \param executor executor to use for execution
-    /// \param waitMode wait mode to use when executing
-    /// \return exit code of the command
-    virtual int execute(Executor& executor, WaitMode waitMode) override;
+    /// \brief Applies the redirection alone to a context
+    /// \param executor executor to create streams on
+    /// \param context context to redirect
+    /// \return redirected context
+    virtual ExecutionContext redirect(Executor& executor,
+            const ExecutionContext& context) const override;
 };
 
 } // namespace rshell
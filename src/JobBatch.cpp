@@ -0,0 +1,416 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "JobBatch.hpp"
+#include "Executor.hpp"
+#include "ExitException.hpp"
+#include "utility/read_write_all.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using utility::read_all;
+using utility::write_all;
+
+namespace {
+
+/// \brief Header written by a worker ahead of the captured output of a job
+struct JobResult
+{
+    std::uint32_t index; //!< Index of the job within the batch
+    std::int32_t exitCode; //!< Exit code of the job
+    std::uint64_t outputSize; //!< Size of the captured standard output
+    std::uint64_t errorSize; //!< Size of the captured standard error
+};
+
+/// \brief State of a worker process, as seen by the shell
+struct Worker
+{
+    pid_t pid; //!< Process identifier of the worker
+    int input; //!< Descriptor the job indices are written to
+    int output; //!< Descriptor the job results are read from
+    std::size_t job; //!< Index of the job being executed
+    bool isBusy; //!< Whether or not a job is being executed
+};
+
+/// \brief State of a job, as seen by the shell
+struct JobState
+{
+    bool isFinished{false}; //!< Whether or not the job has finished
+    int exitCode{0}; //!< Exit code of the job
+    std::FILE* output{nullptr}; //!< Held standard output, if any
+    std::FILE* error{nullptr}; //!< Held standard error, if any
+};
+
+/// \brief Copies the given number of bytes between descriptors
+/// \param from descriptor to read from
+/// \param to descriptor to write to
+/// \param size number of bytes to copy
+/// \return whether or not all of the bytes were read
+///
+/// Failures to write are ignored so that the source is always drained.
+bool copy(int from, int to, std::uint64_t size)
+{
+    char buffer[4096];
+    while (size > 0) {
+        auto count = std::min<std::uint64_t>(size, sizeof buffer);
+        if (!read_all(from, buffer, count)) {
+            return false;
+        }
+
+        write_all(to, buffer, count);
+        size -= count;
+    }
+
+    return true;
+}
+
+/// \brief Gets the size of a captured output file and rewinds it
+/// \param file captured output file
+/// \return size of the file
+std::uint64_t sizeOf(std::FILE* file)
+{
+    auto size = ::lseek(fileno(file), 0, SEEK_END);
+    ::lseek(fileno(file), 0, SEEK_SET);
+    return size < 0 ? 0 : size;
+}
+
+/// \brief Writes a held output file to a descriptor and closes it
+/// \param file held output file, which may be null
+/// \param slot descriptor to write to
+void release(std::FILE*& file, int slot)
+{
+    if (file != nullptr) {
+        auto size = sizeOf(file);
+        copy(fileno(file), slot, size);
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+}
+
+namespace rshell {
+
+JobBatch::JobBatch(Executor& executor)
+    : _executor(executor)
+{
+}
+
+JobBatch::~JobBatch() = default;
+
+void JobBatch::setHaltsOnFailure(bool haltsOnFailure)
+{
+    _haltsOnFailure = haltsOnFailure;
+}
+
+void JobBatch::insert(std::unique_ptr<Command> command)
+{
+    _jobs.push_back(std::move(command));
+}
+
+int JobBatch::run(std::size_t concurrency)
+{
+    if (_jobs.empty()) {
+        return 0;
+    }
+
+    // Flush the standard streams so that their buffered contents are not
+    // duplicated into the workers
+    std::cout.flush();
+    std::cerr.flush();
+
+    // Start the workers, each with a pipe to receive job indices and a pipe
+    // to send job results.  Each worker must close the descriptors of the
+    // workers started before it, or those workers would never observe the
+    // end of their input
+    std::vector<Worker> workers;
+    concurrency = std::max<std::size_t>(1,
+            std::min(concurrency, _jobs.size()));
+    while (workers.size() < concurrency) {
+        int input[2];
+        int output[2];
+        if (::pipe(input) != 0) {
+            std::perror("rshell: unable to pipe");
+            break;
+        }
+
+        if (::pipe(output) != 0) {
+            std::perror("rshell: unable to pipe");
+            ::close(input[0]);
+            ::close(input[1]);
+            break;
+        }
+
+        auto pid = fork();
+        if (pid == 0) {
+            for (auto&& worker : workers) {
+                ::close(worker.input);
+                ::close(worker.output);
+            }
+
+            ::close(input[1]);
+            ::close(output[0]);
+            work(input[0], output[1]);
+        }
+
+        ::close(input[0]);
+        ::close(output[1]);
+        if (pid < 0) {
+            std::perror("rshell: fork failed");
+            ::close(input[1]);
+            ::close(output[0]);
+            break;
+        }
+
+        workers.push_back(Worker{pid, input[1], output[0], 0, false});
+    }
+
+    if (workers.empty()) {
+        throw std::runtime_error{"unable to start workers"};
+    }
+
+    std::vector<JobState> jobs(_jobs.size());
+    std::size_t dispatched = 0;
+    std::size_t written = 0;
+    std::size_t failed = 0;
+    auto isHalted = false;
+
+    // Dispatches the next job to a worker, or closes the input of the worker
+    // if there are no more jobs to dispatch, which causes it to exit
+    auto dispatch = [&](Worker& worker)
+    {
+        worker.isBusy = false;
+        if (!isHalted && dispatched < jobs.size()) {
+            std::uint32_t index = dispatched;
+            if (write_all(worker.input, &index, sizeof index)) {
+                worker.job = dispatched++;
+                worker.isBusy = true;
+                return;
+            }
+        }
+
+        if (worker.input >= 0) {
+            ::close(worker.input);
+            worker.input = -1;
+        }
+    };
+
+    // Records the result of a job, failing it if the worker died
+    auto finish = [&](Worker& worker)
+    {
+        JobResult result;
+        if (!read_all(worker.output, &result, sizeof result) ||
+                result.index != worker.job) {
+            std::cerr << "rshell: error: worker " << worker.pid
+                << " exited unexpectedly\n";
+            jobs[worker.job].isFinished = true;
+            jobs[worker.job].exitCode = 1;
+            ::close(worker.input);
+            worker.input = -1;
+            worker.isBusy = false;
+            return false;
+        }
+
+        // The output of the next job to be written goes straight to the
+        // standard streams.  The output of any other job is held until
+        // every earlier job has been written
+        auto& job = jobs[result.index];
+        if (result.index == written) {
+            copy(worker.output, STDOUT_FILENO, result.outputSize);
+            copy(worker.output, STDERR_FILENO, result.errorSize);
+        }
+        else {
+            job.output = std::tmpfile();
+            job.error = std::tmpfile();
+            if (job.output == nullptr || job.error == nullptr) {
+                std::perror("rshell: unable to create capture file");
+                throw std::runtime_error{"unable to create capture file"};
+            }
+
+            copy(worker.output, fileno(job.output), result.outputSize);
+            copy(worker.output, fileno(job.error), result.errorSize);
+        }
+
+        job.isFinished = true;
+        job.exitCode = result.exitCode;
+        return true;
+    };
+
+    for (auto&& worker : workers) {
+        dispatch(worker);
+    }
+
+    std::vector<pollfd> descriptors;
+    while (true) {
+        descriptors.clear();
+        for (auto&& worker : workers) {
+            if (worker.isBusy) {
+                descriptors.push_back(pollfd{worker.output, POLLIN, 0});
+            }
+        }
+
+        if (descriptors.empty()) {
+            break;
+        }
+
+        auto count = ::poll(descriptors.data(), descriptors.size(), -1);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+
+        // The results of the busy workers can no longer be collected, so
+        // their jobs fail and the remaining jobs are skipped
+        if (count < 0) {
+            std::perror("rshell: unable to poll workers");
+            for (auto&& worker : workers) {
+                if (worker.isBusy) {
+                    jobs[worker.job].isFinished = true;
+                    jobs[worker.job].exitCode = 1;
+                    worker.isBusy = false;
+                    ++failed;
+                }
+            }
+
+            break;
+        }
+
+        for (auto&& descriptor : descriptors) {
+            if (descriptor.revents == 0) {
+                continue;
+            }
+
+            auto worker = std::find_if(std::begin(workers), std::end(workers),
+                    [&](const Worker& w) { return w.output == descriptor.fd; });
+            auto job = worker->job;
+            auto isAlive = finish(*worker);
+
+            if (jobs[job].exitCode != 0) {
+                ++failed;
+                isHalted = isHalted || _haltsOnFailure;
+            }
+
+            if (isAlive) {
+                dispatch(*worker);
+            }
+
+            // Write the held output of the finished jobs at the front of the
+            // batch, stopping at the first unfinished job
+            while (written < jobs.size() && jobs[written].isFinished) {
+                release(jobs[written].output, STDOUT_FILENO);
+                release(jobs[written].error, STDERR_FILENO);
+                ++written;
+            }
+        }
+    }
+
+    for (auto&& worker : workers) {
+        if (worker.input >= 0) {
+            ::close(worker.input);
+        }
+
+        ::close(worker.output);
+
+        int status;
+        waitpid(worker.pid, &status, 0);
+    }
+
+    // Summarize the failures once all of the output has been written
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        release(jobs[i].output, STDOUT_FILENO);
+        release(jobs[i].error, STDERR_FILENO);
+        if (jobs[i].isFinished && jobs[i].exitCode != 0) {
+            std::cerr << "rshell: job " << i + 1 << " failed with exit code "
+                << jobs[i].exitCode << '\n';
+        }
+    }
+
+    auto skipped = jobs.size() - dispatched;
+    if (failed > 0 || skipped > 0) {
+        std::cerr << "rshell: " << failed << " of " << jobs.size()
+            << " jobs failed";
+        if (skipped > 0) {
+            std::cerr << ", " << skipped << " skipped";
+        }
+
+        std::cerr << '\n';
+    }
+
+    return std::min<std::size_t>(failed + skipped, 101);
+}
+
+void JobBatch::work(int input, int output)
+{
+    // Jobs do not receive the standard input of the shell
+    auto null = ::open("/dev/null", O_RDONLY);
+    ::dup2(null, STDIN_FILENO);
+    ::close(null);
+
+    std::uint32_t index;
+    while (read_all(input, &index, sizeof index) && index < _jobs.size()) {
+        // Capture the output of the job, including that of builtins, by
+        // replacing the standard streams of the worker itself
+        auto jobOutput = std::tmpfile();
+        auto jobError = std::tmpfile();
+        if (jobOutput == nullptr || jobError == nullptr) {
+            break;
+        }
+
+        ::dup2(fileno(jobOutput), STDOUT_FILENO);
+        ::dup2(fileno(jobError), STDERR_FILENO);
+
+        int exitCode;
+        try {
+            exitCode = _executor.execute(*_jobs[index]);
+        }
+        catch (const ExitException& e) {
+            exitCode = e.exitCode();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "rshell: error: " << e.what() << '\n';
+            exitCode = 1;
+        }
+
+        std::cout.flush();
+        std::cerr.flush();
+
+        JobResult result{index, exitCode, sizeOf(jobOutput),
+            sizeOf(jobError)};
+        auto isSent = write_all(output, &result, sizeof result)
+            && copy(fileno(jobOutput), output, result.outputSize)
+            && copy(fileno(jobError), output, result.errorSize);
+
+        std::fclose(jobOutput);
+        std::fclose(jobError);
+        if (!isSent) {
+            break;
+        }
+    }
+
+    _exit(0);
+}
+
+} // namespace rshell
@@ -0,0 +1,96 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::JobBatch class
+
+#ifndef hpp_rshell_JobBatch
+#define hpp_rshell_JobBatch
+
+#include "Command.hpp"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace rshell {
+
+// Forward declarations
+class Executor;
+
+/// \brief Executes a batch of independent commands on a fixed number of
+/// concurrent worker executors
+///
+/// Each worker is a forked copy of the shell with its own executor that
+/// executes one job after another as they are dispatched to it, so the
+/// batch costs one extra process per worker rather than one per job.  The
+/// output of each job is captured by its worker and written by the shell in
+/// job order once every earlier job has been written.
+class JobBatch
+{
+public:
+    /// \brief Constructs a new instance of the \ref JobBatch class on the
+    /// given executor
+    /// \param executor executor to copy into each worker
+    explicit JobBatch(Executor& executor);
+
+    /// \brief Destructs the \ref JobBatch instance
+    ~JobBatch();
+
+    /// \brief Gets the number of jobs in the batch
+    /// \return number of jobs
+    std::size_t size() const noexcept { return _jobs.size(); }
+
+    /// \brief Gets a value indicating whether or not the batch stops
+    /// dispatching jobs after the first failure
+    /// \return whether or not the batch halts on failure
+    bool haltsOnFailure() const noexcept { return _haltsOnFailure; }
+
+    /// \brief Sets whether or not the batch stops dispatching jobs after the
+    /// first failure
+    /// \param haltsOnFailure whether or not the batch halts on failure
+    ///
+    /// Jobs that are already executing when the failure is observed are
+    /// allowed to finish.
+    void setHaltsOnFailure(bool haltsOnFailure);
+
+    /// \brief Appends a job to the batch
+    /// \param command command to execute as the job
+    void insert(std::unique_ptr<Command> command);
+
+    /// \brief Executes the jobs in the batch
+    /// \param concurrency number of worker executors
+    /// \return zero if every job succeeded, otherwise the number of failed
+    /// or skipped jobs up to a maximum of 101
+    ///
+    /// A summary of the failed jobs is written to the standard error.
+    int run(std::size_t concurrency);
+
+private:
+    Executor& _executor; //!< Executor to copy into each worker
+    std::vector<std::unique_ptr<Command>> _jobs; //!< Commands to execute
+    bool _haltsOnFailure{false}; //!< Whether or not to halt on failure
+
+    /// \brief Executes jobs dispatched by the shell until none remain
+    /// \param input file descriptor the job indices are read from
+    /// \param output file descriptor the job results are written to
+    ///
+    /// This method runs within a worker process and does not return.
+    [[noreturn]] void work(int input, int output);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_JobBatch
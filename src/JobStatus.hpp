@@ -0,0 +1,39 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::JobStatus structure
+
+#ifndef hpp_rshell_JobStatus
+#define hpp_rshell_JobStatus
+
+#include <chrono>
+
+namespace rshell {
+
+/// \brief Represents how a finished job, such as a pipeline stage, exited and
+/// the resources it used
+struct JobStatus
+{
+    int exitCode{0}; //!< Exit code of the job
+    std::chrono::nanoseconds wallTime{0}; //!< Time from start to exit
+    std::chrono::nanoseconds userTime{0}; //!< CPU time spent in user mode
+    std::chrono::nanoseconds systemTime{0}; //!< CPU time spent in the kernel
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_JobStatus
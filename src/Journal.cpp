@@ -0,0 +1,136 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "Journal.hpp"
+#include "utility/sha256.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace rshell {
+
+constexpr std::chrono::milliseconds Journal::syncInterval;
+
+Journal::Journal(const std::string& path)
+    : _file{::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC,
+            0644)}
+    , _synced{std::chrono::steady_clock::now()}
+{
+    if (_file < 0) {
+        std::perror(("rshell: " + path).c_str());
+        throw std::runtime_error{"unable to open journal"};
+    }
+
+    std::string contents;
+    char buffer[65536];
+    ssize_t count;
+    while ((count = ::read(_file, buffer, sizeof(buffer))) != 0) {
+        if (count < 0) {
+            std::perror(("rshell: " + path).c_str());
+            ::close(_file);
+            throw std::runtime_error{"unable to read journal"};
+        }
+
+        contents.append(buffer, count);
+    }
+
+    // Only whole, well-formed lines are records.  A line torn by a crash is
+    // terminated so that the records appended after it remain whole
+    std::istringstream lines{contents};
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::istringstream fields{line};
+        std::size_t index;
+        std::string hash;
+        if (!lines.eof() && fields >> index >> hash && hash.size() == 64) {
+            _completed[index] = hash;
+        }
+    }
+
+    if (!contents.empty() && contents.back() != '\n') {
+        if (::write(_file, "\n", 1) != 1) {
+            std::perror(("rshell: " + path).c_str());
+        }
+    }
+}
+
+Journal::~Journal()
+{
+    sync();
+    ::close(_file);
+}
+
+std::string Journal::hash(const std::vector<Token>& tokens)
+{
+    // Each token contributes its type and its length-prefixed text, so no
+    // two different statements are hashed alike
+    utility::sha256 result;
+    for (auto&& token : tokens) {
+        unsigned char header[9];
+        std::uint64_t size = token.text.size();
+        header[0] = static_cast<unsigned char>(token.type);
+        for (auto i = 0; i < 8; ++i) {
+            header[i + 1] = static_cast<unsigned char>(size >> (56 - i * 8));
+        }
+
+        result.update(header, sizeof(header));
+        result.update(token.text);
+    }
+
+    return result.hex_digest();
+}
+
+bool Journal::isComplete(std::size_t index, const std::string& hash) const
+{
+    auto record = _completed.find(index);
+    return record != std::end(_completed) && record->second == hash;
+}
+
+void Journal::complete(std::size_t index, const std::string& hash)
+{
+    _completed[index] = hash;
+
+    // The record reaches the file at once, so it survives the shell, but
+    // the disk only once the interval has passed since the last sync
+    auto line = std::to_string(index) + " " + hash + "\n";
+    if (::write(_file, line.data(), line.size()) !=
+            static_cast<ssize_t>(line.size())) {
+        std::perror("rshell: unable to write journal");
+        return;
+    }
+
+    _isDirty = true;
+    if (std::chrono::steady_clock::now() - _synced >= syncInterval) {
+        sync();
+    }
+}
+
+void Journal::sync()
+{
+    if (_isDirty) {
+        if (::fdatasync(_file) < 0) {
+            std::perror("rshell: unable to sync journal");
+        }
+
+        _isDirty = false;
+        _synced = std::chrono::steady_clock::now();
+    }
+}
+
+} // namespace rshell
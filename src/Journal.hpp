@@ -0,0 +1,89 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::Journal class
+
+#ifndef hpp_rshell_Journal
+#define hpp_rshell_Journal
+
+#include "Token.hpp"
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace rshell {
+
+/// \brief Durably records the top-level statements of a script as they
+/// complete, so that a script which failed may resume where it stopped
+///
+/// Each statement is identified by its index within the script and the
+/// SHA-256 hash of its tokens, so a statement which has since been edited
+/// is no longer considered complete.  The journal is an append-only file of
+/// one "index hash" line per completed statement.  Lines are written as
+/// statements complete but synchronized to the disk at most once per
+/// \ref syncInterval, and when the journal is closed, so journaling costs
+/// one write per statement.  A line torn by a crash is ignored.
+class Journal
+{
+public:
+    /// \brief Longest time completed statements are left unsynchronized
+    static constexpr std::chrono::milliseconds syncInterval{1000};
+
+    /// \brief Opens a journal, creating it if it does not exist
+    /// \param path path of the journal
+    /// \throw std::runtime_error if the journal cannot be opened or read
+    explicit Journal(const std::string& path);
+
+    /// \brief Synchronizes and closes the journal
+    ~Journal();
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    /// \brief Hashes the tokens of a statement
+    /// \param tokens tokens of the statement
+    /// \return hash as 64 lowercase hexadecimal digits
+    static std::string hash(const std::vector<Token>& tokens);
+
+    /// \brief Determines whether a statement has been recorded as complete
+    /// \param index index of the statement within the script
+    /// \param hash hash of the statement
+    /// \return whether or not the statement is complete
+    bool isComplete(std::size_t index, const std::string& hash) const;
+
+    /// \brief Records a statement as complete
+    /// \param index index of the statement within the script
+    /// \param hash hash of the statement
+    void complete(std::size_t index, const std::string& hash);
+
+    /// \brief Synchronizes the recorded statements to the disk
+    void sync();
+
+private:
+    int _file; //!< Descriptor of the journal file
+    std::map<std::size_t, std::string> _completed; //!< Completed statements
+    bool _isDirty{false}; //!< Whether or not records await synchronization
+
+    /// \brief Time the journal was last synchronized
+    std::chrono::steady_clock::time_point _synced;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_Journal
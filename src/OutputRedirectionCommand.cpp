@@ -17,30 +17,42 @@
 #include "OutputRedirectionCommand.hpp"
 #include "Executor.hpp"
 #include "ExecutorStream.hpp"
+#include <memory>
 #include <stdexcept>
+#include <utility>
+#include <unistd.h>
 
 namespace rshell {
 
+OutputRedirectionCommand::OutputRedirectionCommand()
+    : RedirectionCommand{STDOUT_FILENO}
+{
+}
+
 OutputRedirectionCommand::~OutputRedirectionCommand() = default;
 
-int OutputRedirectionCommand::execute(Executor& executor, WaitMode waitMode)
+ExecutionContext OutputRedirectionCommand::redirect(Executor& executor,
+        const ExecutionContext& context) const
 {
-    if (primary == nullptr || path.empty()) {
+    if (path.empty()) {
         throw std::runtime_error{"incomplete OutputRedirectionCommand"};
     }
 
-    // Create the output file stream
-    auto stream = executor.createOutputFileStream(path);
-    executor.streamSet().insert(*stream.get());
+    // Replace the descriptor with the file stream, or the stream of the
+    // coprocess the path addresses.  The stream is closed once the last
+    // context referring to it is destroyed
+    auto stream = executor.coprocessStream(path,
+            ExecutorStream::Mode::Output);
+    if (stream == nullptr) {
+        stream = executor.createOutputFileStream(path);
+    }
 
-    // Make the stream the output stream for the executor and execute the
-    // command
-    executor.setOutputStream(stream.get());
-    auto exitCode = primary->execute(executor, waitMode);
-    executor.setOutputStream(nullptr);
+    auto redirected = context.withStream(slot, stream);
+    if (isCombined) {
+        redirected = redirected.withStream(STDERR_FILENO, stream);
+    }
 
-    executor.streamSet().erase(*stream.get());
-    return exitCode;
+    return redirected;
 }
 
 } // namespace rshell
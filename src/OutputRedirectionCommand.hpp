@@ -21,27 +21,34 @@
 #ifndef hpp_rshell_OutputRedirectionCommand
 #define hpp_rshell_OutputRedirectionCommand
 
-#include "Command.hpp"
-#include <memory>
+#include "RedirectionCommand.hpp"
 #include <string>
 
 namespace rshell {
 
-/// \brief Command to be executed with a replaced standard output
-class OutputRedirectionCommand : public Command
+/// \brief Command to be executed with a replaced output descriptor
+class OutputRedirectionCommand : public RedirectionCommand
 {
 public:
-    std::unique_ptr<Command> primary; //!< Primary command to execute
     std::string path; //!< Path to output to
 
+    /// \brief Whether or not the standard error is replaced along with the
+    /// descriptor, as in "foo &> bar"
+    bool isCombined{false};
+
+    /// \brief Constructs a new instance of the \ref OutputRedirectionCommand
+    /// class replacing the standard output
+    OutputRedirectionCommand();
+
     /// \brief Destructs the \ref OutputRedirectionCommand instance
     virtual ~OutputRedirectionCommand();
 
-    /// \brief Executes the command using the given executor
-    /// \param executor executor to use for execution
-    /// \param waitMode wait mode to use when executing
-    /// \return exit code of the command
-    virtual int execute(Executor& executor, WaitMode waitMode) override;
+    /// \brief Applies the redirection alone to a context
+    /// \param executor executor to create streams on
+    /// \param context context to redirect
+    /// \return redirected context
+    virtual ExecutionContext redirect(Executor& executor,
+            const ExecutionContext& context) const override;
 };
 
 } // namespace rshell
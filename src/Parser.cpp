@@ -16,18 +16,37 @@
 
 #include "Parser.hpp"
 #include "AppendRedirectionCommand.hpp"
+#include "CacheBuiltinCommand.hpp"
 #include "ConjunctiveCommand.hpp"
+#include "CoprocBuiltinCommand.hpp"
 #include "DisjunctiveCommand.hpp"
+#include "DuplicateRedirectionCommand.hpp"
+#include "ExecBuiltinCommand.hpp"
 #include "ExecutableCommand.hpp"
 #include "ExitBuiltinCommand.hpp"
+#include "FanInCommand.hpp"
+#include "FanOutCommand.hpp"
+#include "HereDocumentCommand.hpp"
 #include "InputRedirectionCommand.hpp"
 #include "OutputRedirectionCommand.hpp"
 #include "PipeCommand.hpp"
+#include "PipeStatusBuiltinCommand.hpp"
+#include "ProcessSubstitutionCommand.hpp"
+#include "RaceCommand.hpp"
 #include "SequentialCommand.hpp"
+#include "SetBuiltinCommand.hpp"
+#include "ShardBuiltinCommand.hpp"
 #include "TestBuiltinCommand.hpp"
+#include "TimeoutBuiltinCommand.hpp"
+#include "UsesBuiltinCommand.hpp"
 #include "utility/make_unique.hpp"
+#include "utility/parse_duration.hpp"
+#include "utility/parse_size.hpp"
 #include <cassert>
+#include <cstddef>
 #include <stdexcept>
+#include <string>
+#include <unistd.h>
 
 using utility::make_unique;
 
@@ -44,27 +63,89 @@ std::unique_ptr<Command> Parser::apply()
     _root.release();
     _current = &_root;
     _scopes = {};
+    _previous = Token::Type::None;
 
-    // Dispatch each token to its appropriate parsing method
+    // Dispatch each token to its appropriate parsing method.  The readers of
+    // a fan-out are given by a scope, so a scope must follow it, as in
+    // "foo |* (bar; baz)"
     for (auto&& token : _tokens) {
+        if (_previous == Token::Type::FanOut &&
+                token.type != Token::Type::OpenScope) {
+            throw std::runtime_error{"fan-out must precede scope"};
+        }
+
         switch (token.type) {
             case Token::Type::Word: parseWord(token); break;
             case Token::Type::Sequence: parseSequence(token); break;
             case Token::Type::Conjunction: parseConjunction(token); break;
             case Token::Type::Disjunction: parseDisjunction(token); break;
+            case Token::Type::Race: parseRace(token); break;
             case Token::Type::Pipe: parsePipe(token); break;
+            case Token::Type::FanOut: parseFanOut(token); break;
+            case Token::Type::FanIn: parseFanIn(token); break;
             case Token::Type::InputRedirection: parseInputRedirection(token); break;
             case Token::Type::OutputRedirection: parseOutputRedirection(token); break;
             case Token::Type::AppendRedirection: parseAppendRedirection(token); break;
+            case Token::Type::DuplicateRedirection: parseDuplicateRedirection(token); break;
+            case Token::Type::HereDocument: parseHereDocument(token); break;
+            case Token::Type::HereString: parseHereDocument(token); break;
+            case Token::Type::ProcessSubstitution: parseProcessSubstitution(token); break;
             case Token::Type::OpenScope: parseOpenScope(token); break;
             case Token::Type::CloseScope: parseCloseScope(token); break;
             case Token::Type::None: break;
         }
+
+        _previous = token.type;
+    }
+
+    if (_previous == Token::Type::FanOut) {
+        throw std::runtime_error{"fan-out must precede scope"};
     }
 
     return std::move(_root);
 }
 
+std::unique_ptr<ExecutableCommand> Parser::createExecutableCommand(
+        const std::string& program)
+{
+    // First determine if the command is builtin, creating the appropriate
+    // command where necessary.  If the command is not builtin, assume it is
+    // an executable command
+    if (program == "exit") {
+        return make_unique<ExitBuiltinCommand>();
+    }
+    else if (program == "test" || program == "[") {
+        return make_unique<TestBuiltinCommand>();
+    }
+    else if (program == "uses") {
+        return make_unique<UsesBuiltinCommand>();
+    }
+    else if (program == "set") {
+        return make_unique<SetBuiltinCommand>();
+    }
+    else if (program == "pipestatus") {
+        return make_unique<PipeStatusBuiltinCommand>();
+    }
+    else if (program == "shard") {
+        return make_unique<ShardBuiltinCommand>();
+    }
+    else if (program == "timeout") {
+        return make_unique<TimeoutBuiltinCommand>();
+    }
+    else if (program == "cache") {
+        return make_unique<CacheBuiltinCommand>();
+    }
+    else if (program == "coproc") {
+        return make_unique<CoprocBuiltinCommand>();
+    }
+    else if (program == "exec") {
+        return make_unique<ExecBuiltinCommand>();
+    }
+    else {
+        return make_unique<ExecutableCommand>();
+    }
+}
+
 void Parser::parseWord(const Token& token)
 {
     assert(token.type == Token::Type::Word);
@@ -73,25 +154,17 @@ void Parser::parseWord(const Token& token)
     // we must instantiate a new command
     if (*_current == nullptr) {
         // We can determine the type of command from the word, which will
-        // represent the command program.  First determine if the command is
-        // builtin, creating the appropriate command where necessary.  If the
-        // command is not builtin, assume it is an executable command
-        if (token.text == "exit") {
-            *_current = make_unique<ExitBuiltinCommand>();
-        }
-        else if (token.text == "test" || token.text == "[") {
-            *_current = make_unique<TestBuiltinCommand>();
-        }
-        else {
-            *_current = make_unique<ExecutableCommand>();
-        }
+        // represent the command program
+        *_current = createExecutableCommand(token.text);
     }
 
     auto didAccept =
         parseExecutableWord(token)
         || parseInputRedirectionWord(token)
         || parseOutputRedirectionWord(token)
-        || parseAppendRedirectionWord(token);
+        || parseAppendRedirectionWord(token)
+        || parseHereDocumentWord(token)
+        || parseProcessSubstitutionWord(token);
     if (!didAccept) {
         throw std::runtime_error{"unexpected word encountered"};
     }
@@ -177,6 +250,51 @@ bool Parser::parseAppendRedirectionWord(const Token& token)
     return true;
 }
 
+bool Parser::parseHereDocumentWord(const Token& token)
+{
+    // Ensure the current command is a here-document
+    auto command = dynamic_cast<HereDocumentCommand*>(_current->get());
+    if (command == nullptr) {
+        return false;
+    }
+
+    // The word following a here-document has been replaced with its body,
+    // while the word following a here-string is its text
+    if (!command->hasText) {
+        command->text = token.text;
+        command->hasText = true;
+    }
+    else {
+        // "foo <<< bar baz" is invalid
+        throw std::runtime_error{"too many words after redirection"};
+    }
+
+    return true;
+}
+
+bool Parser::parseProcessSubstitutionWord(const Token& token)
+{
+    // Ensure the current command is a process substitution
+    Command* command = _current->get();
+    if (dynamic_cast<ProcessSubstitutionCommand*>(command) == nullptr) {
+        return false;
+    }
+
+    // "foo <(bar) baz" gives foo another argument after the substitution
+    while (auto nested =
+            dynamic_cast<ProcessSubstitutionCommand*>(command)) {
+        command = nested->primary.get();
+    }
+
+    auto executable = dynamic_cast<ExecutableCommand*>(command);
+    if (executable == nullptr) {
+        return false;
+    }
+
+    executable->arguments.push_back(token.text);
+    return true;
+}
+
 void Parser::parseSequence(const Token& token)
 {
     assert(token.type == Token::Type::Sequence);
@@ -244,6 +362,25 @@ void Parser::parseDisjunction(const Token& token)
     _current = &connective->secondary;
 }
 
+void Parser::parseRace(const Token& token)
+{
+    assert(token.type == Token::Type::Race);
+
+    // "&| foo" is an invalid command, as is "foo; &| bar"
+    if (*_current == nullptr) {
+        throw std::runtime_error{"race must follow command"};
+    }
+
+    // Extract the current command from the tree, replace it with a racing
+    // command, and make the previous current command the primary command
+    // of the race
+    auto current = make_unique<RaceCommand>();
+    auto connective = current.get();
+    current->primary = std::move(*_current);
+    *_current = std::move(current);
+    _current = &connective->secondary;
+}
+
 void Parser::parsePipe(const Token& token)
 {
     assert(token.type == Token::Type::Pipe);
@@ -258,6 +395,81 @@ void Parser::parsePipe(const Token& token)
     // of the pipe
     auto current = make_unique<PipeCommand>();
     auto connective = current.get();
+
+    // "foo |& bar" pipes the standard error along with the output, once
+    // the redirections of "foo" are applied, as in "foo 2>&1 | bar"
+    if (token.text == "|&") {
+        auto duplication = make_unique<DuplicateRedirectionCommand>();
+        duplication->slot = STDERR_FILENO;
+        duplication->source = STDOUT_FILENO;
+        duplication->primary = std::move(*_current);
+        *_current = std::move(duplication);
+    }
+
+    // "foo |+ bar" passes the pipe through a buffer of the shell
+    auto length = std::size_t{1};
+    if (token.text.size() > length && token.text[length] == '+') {
+        current->isBuffered = true;
+        ++length;
+    }
+
+    // "foo |{1M} bar" gives the pipe a capacity of one mebibyte
+    if (token.text.size() > length && token.text[length] == '{') {
+        auto capacity = token.text.substr(length + 1,
+                token.text.size() - length - 2);
+        if (!utility::parse_size(capacity, current->capacity) ||
+                current->capacity == 0) {
+            throw std::runtime_error{"invalid pipe capacity"};
+        }
+    }
+
+    current->primary = std::move(*_current);
+    *_current = std::move(current);
+    _current = &connective->secondary;
+}
+
+void Parser::parseFanOut(const Token& token)
+{
+    assert(token.type == Token::Type::FanOut);
+
+    // "|* foo" is an invalid command, as is "foo; |* bar"
+    if (*_current == nullptr) {
+        throw std::runtime_error{"fan-out must follow command"};
+    }
+
+    // Extract the current command from the tree, replace it with a fan-out
+    // command, and make the previous current command the primary command
+    // of the fan-out.  A scope following it, as in "foo |* (bar; baz)",
+    // gives the commands reading the output, which a fan-in may merge
+    // again, as in "foo |* (bar; baz) *| qux"
+    auto current = make_unique<FanOutCommand>();
+    auto connective = current.get();
+    current->primary = std::move(*_current);
+    *_current = std::move(current);
+    _current = &connective->secondary;
+}
+
+void Parser::parseFanIn(const Token& token)
+{
+    assert(token.type == Token::Type::FanIn);
+
+    // "*| foo" is an invalid command, as is "foo; *| bar"
+    if (*_current == nullptr) {
+        throw std::runtime_error{"fan-in must follow command"};
+    }
+
+    // The writers of a fan-in are given by a scope, so "foo *| bar" is an
+    // invalid command
+    if (_previous != Token::Type::CloseScope) {
+        throw std::runtime_error{"fan-in must follow scope"};
+    }
+
+    // Extract the current command from the tree, replace it with a fan-in
+    // command, and make the previous current command the primary command
+    // of the fan-in.  A scope preceding it, as in "(foo; bar) *| baz",
+    // gives the commands writing the input
+    auto current = make_unique<FanInCommand>();
+    auto connective = current.get();
     current->primary = std::move(*_current);
     *_current = std::move(current);
     _current = &connective->secondary;
@@ -276,6 +488,7 @@ void Parser::parseInputRedirection(const Token& token)
     // redirection command, and make the previous current command the primary
     // command of the redirection
     auto current = make_unique<InputRedirectionCommand>();
+    current->slot = parseRedirectionSlot(token, current->slot);
     current->primary = std::move(*_current);
     *_current = std::move(current);
 }
@@ -293,6 +506,8 @@ void Parser::parseOutputRedirection(const Token& token)
     // redirection command, and make the previous current command the primary
     // command of the redirection
     auto current = make_unique<OutputRedirectionCommand>();
+    current->slot = parseRedirectionSlot(token, current->slot);
+    current->isCombined = token.text.front() == '&';
     current->primary = std::move(*_current);
     *_current = std::move(current);
 }
@@ -310,8 +525,126 @@ void Parser::parseAppendRedirection(const Token& token)
     // redirection command, and make the previous current command the primary
     // command of the redirection
     auto current = make_unique<AppendRedirectionCommand>();
+    current->slot = parseRedirectionSlot(token, current->slot);
+    current->isCombined = token.text.front() == '&';
+    current->primary = std::move(*_current);
+    *_current = std::move(current);
+}
+
+void Parser::parseDuplicateRedirection(const Token& token)
+{
+    assert(token.type == Token::Type::DuplicateRedirection);
+
+    // ">&2" is an invalid command, as is "foo; >&2 bar"
+    if (*_current == nullptr) {
+        throw std::runtime_error{"descriptor duplication must follow "
+            "command"};
+    }
+
+    // Extract the current command from the tree, replace it with a
+    // duplication command, and make the previous current command the
+    // primary command of the duplication.  "foo 2>&1" replaces the standard
+    // error with the standard output, "foo <&3" replaces the standard input
+    // with descriptor 3, and "foo 3>&-" closes descriptor 3
+    auto current = make_unique<DuplicateRedirectionCommand>();
+    auto arrow = token.text.find_first_of("<>");
+    if (token.text[arrow] == '<') {
+        current->slot = STDIN_FILENO;
+        current->mode = ExecutorStream::Mode::Input;
+    }
+
+    current->slot = parseRedirectionSlot(token, current->slot);
+    if (token.text.back() != '-') {
+        current->source = token.text.back() - '0';
+    }
+
+    current->primary = std::move(*_current);
+    *_current = std::move(current);
+}
+
+void Parser::parseHereDocument(const Token& token)
+{
+    assert(token.type == Token::Type::HereDocument ||
+            token.type == Token::Type::HereString);
+
+    // "<<< foo" is an invalid command, as is "foo; <<EOF"
+    if (*_current == nullptr) {
+        throw std::runtime_error{"here-document must follow command"};
+    }
+
+    // Extract the current command from the tree, replace it with a
+    // here-document command, and make the previous current command the
+    // primary command of the redirection
+    auto current = make_unique<HereDocumentCommand>();
+    current->slot = parseRedirectionSlot(token, current->slot);
+    current->isString = token.type == Token::Type::HereString;
+    current->primary = std::move(*_current);
+    *_current = std::move(current);
+}
+
+void Parser::parseProcessSubstitution(const Token& token)
+{
+    assert(token.type == Token::Type::ProcessSubstitution);
+
+    // "<(foo)" is an invalid command, as is "foo; <(bar)"
+    if (*_current == nullptr) {
+        throw std::runtime_error{"process substitution must follow command"};
+    }
+
+    // The substitution is an argument of the executable command within any
+    // earlier substitutions, and takes the next lower descriptor
+    Command* command = _current->get();
+    auto slot = ProcessSubstitutionCommand::firstSlot;
+    while (auto nested =
+            dynamic_cast<ProcessSubstitutionCommand*>(command)) {
+        command = nested->primary.get();
+        --slot;
+    }
+
+    auto executable = dynamic_cast<ExecutableCommand*>(command);
+    if (executable == nullptr) {
+        // "foo > <(bar)" is invalid
+        throw std::runtime_error{"process substitution must be an argument"};
+    }
+
+    if (slot < ProcessSubstitutionCommand::lastSlot) {
+        throw std::runtime_error{"too many process substitutions"};
+    }
+
+    executable->arguments.push_back("/dev/fd/" + std::to_string(slot));
+
+    // Extract the current command from the tree, replace it with a process
+    // substitution command, and make the previous current command the
+    // primary command of the substitution.  The substituted command is a
+    // scope, which the closing parenthesis exits back to the substitution
+    auto current = make_unique<ProcessSubstitutionCommand>();
+    current->slot = slot;
+    current->isOutput = token.text.front() == '>';
+
+    auto scope = make_unique<SequentialCommand>();
+    scope->sequence.push_back(nullptr);
+
+    ScopePair pair;
+    pair.first = scope.get();
+    pair.second = _current;
+    _scopes.push(pair);
+
+    current->command = std::move(scope);
     current->primary = std::move(*_current);
     *_current = std::move(current);
+    _current = &pair.first->sequence.back();
+}
+
+int Parser::parseRedirectionSlot(const Token& token, int slot)
+{
+    // A redirection token may begin with the descriptor it replaces, as in
+    // "2>", or otherwise replaces the default descriptor for its direction
+    auto c = token.text.front();
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+
+    return slot;
 }
 
 void Parser::parseOpenScope(const Token& token)
@@ -327,6 +660,16 @@ void Parser::parseOpenScope(const Token& token)
     auto scope = make_unique<SequentialCommand>();
     scope->sequence.push_back(nullptr);
 
+    // "({5s} foo; bar)" gives the scope a deadline five seconds after it
+    // starts
+    if (token.text.size() > 1) {
+        auto timeout = token.text.substr(2, token.text.size() - 3);
+        if (!utility::parse_duration(timeout, scope->timeout) ||
+                scope->timeout.count() == 0) {
+            throw std::runtime_error{"invalid scope timeout"};
+        }
+    }
+
     // Create the contextual scope pair and push it into the stack
     ScopePair pair;
     pair.first = scope.get();
@@ -24,12 +24,14 @@
 #include "Token.hpp"
 #include <memory>
 #include <stack>
+#include <string>
 #include <utility>
 #include <vector>
 
 namespace rshell {
 
 // Forward declarations
+class ExecutableCommand;
 class SequentialCommand;
 
 /// \brief Accepts a sequence of tokens and transforms it into a composition
@@ -49,6 +51,14 @@ public:
     /// not well-formed.
     std::unique_ptr<Command> apply();
 
+    /// \brief Creates the executable command appropriate for the given
+    /// program name
+    /// \param program name of the program
+    /// \return builtin command if the program names a builtin, plain
+    /// executable command otherwise
+    static std::unique_ptr<ExecutableCommand> createExecutableCommand(
+            const std::string& program);
+
 private:
     /// \brief Type of smart pointer for storing Command instances
     using CommandPtr = std::unique_ptr<Command>;
@@ -66,6 +76,7 @@ private:
     CommandPtr* _current; //!< Pointer to the current owning command pointer
     bool _isRootSequence{false}; //!< Whether or not the root is sequential
     std::stack<ScopePair> _scopes; //!< Stack of current scopes
+    Token::Type _previous; //!< Type of the token parsed last
 
     /// \brief Parses a Token::Type::Word token
     /// \param token token to parse
@@ -91,6 +102,17 @@ private:
     /// \return whether the parse was accepted
     bool parseAppendRedirectionWord(const Token& token);
 
+    /// \brief Parses a Token::Type::Word token for a here-document
+    /// \param token token to parse
+    /// \return whether the parse was accepted
+    bool parseHereDocumentWord(const Token& token);
+
+    /// \brief Parses a Token::Type::Word token for an argument following a
+    /// process substitution
+    /// \param token token to parse
+    /// \return whether the parse was accepted
+    bool parseProcessSubstitutionWord(const Token& token);
+
     /// \brief Parses a Token::Type::Sequence token
     /// \param token token to parse
     void parseSequence(const Token& token);
@@ -103,10 +125,22 @@ private:
     /// \param token token to parse
     void parseDisjunction(const Token& token);
 
+    /// \brief Parses a Token::Type::Race token
+    /// \param token token to parse
+    void parseRace(const Token& token);
+
     /// \brief Parses a Token::Type::Pipe token
     /// \param token token to parse
     void parsePipe(const Token& token);
 
+    /// \brief Parses a Token::Type::FanOut token
+    /// \param token token to parse
+    void parseFanOut(const Token& token);
+
+    /// \brief Parses a Token::Type::FanIn token
+    /// \param token token to parse
+    void parseFanIn(const Token& token);
+
     /// \brief Parses a Token::Type::InputRedirection token
     /// \param token token to parse
     void parseInputRedirection(const Token& token);
@@ -119,6 +153,25 @@ private:
     /// \param token token to parse
     void parseAppendRedirection(const Token& token);
 
+    /// \brief Parses a Token::Type::DuplicateRedirection token
+    /// \param token token to parse
+    void parseDuplicateRedirection(const Token& token);
+
+    /// \brief Parses a Token::Type::HereDocument or Token::Type::HereString
+    /// token
+    /// \param token token to parse
+    void parseHereDocument(const Token& token);
+
+    /// \brief Parses a Token::Type::ProcessSubstitution token
+    /// \param token token to parse
+    void parseProcessSubstitution(const Token& token);
+
+    /// \brief Parses the descriptor a redirection token replaces
+    /// \param token token to parse
+    /// \param slot descriptor replaced if the token does not give one
+    /// \return descriptor the redirection replaces
+    static int parseRedirectionSlot(const Token& token, int slot);
+
     /// \brief Parses a Token::Type::OpenScope token
     /// \param token token to parse
     void parseOpenScope(const Token& token);
@@ -16,57 +16,230 @@
 
 #include "PipeCommand.hpp"
 #include "Executor.hpp"
+#include "ExecutorJob.hpp"
+#include "ExecutableCommand.hpp"
 #include "ExecutorPipe.hpp"
+#include "ExecutorPipeBuffer.hpp"
+#include "ExecutorPipeRelay.hpp"
+#include "ExecutorStream.hpp"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <thread>
 #include <utility>
 #include <vector>
+#include <unistd.h>
 
 namespace {
 
 using namespace rshell;
 
-// RAII for creating sets of pipes to connect commands
-// TODO: Refactor into a class with encapsulation in its own file
-struct ExecutorPipeSet
+/// \brief Minimum number of stages started by each thread of a pipeline
+/// whose starting is spread across threads
+constexpr std::size_t minimumSegmentLength = 64;
+
+/// \brief Starts a pipeline stage in continue mode
+/// \param executor executor to use for execution
+/// \param context context to execute the stage within
+/// \param command command of the stage
+/// \param input pipe whose read end is the input of the stage, if any
+/// \param output pipe whose write end is the output of the stage
+void startStage(Executor& executor, const ExecutionContext& context,
+        Command& command, const std::shared_ptr<ExecutorPipe>& input,
+        const std::shared_ptr<ExecutorPipe>& output)
 {
-    using PipeContainer = std::vector<std::unique_ptr<ExecutorPipe>> ;
+    auto stage = context.withStream(STDOUT_FILENO,
+            std::shared_ptr<ExecutorStream>{output, &output->outputStream()});
+    if (input != nullptr) {
+        stage = stage.withStream(STDIN_FILENO,
+                std::shared_ptr<ExecutorStream>{input, &input->inputStream()});
+    }
 
-    Executor& executor;
-    PipeContainer pipes;
+    executor.start(command, stage);
 
-    ExecutorPipeSet(Executor& executor, std::size_t count)
-        : executor(executor)
-        , pipes(count)
-    {
-        // Create the set of pipes for connecting commands
-        // While doing this, insert each pipe into the executor stream set
-        for (auto&& pipe : pipes) {
-            pipe = executor.createPipe();
-            executor.streamSet().insert(*pipe);
-        }
+    // The command holds its own copies of the ends it uses, so close them in
+    // the shell; otherwise the next stage would never see the end of its
+    // input, and the shell would hold every pipe of the pipeline open
+    if (input != nullptr) {
+        input->inputStream().close();
     }
 
-    ~ExecutorPipeSet()
+    output->outputStream().close();
+}
+
+/// \brief Type of list of the jobs of pipeline stages, in stage order
+using JobList = std::vector<std::unique_ptr<ExecutorJob>>;
+
+/// \brief Type of list of the buffers of the pipes following pipeline
+/// stages, in stage order
+using BufferList = std::vector<std::unique_ptr<ExecutorPipeBuffer>>;
+
+/// \brief Derives the context of a pipeline stage, which adopts the job of
+/// the stage into its place in the job list
+/// \param context context of the pipeline
+/// \param jobs jobs of the pipeline
+/// \param index index of the stage
+/// \return context of the stage
+ExecutionContext stageContext(const ExecutionContext& context, JobList& jobs,
+        std::size_t index)
+{
+    auto slot = &jobs[index];
+    return context.withJobHandler([slot](std::unique_ptr<ExecutorJob> job)
     {
-        // Upon destruction, erase all pipes from the executor stream set
-        for (auto&& pipe : pipes) {
-            executor.streamSet().erase(*pipe);
+        *slot = std::move(job);
+    });
+}
+
+/// \brief Starts a contiguous segment of pipeline stages in continue mode,
+/// one stage at a time
+/// \param executor executor to use for execution
+/// \param context context to execute the stages within
+/// \param commands commands of the pipeline
+/// \param capacities capacities of the pipes following each stage
+/// \param buffered whether or not the pipes following each stage are
+/// buffered
+/// \param buffers buffers of the pipes following each stage, filled for
+/// the buffered pipes of the segment
+/// \param first index of the first stage of the segment
+/// \param last index past the last stage of the segment
+/// \param jobs jobs of the pipeline, which adopt the jobs of the stages
+/// \param input pipe whose read end is the input of the first stage, if any
+/// \param output pipe whose write end is the output of the last stage, or
+/// \c null to create one
+/// \param relay relay to pass the output of each stage through, if any
+/// \return pipe whose read end is the output of the last stage
+///
+/// Only the pipes adjoining the stage being started are open in the shell,
+/// so a segment of any length needs no more than a few descriptors.
+std::shared_ptr<ExecutorPipe> startSegment(Executor& executor,
+        const ExecutionContext& context, const std::vector<Command*>& commands,
+        const std::vector<std::size_t>& capacities,
+        const std::vector<bool>& buffered, BufferList& buffers,
+        std::size_t first, std::size_t last, JobList& jobs,
+        std::shared_ptr<ExecutorPipe> input,
+        std::shared_ptr<ExecutorPipe> output, ExecutorPipeRelay* relay)
+{
+    for (auto i = first; i < last; ++i) {
+        auto next = i + 1 == last && output != nullptr ?
+            output : std::shared_ptr<ExecutorPipe>{
+                executor.createPipe(capacities[i])};
+
+        // A buffered stage writes to a pipe of its own, which the buffer
+        // drains into the pipe the next stage reads as fast as it fills
+        auto written = next;
+        if (buffered[i]) {
+            written = executor.createPipe(capacities[i]);
+            buffers[i] = executor.createPipeBuffer(written, next);
+            if (buffers[i] == nullptr) {
+                throw std::runtime_error{"executor cannot buffer pipes"};
+            }
         }
+
+        startStage(executor, stageContext(context, jobs, i), *commands[i],
+                input, written);
+        if (buffers[i] != nullptr) {
+            buffers[i]->start();
+        }
+
+        // A relayed stage writes to a pipe of its own, which the relay joins
+        // to the pipe the next stage reads
+        if (relay != nullptr) {
+            std::shared_ptr<ExecutorPipe> relayed{
+                executor.createPipe(capacities[i])};
+            relay->add(std::move(next), relayed);
+            next = std::move(relayed);
+        }
+
+        input = std::move(next);
     }
 
-    void activate(PipeContainer::iterator pipe)
-    {
-        // If the pipe is the first, unset the input stream.  Otherwise, make
-        // the previous pipe the input stream
-        executor.setInputStream(pipe != std::begin(pipes) ?
-                &(*std::prev(pipe))->inputStream() : nullptr);
+    return input;
+}
+
+/// \brief Names a pipeline stage for a profile report
+/// \param commands commands of the pipeline
+/// \param index index of the stage
+/// \return name of the stage
+std::string nameOf(const std::vector<Command*>& commands, std::size_t index)
+{
+    auto name = "stage " + std::to_string(index + 1);
+    auto command = dynamic_cast<ExecutableCommand*>(commands[index]);
+    if (command != nullptr) {
+        name += " (" + command->program + ")";
+    }
+
+    return name;
+}
+
+/// \brief Converts a duration to seconds
+/// \param duration duration to convert
+/// \return duration in seconds
+double secondsOf(std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
 
-        // If the pipe is the last, unset the output stream.  Otherwise, make
-        // it the output stream
-        executor.setOutputStream(pipe != std::end(pipes) ?
-                &(*pipe)->outputStream() : nullptr);
+/// \brief Writes a profile report of a pipeline to standard error
+/// \param commands commands of the pipeline
+/// \param statuses statuses of the stages
+/// \param profiles profiles of the pipes following each stage but the last
+///
+/// The bottleneck is the stage the others waited on longest, less the time
+/// it waited on others itself.  A slow stage holds up every stage before it
+/// by filling their pipes, and every stage after it by starving theirs, so
+/// only the stage at the source of the waiting gains by this measure.
+void report(const std::vector<Command*>& commands,
+        const std::vector<JobStatus>& statuses,
+        const std::vector<PipeProfile>& profiles)
+{
+    std::ostringstream output;
+    output << std::fixed << std::setprecision(3);
+    for (std::size_t i = 0; i < statuses.size(); ++i) {
+        auto& status = statuses[i];
+        output << "rshell: profile: " << nameOf(commands, i)
+            << ": exit " << status.exitCode
+            << ", wall " << secondsOf(status.wallTime) << " s"
+            << ", cpu " << secondsOf(status.userTime + status.systemTime)
+            << " s\n";
     }
-};
+
+    std::vector<std::chrono::nanoseconds> waitedOn(statuses.size());
+    for (std::size_t i = 0; i < profiles.size(); ++i) {
+        auto& profile = profiles[i];
+        auto active = secondsOf(profile.activeTime);
+        auto percentOf = [&](std::chrono::nanoseconds time)
+        {
+            return active > 0 ? 100 * secondsOf(time) / active : 0;
+        };
+
+        output << "rshell: profile: pipe " << i + 1 << " -> " << i + 2
+            << ": " << profile.bytes << " bytes, " << std::setprecision(1)
+            << (active > 0 ? profile.bytes / active / 1048576 : 0)
+            << " MiB/s, reader starved " << percentOf(profile.starvedTime)
+            << "%, writer blocked " << percentOf(profile.blockedTime)
+            << "%\n" << std::setprecision(3);
+
+        waitedOn[i] += profile.starvedTime - profile.blockedTime;
+        waitedOn[i + 1] += profile.blockedTime - profile.starvedTime;
+    }
+
+    auto bottleneck = std::max_element(std::begin(waitedOn),
+            std::end(waitedOn));
+    if (bottleneck != std::end(waitedOn) &&
+            *bottleneck > std::chrono::nanoseconds::zero()) {
+        output << "rshell: profile: bottleneck: "
+            << nameOf(commands, bottleneck - std::begin(waitedOn)) << '\n';
+    }
+
+    std::cerr << output.str() << std::flush;
+}
 
 }
 
@@ -74,17 +247,23 @@ namespace rshell {
 
 PipeCommand::~PipeCommand() = default;
 
-int PipeCommand::execute(Executor& executor, WaitMode waitMode)
+int PipeCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
 {
     if (primary == nullptr || secondary == nullptr) {
         throw std::runtime_error{"incomplete PipeCommand"};
     }
 
-    // Flatten the pipe structure to a linear list
+    // Flatten the pipe structure to a linear list, along with the capacity
+    // of the pipe following each command and whether it is buffered
     std::vector<Command*> commands;
+    std::vector<std::size_t> capacities;
+    std::vector<bool> buffered;
     auto pipeCommand = this;
     while (pipeCommand != nullptr) {
         commands.push_back(pipeCommand->primary.get());
+        capacities.push_back(pipeCommand->capacity);
+        buffered.push_back(pipeCommand->isBuffered);
 
         auto previous = pipeCommand;
         pipeCommand = dynamic_cast<PipeCommand*>(
@@ -94,29 +273,163 @@ int PipeCommand::execute(Executor& executor, WaitMode waitMode)
         }
     }
 
-    // Create the set of pipes to connect commands, then execute the commands
-    // in the order they are given, activating the appropriate pair of pipes
-    // at each stage.  Execute the first n-1 commands in continue mode and the
-    // last command in wait mode so that all commands are executing
-    // concurrently and the pipe command returns when the last command
-    // terminates
-    ExecutorPipeSet pipeSet(executor, commands.size() - 1);
-    auto pipe = std::begin(pipeSet.pipes);
-    for (auto&& command : commands) {
-        pipeSet.activate(pipe++);
-
-        if (command == commands.back()) {
-            // After execution, reset the input/output streams for future use
-            auto exitCode = command->execute(executor, WaitMode::Wait);
-            executor.setInputStream(nullptr);
-            executor.setOutputStream(nullptr);
-            return exitCode;
+    // Start the first n-1 commands in continue mode, then the last, so that
+    // all commands are executing concurrently, and return once every command
+    // has terminated.  Each command executes within a context joining its
+    // standard input to the read end of the previous pipe and its standard
+    // output to the write end of the next
+    auto stages = commands.size() - 1;
+    auto segments = std::min(executor.concurrency(),
+            stages / minimumSegmentLength);
+    segments = std::max<std::size_t>(segments, 1);
+
+    // Profiled pipelines pass every pipe through a relay, which is filled
+    // from one thread
+    auto relay = executor.isPipeProfile() ? executor.createPipeRelay() :
+        nullptr;
+    if (relay != nullptr) {
+        segments = 1;
+    }
+
+    // Very long pipelines are started by as many threads as the concurrency
+    // of the executor allows, each starting a contiguous segment of stages.
+    // Only the pipes joining the segments are created up front
+    auto segmentBegin = [&](std::size_t segment)
+    {
+        return segment * stages / segments;
+    };
+
+    std::vector<std::shared_ptr<ExecutorPipe>> boundaries;
+    for (std::size_t i = 1; i < segments; ++i) {
+        boundaries.emplace_back(
+                executor.createPipe(capacities[segmentBegin(i) - 1]));
+    }
+
+    JobList jobs(commands.size());
+    BufferList buffers(stages);
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(segments);
+    for (std::size_t i = 0; i + 1 < segments; ++i) {
+        threads.emplace_back([&, i]
+        {
+            try {
+                auto input = i > 0 ? boundaries[i - 1] : nullptr;
+                startSegment(executor, context, commands, capacities,
+                        buffered, buffers, segmentBegin(i),
+                        segmentBegin(i + 1), jobs, input, boundaries[i],
+                        nullptr);
+            }
+            catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+
+    std::shared_ptr<ExecutorPipe> input;
+    try {
+        input = startSegment(executor, context, commands, capacities,
+                buffered, buffers, segmentBegin(segments - 1),
+                segmentBegin(segments), jobs,
+                segments > 1 ? boundaries.back() : nullptr, nullptr,
+                relay.get());
+    }
+    catch (...) {
+        errors.back() = std::current_exception();
+    }
+
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    boundaries.clear();
+    for (auto&& error : errors) {
+        if (error != nullptr) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    auto stage = context.withStream(STDIN_FILENO,
+            std::shared_ptr<ExecutorStream>{input, &input->inputStream()});
+    input.reset();
+    if (relay != nullptr) {
+        relay->start();
+    }
+
+    // Wait for every stage, not only the last, so that none is left
+    // unreaped and the status of each is known.  The shell must release its
+    // copy of the last pipe before waiting, or the stages before the last
+    // could block writing to it forever.  It is closed rather than only
+    // released, as a relay keeps the pipe itself alive
+    std::vector<JobStatus> statuses;
+    auto& last = *commands.back();
+    if (last.isExternal()) {
+        last.execute(executor, stageContext(stage, jobs, stages),
+                WaitMode::Continue);
+        stage.stream(STDIN_FILENO)->close();
+        stage = context;
+        statuses = executor.wait(jobs);
+    }
+    else {
+        // The last stage executes within the shell, as builtins such as exit
+        // affect the shell, while the other stages are collected as they
+        // finish.  Its status includes no resource usage
+        std::exception_ptr collectorError;
+        std::thread collector{[&]
+        {
+            try {
+                statuses = executor.wait(jobs);
+            }
+            catch (...) {
+                collectorError = std::current_exception();
+            }
+        }};
+
+        JobStatus status;
+        std::exception_ptr error;
+        try {
+            auto started = std::chrono::steady_clock::now();
+            status.exitCode = last.execute(executor, stage, WaitMode::Wait);
+            status.wallTime = std::chrono::steady_clock::now() - started;
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        stage.stream(STDIN_FILENO)->close();
+        stage = context;
+        collector.join();
+        if (error != nullptr || collectorError != nullptr) {
+            std::rethrow_exception(error != nullptr ? error : collectorError);
+        }
+
+        statuses.back() = status;
+    }
+
+    // The buffers have passed on every byte once their readers finished
+    for (auto&& buffer : buffers) {
+        if (buffer != nullptr) {
+            buffer->finish();
         }
+    }
 
-        command->execute(executor, WaitMode::Continue);
+    if (relay != nullptr) {
+        report(commands, statuses, relay->finish());
     }
 
-    return 0;
+    auto exitCode = executor.pipeExitCode(statuses);
+    executor.setPipeStatus(std::move(statuses));
+    return exitCode;
+}
+
+void PipeCommand::prepare(Executor& executor)
+{
+    if (primary != nullptr) {
+        primary->prepare(executor);
+    }
+
+    if (secondary != nullptr) {
+        secondary->prepare(executor);
+    }
 }
 
 } // namespace rshell
@@ -21,6 +21,7 @@
 #define hpp_rshell_PipeCommand
 
 #include "Command.hpp"
+#include <cstddef>
 #include <memory>
 
 namespace rshell {
@@ -33,14 +34,29 @@ public:
     std::unique_ptr<Command> primary; //!< Primary command to execute
     std::unique_ptr<Command> secondary; //!< Secondary command to execute
 
+    /// \brief Capacity of the pipe in bytes, or zero for the default
+    /// capacity of the executor
+    std::size_t capacity{0};
+
+    /// \brief Whether or not the pipe passes through a buffer of the shell,
+    /// so that the primary command never waits on the secondary command
+    bool isBuffered{false};
+
     /// \brief Destructs the \ref PipeCommand instance
     virtual ~PipeCommand();
 
     /// \brief Executes the command using the given executor
     /// \param executor executor to use for execution
+    /// \param context context to execute the command within
     /// \param waitMode wait mode to use when executing
     /// \return exit code of the command
-    virtual int execute(Executor& executor, WaitMode waitMode) override;
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Prepares the command for repeated execution using the given
+    /// executor
+    /// \param executor executor to prepare with
+    virtual void prepare(Executor& executor) override;
 };
 
 } // namespace rshell
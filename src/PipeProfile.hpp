@@ -0,0 +1,46 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::PipeProfile structure
+
+#ifndef hpp_rshell_PipeProfile
+#define hpp_rshell_PipeProfile
+
+#include <chrono>
+#include <cstdint>
+
+namespace rshell {
+
+/// \brief Represents the traffic through a pipe joining two pipeline stages
+/// and the time each stage spent waiting on the other
+struct PipeProfile
+{
+    std::uint64_t bytes{0}; //!< Number of bytes passed through the pipe
+
+    /// \brief Time from the start of the relay to the end of the pipe
+    std::chrono::nanoseconds activeTime{0};
+
+    /// \brief Time the reader waited for the writer to fill the empty pipe
+    std::chrono::nanoseconds starvedTime{0};
+
+    /// \brief Time the writer waited for the reader to drain the full pipe
+    std::chrono::nanoseconds blockedTime{0};
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_PipeProfile
@@ -0,0 +1,111 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "PipeStatusBuiltinCommand.hpp"
+#include "Executor.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+/// \brief Converts a duration to seconds
+/// \param duration duration to convert
+/// \return duration in seconds
+double secondsOf(std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+/// \brief Whether or not the calling thread is executing the command in a
+/// subshell of its own
+thread_local bool isInSubshell = false;
+
+}
+
+namespace rshell {
+
+PipeStatusBuiltinCommand::~PipeStatusBuiltinCommand() = default;
+
+int PipeStatusBuiltinCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    auto isTimed = !arguments.empty() && arguments.front() == "-t";
+    if (arguments.size() > (isTimed ? 1 : 0)) {
+        std::cerr << "rshell: pipestatus: usage: pipestatus [-t]\n";
+        return 1;
+    }
+
+    // The report is written to the standard output of the process executing
+    // the command, so should the context replace it, the command executes in
+    // a subshell where it is in place.  The subshell inherits the statuses
+    // of the shell.  An executor without subshells executes it here
+    // regardless
+    if (context.stream(STDOUT_FILENO) != nullptr && !isInSubshell) {
+        isInSubshell = true;
+        try {
+            auto exitCode = executor.executeSubshell(*this, context,
+                    waitMode);
+            isInSubshell = false;
+            return exitCode;
+        }
+        catch (...) {
+            isInSubshell = false;
+            throw;
+        }
+    }
+
+    // Format the whole report before writing it, so that it is written at
+    // once
+    std::ostringstream report;
+    auto statuses = executor.pipeStatus();
+    if (isTimed) {
+        report << std::fixed << std::setprecision(3);
+        for (auto&& status : statuses) {
+            report << status.exitCode
+                << ' ' << secondsOf(status.wallTime)
+                << ' ' << secondsOf(status.userTime)
+                << ' ' << secondsOf(status.systemTime) << '\n';
+        }
+    }
+    else {
+        for (auto status = std::begin(statuses); status != std::end(statuses);
+                ++status) {
+            report << (status != std::begin(statuses) ? " " : "")
+                << status->exitCode;
+        }
+
+        report << '\n';
+    }
+
+    std::cout << report.str() << std::flush;
+    return 0;
+}
+
+void PipeStatusBuiltinCommand::prepare(Executor& executor)
+{
+    // Builtins execute within the shell and require no preparation
+}
+
+bool PipeStatusBuiltinCommand::isExternal() const
+{
+    return false;
+}
+
+} // namespace rshell
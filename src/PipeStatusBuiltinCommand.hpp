@@ -0,0 +1,62 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::PipeStatusBuiltinCommand class
+
+#ifndef hpp_rshell_PipeStatusBuiltinCommand
+#define hpp_rshell_PipeStatusBuiltinCommand
+
+#include "ExecutableCommand.hpp"
+
+namespace rshell {
+
+/// \brief Represents an invocation of the pipestatus builtin command
+///
+/// The pipestatus command prints the exit codes of the stages of the last
+/// pipeline executed by the shell on one line.  With the -t flag, it prints
+/// one line per stage instead, with its exit code, wall time, and user and
+/// system CPU time in seconds.  A last stage executing within the shell,
+/// such as a builtin or scope, has no CPU time.  Pipelines executing
+/// concurrently in subshells (rshell -p) do not update the statuses.
+class PipeStatusBuiltinCommand : public ExecutableCommand
+{
+public:
+    /// \brief Destructs the \ref PipeStatusBuiltinCommand instance
+    virtual ~PipeStatusBuiltinCommand();
+
+    /// \brief Executes the command using the given executor
+    /// \param executor executor to use for execution
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the command
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Prepares the command for repeated execution using the given
+    /// executor
+    /// \param executor executor to prepare with
+    virtual void prepare(Executor& executor) override;
+
+    /// \brief Gets a value indicating whether or not the command only starts
+    /// an external program
+    /// \return \c false, as builtins execute within the shell
+    virtual bool isExternal() const override;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_PipeStatusBuiltinCommand
@@ -16,76 +16,428 @@
 
 #include "PosixExecutor.hpp"
 #include "ArgVector.hpp"
+#include "DependencyGraph.hpp"
 #include "ExecutorStream.hpp"
+#include "ExitException.hpp"
 #include "PosixExecutorAppendFileStream.hpp"
+#include "PosixExecutorCachedStream.hpp"
+#include "PosixExecutorClosedStream.hpp"
+#include "PosixExecutorDocumentStream.hpp"
+#include "PosixExecutorDuplicateStream.hpp"
 #include "PosixExecutorInputFileStream.hpp"
+#include "PosixExecutorJob.hpp"
 #include "PosixExecutorOutputFileStream.hpp"
+#include "PosixExecutorFanIn.hpp"
+#include "PosixExecutorFanOut.hpp"
 #include "PosixExecutorPipe.hpp"
+#include "PosixExecutorPipeBuffer.hpp"
+#include "PosixExecutorPipeRelay.hpp"
+#include "PosixExecutorRace.hpp"
+#include "PosixExecutorPipeStream.hpp"
 #include "utility/make_unique.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
 #include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
 using utility::make_unique;
 
+extern char** environ;
+
+namespace {
+
+/// \brief State of a command within a concurrently executing graph
+struct GraphTask
+{
+    pid_t pid{-1}; //!< Process identifier of the subshell, if any
+    int file{-1}; //!< Process descriptor of the subshell, if any
+    bool isStarted{false}; //!< Whether or not the command has started
+    bool isFinished{false}; //!< Whether or not the command has finished
+    int exitCode{0}; //!< Exit code of the command
+    std::FILE* output{nullptr}; //!< Captured standard output, if any
+    std::FILE* error{nullptr}; //!< Captured standard error, if any
+};
+
+/// \brief Interval between observations of the pipes of a pipeline in pipe
+/// growth mode
+constexpr std::chrono::milliseconds pipeSampleInterval{10};
+
+/// \brief Pipe between the stages of a pipeline observed in pipe growth mode
+struct WatchedPipe
+{
+    std::size_t reader; //!< Index of the job reading from the pipe
+    int file; //!< Copy of the read end of the pipe held by the shell, if any
+    int fullSamples; //!< Number of consecutive samples finding it full
+};
+
+/// \brief Identifies the pipe of the executor joined to the standard input
+/// of a context
+/// \param context context whose standard input to identify
+/// \return inode of the pipe, or zero if the input is not such a pipe
+ino_t inputPipeOf(const rshell::ExecutionContext& context)
+{
+    auto stream = dynamic_cast<rshell::PosixExecutorPipeStream*>(
+            context.stream(STDIN_FILENO));
+    struct stat status;
+    if (stream == nullptr || stream->file() < 0 ||
+            ::fstat(stream->file(), &status) != 0) {
+        return 0;
+    }
+
+    return status.st_ino;
+}
+
+/// \brief Keeps the cached files a job reads held until the job is done,
+/// so that no other redirection rewinds them beneath it
+/// \param job job to hold the files
+/// \param context context the job was started within
+void retainCachedFiles(rshell::PosixExecutorJob& job,
+        const rshell::ExecutionContext& context)
+{
+    for (auto&& stream : context.streams()) {
+        auto cachedStream = dynamic_cast<rshell::PosixExecutorCachedStream*>(
+                stream.second.get());
+        if (cachedStream != nullptr && cachedStream->entry() &&
+                cachedStream->mode() == rshell::ExecutorStream::Mode::Input) {
+            job.retain(cachedStream->entry());
+        }
+    }
+}
+
+/// \brief Takes a copy of the standard input of a job once it is the pipe
+/// the job was started to read
+/// \param job job whose standard input to copy
+/// \return copy of the read end of the pipe, or -1 if the job has not yet
+/// joined the pipe to its standard input
+int takePipeInput(const rshell::PosixExecutorJob& job)
+{
+    auto file = -1;
+#ifdef SYS_pidfd_getfd
+    file = static_cast<int>(::syscall(SYS_pidfd_getfd, job.file(),
+                STDIN_FILENO, 0));
+    struct stat status;
+    if (file >= 0 && (::fstat(file, &status) != 0 ||
+                status.st_ino != job.inputPipe())) {
+        ::close(file);
+        file = -1;
+    }
+#endif
+
+    return file;
+}
+
+/// \brief Observes a pipe, doubling its capacity once it has been found
+/// nearly full on consecutive samples
+/// \param pipe pipe to observe
+///
+/// A pipe that stays full has a reader slower than its writer, which
+/// otherwise wakes for every few pages the reader drains.
+void samplePipe(WatchedPipe& pipe)
+{
+    int queued;
+    auto capacity = ::fcntl(pipe.file, F_GETPIPE_SZ);
+    if (capacity <= 0 || ::ioctl(pipe.file, FIONREAD, &queued) != 0) {
+        return;
+    }
+
+    if (queued < capacity - capacity / 4) {
+        pipe.fullSamples = 0;
+        return;
+    }
+
+    auto maximum = rshell::PosixExecutorPipe::maximumCapacity();
+    if (++pipe.fullSamples >= 2 &&
+            static_cast<std::size_t>(capacity) < maximum) {
+        auto size = std::min<std::size_t>(capacity * 2ul, maximum);
+        ::fcntl(pipe.file, F_SETPIPE_SZ, static_cast<int>(size));
+        pipe.fullSamples = 0;
+    }
+}
+
+/// \brief Closes the descriptors a subshell inherited from the shell other
+/// than the standard streams and those it keeps
+/// \param kept descriptors to keep open, in ascending order
+///
+/// The shell holds descriptors such as the relayed ends of profiled pipes,
+/// which are closed on exec but would otherwise stay open in a subshell
+/// and keep its own stages from seeing the end of their input.
+void closeInheritedFiles(const std::vector<unsigned int>& kept)
+{
+#ifdef SYS_close_range
+    // The descriptors to close are the gaps between those kept
+    unsigned int first = STDERR_FILENO + 1;
+    for (auto slot : kept) {
+        if (slot >= first) {
+            if (slot > first) {
+                ::syscall(SYS_close_range, first, slot - 1, 0);
+            }
+
+            first = slot + 1;
+        }
+    }
+
+    ::syscall(SYS_close_range, first, ~0u, 0);
+#endif
+}
+
+/// \brief Activates each stream of a context on its descriptor in a child,
+/// exiting the child if any cannot be
+/// \param context context whose streams to activate
+void activateStreams(const rshell::ExecutionContext& context)
+{
+    try {
+        for (auto&& stream : context.streams()) {
+            stream.second->activate(stream.first);
+        }
+    }
+    catch (const std::exception&) {
+        _exit(1);
+    }
+}
+
+/// \brief Copies the contents of a captured output file to a descriptor,
+/// then closes the file
+/// \param file captured output file
+/// \param slot file descriptor to copy to
+void replay(std::FILE* file, int slot)
+{
+    if (file == nullptr) {
+        return;
+    }
+
+    auto fd = fileno(file);
+    ::lseek(fd, 0, SEEK_SET);
+
+    char buffer[4096];
+    ssize_t count;
+    while ((count = ::read(fd, buffer, sizeof buffer)) > 0) {
+        for (ssize_t offset = 0; offset < count; ) {
+            auto written = ::write(slot, buffer + offset, count - offset);
+            if (written < 0) {
+                break;
+            }
+
+            offset += written;
+        }
+    }
+
+    std::fclose(file);
+}
+
+/// \brief Converts a status from waitpid into an exit code
+/// \param status status from waitpid
+/// \return exit code of the process
+int exitCodeOf(int status)
+{
+    if (WIFEXITED(status)) {
+        return WEXITSTATUS(status);
+    }
+
+    if (WIFSIGNALED(status)) {
+        return 128 + WTERMSIG(status);
+    }
+
+    throw std::runtime_error{"abnormal process termination"};
+}
+
+}
+
 namespace rshell {
 
 PosixExecutor::~PosixExecutor() = default;
 
-std::unique_ptr<ExecutorPipe> PosixExecutor::createPipe()
+std::unique_ptr<ExecutorPipe> PosixExecutor::createPipe(std::size_t capacity)
 {
-    return make_unique<PosixExecutorPipe>();
+    return make_unique<PosixExecutorPipe>(
+            capacity > 0 ? capacity : _pipeCapacity);
+}
+
+std::unique_ptr<ExecutorPipeRelay> PosixExecutor::createPipeRelay()
+{
+    return make_unique<PosixExecutorPipeRelay>();
+}
+
+std::unique_ptr<ExecutorPipeBuffer> PosixExecutor::createPipeBuffer(
+        std::shared_ptr<ExecutorPipe> input,
+        std::shared_ptr<ExecutorPipe> output)
+{
+    return make_unique<PosixExecutorPipeBuffer>(std::move(input),
+            std::move(output), _pipeBufferLimit);
+}
+
+std::unique_ptr<ExecutorFan> PosixExecutor::createFanOut(
+        std::shared_ptr<ExecutorPipe> input,
+        std::vector<std::shared_ptr<ExecutorPipe>> outputs)
+{
+    return make_unique<PosixExecutorFanOut>(std::move(input),
+            std::move(outputs));
+}
+
+std::unique_ptr<ExecutorFan> PosixExecutor::createFanIn(
+        std::vector<std::shared_ptr<ExecutorPipe>> inputs,
+        std::shared_ptr<ExecutorPipe> output)
+{
+    return make_unique<PosixExecutorFanIn>(std::move(inputs),
+            std::move(output));
+}
+
+std::unique_ptr<ExecutorRace> PosixExecutor::createRace(
+        std::vector<std::shared_ptr<ExecutorPipe>> inputs,
+        std::shared_ptr<ExecutorStream> output)
+{
+    return make_unique<PosixExecutorRace>(std::move(inputs),
+            std::move(output));
 }
 
 std::unique_ptr<ExecutorStream> PosixExecutor::createInputFileStream(
         const std::string& path)
 {
+    if (auto stream = _files.open(path, O_RDONLY)) {
+        return stream;
+    }
+
     return make_unique<PosixExecutorInputFileStream>(path);
 }
 
 std::unique_ptr<ExecutorStream> PosixExecutor::createOutputFileStream(
         const std::string& path)
 {
+    if (auto stream = _files.open(path, O_WRONLY | O_CREAT | O_TRUNC)) {
+        return stream;
+    }
+
     return make_unique<PosixExecutorOutputFileStream>(path);
 }
 
 std::unique_ptr<ExecutorStream> PosixExecutor::createAppendFileStream(
         const std::string& path)
 {
+    if (auto stream = _files.open(path, O_WRONLY | O_CREAT | O_APPEND)) {
+        return stream;
+    }
+
     return make_unique<PosixExecutorAppendFileStream>(path);
 }
 
-int PosixExecutor::execute(ExecutableCommand& command, WaitMode waitMode)
+std::unique_ptr<ExecutorStream> PosixExecutor::createDuplicateStream(
+        int file, ExecutorStream::Mode mode)
+{
+    return make_unique<PosixExecutorDuplicateStream>(file, mode);
+}
+
+std::unique_ptr<ExecutorStream> PosixExecutor::createClosedStream(
+        ExecutorStream::Mode mode)
+{
+    return make_unique<PosixExecutorClosedStream>(mode);
+}
+
+std::unique_ptr<ExecutorStream> PosixExecutor::createDocumentStream(
+        const std::string& text)
+{
+    return make_unique<PosixExecutorDocumentStream>(text);
+}
+
+bool PosixExecutor::redirectShell(int slot, ExecutorStream& stream)
+{
+    // Flush the standard streams so that their buffered contents go where
+    // they were written before the descriptors change beneath them
+    std::cout.flush();
+    std::cerr.flush();
+
+    // Activating a stream in the shell places it just as in a child, and
+    // the descriptor outlives the stream, which the context closes.  A
+    // cached file placed so shares its position with the shell's slot, so
+    // it is no longer handed to other redirections
+    stream.activate(slot);
+    {
+        std::lock_guard<std::mutex> lock{_shellFilesMutex};
+        if (dynamic_cast<PosixExecutorClosedStream*>(&stream) != nullptr) {
+            _shellFiles.erase(slot);
+        }
+        else {
+            _shellFiles.insert(slot);
+        }
+    }
+
+    if (auto cachedStream = dynamic_cast<PosixExecutorCachedStream*>(
+                &stream)) {
+        if (cachedStream->entry()) {
+            _files.forget(*cachedStream->entry());
+        }
+    }
+
+    return true;
+}
+
+int PosixExecutor::execute(ExecutableCommand& command,
+        const ExecutionContext& context, WaitMode waitMode)
 {
     // Create an argv-style C array to pass to the system call
     ArgVector argv{command.program, command.arguments};
 
+    // Locate the program before forking so that its location remains cached
+    // within the shell for later executions
+    auto location = locate(command.program, context);
+
+    // Build the replaced environment, if any, before forking, as the child
+    // of a process with several threads may not safely allocate memory
+    ExecutionContext::Environment environment;
+    std::vector<char*> entries;
+    if (context.hasEnvironment()) {
+        environment = context.environment();
+        for (auto&& entry : environment) {
+            entries.push_back(const_cast<char*>(entry.c_str()));
+        }
+
+        entries.push_back(nullptr);
+    }
+
+    // In pipe growth mode, a job started to read a pipe records which, so
+    // the pipe may be observed once the job has joined it
+    auto input = _isPipeGrowth && waitMode == WaitMode::Continue ?
+        inputPipeOf(context) : 0;
+    auto started = std::chrono::steady_clock::now();
+    auto isGroupLeader = false;
+
     // Fork the process.  If the fork is successful, there will be two
     // identical processes running at the same point on the next line of code.
     // One will possess a "pid" value of zero, indicating that it is the
     // forked child process.  The other will possess a positive "pid" value,
     // indicating that it is the parent process and the pid is of the child.
     // If the "pid" value is negative, no fork occurred
-    auto pid = fork();
+    auto pid = forkFor(context, isGroupLeader);
     if (pid == 0) {
-        // Activate the input stream, if any
-        if (_inputStream != nullptr) {
-            _inputStream->activate(*this);
-        }
+        // Activate each stream of the context on its descriptor.  Every
+        // other descriptor opened by the shell is closed on exec, so the
+        // program does not hold open any pipe it does not use
+        activateStreams(context);
 
-        // Activate the output stream, if any
-        if (_outputStream != nullptr) {
-            _outputStream->activate(*this);
+        if (context.hasEnvironment()) {
+            environ = entries.data();
         }
 
-        // Close all open streams to ensure proper termination
-        _streamSet.close();
+        // Invoke the exec system call, replacing the current process image
+        // with the given executable.  If the program could not be located,
+        // let execvp search for it and report the failure
+        if (!location.empty()) {
+            execv(location.c_str(), argv);
+        }
 
-        // Invoke the exit system call, replacing the current process image
-        // with the given executable
         execvp(argv[0], argv);
 
         // Under normal conditions, exec does not return.  However, if an
@@ -97,39 +449,552 @@ int PosixExecutor::execute(ExecutableCommand& command, WaitMode waitMode)
         std::exit(1);
     }
     else if (pid > 0) {
-        // Skip waiting if we are meant to continue
+        // Skip waiting if we are meant to continue, handing the child to
+        // whoever will wait for it instead
         switch (waitMode) {
-            case WaitMode::Continue:
+            case WaitMode::Continue: {
+                auto job = make_unique<PosixExecutorJob>(pid, started, input,
+                        context.deadline(), isGroupLeader);
+                retainCachedFiles(*job, context);
+                context.adopt(std::move(job));
                 return 0;
+            }
 
             case WaitMode::Wait:
                 break;
         }
 
-        // Close all open streams to ensure proper termination
-        _streamSet.close();
+        return waitFor(pid, started, context, isGroupLeader);
+    }
+    else {
+        std::perror("rshell: fork failed");
+        throw std::runtime_error{"unable to fork"};
+    }
+}
 
-        // Wait for the forked child process to exit.  If the return value
-        // of the waitpid system call is negative, an error occurred while
-        // waiting
-        int status;
-        if (waitpid(pid, &status, 0) < 0) {
-            std::perror("rshell: wait failed");
-            throw std::runtime_error{"error while waiting"};
-        }
+int PosixExecutor::executeSubshell(Command& command,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    // Flush the standard streams so that their buffered contents are not
+    // duplicated into the subshell
+    std::cout.flush();
+    std::cerr.flush();
+
+    // In pipe growth mode, a job started to read a pipe records which, so
+    // the pipe may be observed once the job has joined it
+    auto input = _isPipeGrowth && waitMode == WaitMode::Continue ?
+        inputPipeOf(context) : 0;
+    auto kept = keptFiles(context);
+    auto started = std::chrono::steady_clock::now();
+    auto isGroupLeader = false;
+    auto pid = forkFor(context, isGroupLeader);
+    if (pid == 0) {
+        // Place the streams of the context on the descriptors of the
+        // subshell, where builtins write their output as well, then close
+        // the shell's copies so that the subshell holds open only the ends
+        // it uses
+        activateStreams(context);
 
-        // If the child process exited, as it should, return its exit code
-        if (WIFEXITED(status)) {
-            return WEXITSTATUS(status);
+        for (auto&& stream : context.streams()) {
+            stream.second->close();
         }
 
-        // If the child process did not exit, something went horribly wrong
-        throw std::runtime_error{"abnormal process termination"};
+        closeInheritedFiles(kept);
+        exitSubshell(command, context.forSubshell());
     }
-    else {
+    else if (pid < 0) {
         std::perror("rshell: fork failed");
         throw std::runtime_error{"unable to fork"};
     }
+
+    // Skip waiting if we are meant to continue, handing the subshell to
+    // whoever will wait for it instead
+    switch (waitMode) {
+        case WaitMode::Continue: {
+            auto job = make_unique<PosixExecutorJob>(pid, started, input,
+                    context.deadline(), isGroupLeader);
+            retainCachedFiles(*job, context);
+            context.adopt(std::move(job));
+            return 0;
+        }
+
+        case WaitMode::Wait:
+            break;
+    }
+
+    return waitFor(pid, started, context, isGroupLeader);
+}
+
+int PosixExecutor::execute(DependencyGraph& graph,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    if (_concurrency <= 1) {
+        return Executor::execute(graph, context, waitMode);
+    }
+
+    // Flush the standard streams so that their buffered contents are not
+    // duplicated into the forked subshells
+    std::cout.flush();
+    std::cerr.flush();
+
+    std::vector<GraphTask> tasks(graph.size());
+    std::size_t running = 0;
+    std::size_t replayed = 0;
+    auto exitCode = 0;
+
+    auto isReady = [&](std::size_t i)
+    {
+        for (auto&& dependency : graph.dependencies(i)) {
+            if (!tasks[dependency].isFinished) {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    auto reap = [&]()
+    {
+        // Wait for any subshell of the graph to exit.  Other children of
+        // the shell, such as coprocesses and process substitutions, belong
+        // to the commands that started them and are left for those to reap
+        std::vector<pollfd> entries;
+        std::vector<std::size_t> indices;
+        for (std::size_t i = 0; i < tasks.size(); ++i) {
+            if (tasks[i].pid > 0 && !tasks[i].isFinished) {
+                if (tasks[i].file >= 0) {
+                    entries.push_back({tasks[i].file, POLLIN, 0});
+                }
+
+                indices.push_back(i);
+            }
+        }
+
+        // Without a process descriptor for every subshell, wait for the
+        // earliest instead
+        auto index = indices.front();
+        if (entries.size() == indices.size()) {
+            while (::poll(entries.data(), entries.size(), -1) < 0) {
+                if (errno != EINTR) {
+                    std::perror("rshell: poll failed");
+                    throw std::runtime_error{"error while waiting"};
+                }
+            }
+
+            for (std::size_t k = 0; k < entries.size(); ++k) {
+                if (entries[k].revents != 0) {
+                    index = indices[k];
+                    break;
+                }
+            }
+        }
+
+        auto& task = tasks[index];
+        int status;
+        while (waitpid(task.pid, &status, 0) < 0) {
+            if (errno != EINTR) {
+                std::perror("rshell: wait failed");
+                throw std::runtime_error{"error while waiting"};
+            }
+        }
+
+        if (task.file >= 0) {
+            ::close(task.file);
+            task.file = -1;
+        }
+
+        task.isFinished = true;
+        task.exitCode = exitCodeOf(status);
+        --running;
+    };
+
+    auto start = [&](std::size_t i)
+    {
+        auto& task = tasks[i];
+        task.isStarted = true;
+        task.output = std::tmpfile();
+        task.error = std::tmpfile();
+        if (task.output == nullptr || task.error == nullptr) {
+            std::perror("rshell: unable to create capture file");
+            throw std::runtime_error{"unable to create capture file"};
+        }
+
+        task.pid = fork();
+        if (task.pid == 0) {
+            // Concurrent commands do not receive the standard input of the
+            // shell, in the same manner as the asynchronous lists of a POSIX
+            // shell.  Their output is captured for replay by the shell
+            auto null = ::open("/dev/null", O_RDONLY);
+            ::dup2(null, STDIN_FILENO);
+            ::close(null);
+            ::dup2(fileno(task.output), STDOUT_FILENO);
+            ::dup2(fileno(task.error), STDERR_FILENO);
+
+            // Nested sequences execute sequentially so that the concurrency
+            // limit applies to the shell as a whole
+            _concurrency = 1;
+            exitSubshell(graph.command(i), context);
+        }
+        else if (task.pid < 0) {
+            std::perror("rshell: fork failed");
+            throw std::runtime_error{"unable to fork"};
+        }
+
+#ifdef SYS_pidfd_open
+        task.file = static_cast<int>(::syscall(SYS_pidfd_open, task.pid, 0));
+#endif
+        ++running;
+    };
+
+    try {
+        while (replayed < tasks.size()) {
+            // Start every ready command in sequence order until the
+            // concurrency limit is reached.  Barriers execute within the
+            // shell once all of the commands before them have been replayed
+            for (auto i = replayed; i < tasks.size() && running < _concurrency;
+                    ++i) {
+                if (tasks[i].isStarted || !isReady(i)) {
+                    continue;
+                }
+
+                if (graph.footprint(i).isBarrier()) {
+                    if (i == replayed) {
+                        tasks[i].isStarted = true;
+                        tasks[i].exitCode = graph.command(i).execute(*this,
+                                context, waitMode);
+                        tasks[i].isFinished = true;
+                        std::cout.flush();
+                        std::cerr.flush();
+                    }
+
+                    break;
+                }
+
+                start(i);
+            }
+
+            // Replay the output of the finished commands at the front of the
+            // sequence, stopping at the first unfinished command
+            while (replayed < tasks.size() && tasks[replayed].isFinished) {
+                replay(tasks[replayed].output, STDOUT_FILENO);
+                replay(tasks[replayed].error, STDERR_FILENO);
+                exitCode = tasks[replayed].exitCode;
+                ++replayed;
+            }
+
+            if (running > 0) {
+                reap();
+            }
+        }
+    }
+    catch (...) {
+        // Allow the running subshells to finish and preserve their output
+        // before propagating the error
+        for (auto&& task : tasks) {
+            if (task.pid > 0 && !task.isFinished) {
+                int status;
+                waitpid(task.pid, &status, 0);
+            }
+
+            if (task.file >= 0) {
+                ::close(task.file);
+            }
+        }
+
+        for (auto i = replayed; i < tasks.size(); ++i) {
+            replay(tasks[i].output, STDOUT_FILENO);
+            replay(tasks[i].error, STDERR_FILENO);
+        }
+
+        throw;
+    }
+
+    return exitCode;
+}
+
+std::vector<JobStatus> PosixExecutor::wait(
+        std::vector<std::unique_ptr<ExecutorJob>>& jobs)
+{
+    // Wait on the process descriptors of all jobs at once, reaping each job
+    // as soon as it exits so that its wall time is measured accurately
+    std::vector<JobStatus> statuses(jobs.size());
+    std::vector<pollfd> entries;
+    std::vector<std::size_t> indices;
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        auto job = dynamic_cast<PosixExecutorJob*>(jobs[i].get());
+        if (job != nullptr && job->file() >= 0) {
+            entries.push_back({job->file(), POLLIN, 0});
+            indices.push_back(i);
+        }
+    }
+
+    // In pipe growth mode, observe the pipes read by the stages through
+    // copies of their read ends, taken from the stages only now that all
+    // have started so that none inherits another's.  Stages executing
+    // within the shell may fork without executing, so pipelines with such a
+    // stage are not observed.  Each copy is closed as soon as its reader
+    // exits, so the writer still sees a broken pipe
+    std::vector<WatchedPipe> pipes;
+    if (_isPipeGrowth && entries.size() == jobs.size()) {
+        for (std::size_t i = 0; i < jobs.size(); ++i) {
+            if (static_cast<PosixExecutorJob&>(*jobs[i]).inputPipe() != 0) {
+                pipes.push_back({i, -1, 0});
+            }
+        }
+    }
+
+    auto release = [&](std::size_t reader)
+    {
+        for (auto pipe = std::begin(pipes); pipe != std::end(pipes); ) {
+            if (reader == jobs.size() || pipe->reader == reader) {
+                if (pipe->file >= 0) {
+                    ::close(pipe->file);
+                }
+
+                pipe = pipes.erase(pipe);
+            }
+            else {
+                ++pipe;
+            }
+        }
+    };
+
+    try {
+        auto nextSample = std::chrono::steady_clock::now();
+        while (!entries.empty()) {
+            // Wake for the next pipe sample or the next job to pass its
+            // deadline, whichever comes first
+            auto timeout = pipes.empty() ? -1 : static_cast<int>(
+                    pipeSampleInterval.count());
+            auto signal = std::chrono::steady_clock::time_point::max();
+            for (auto index : indices) {
+                signal = std::min(signal, static_cast<PosixExecutorJob&>(
+                            *jobs[index]).nextSignal());
+            }
+
+            if (signal != std::chrono::steady_clock::time_point::max()) {
+                // Round up so as not to wake before the deadline
+                auto remaining = std::chrono::duration_cast<
+                    std::chrono::milliseconds>(signal -
+                            std::chrono::steady_clock::now()).count() + 1;
+                remaining = std::max<decltype(remaining)>(remaining, 0);
+                if (timeout < 0 || remaining < timeout) {
+                    timeout = static_cast<int>(remaining);
+                }
+            }
+
+            if (::poll(entries.data(), entries.size(), timeout) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                break;
+            }
+
+            for (std::size_t i = entries.size(); i-- > 0; ) {
+                if (entries[i].revents != 0) {
+                    auto& job = jobs[indices[i]];
+                    release(indices[i]);
+                    statuses[indices[i]] = job->wait();
+                    job.reset();
+                    entries.erase(std::begin(entries) + i);
+                    indices.erase(std::begin(indices) + i);
+                }
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            for (auto index : indices) {
+                auto& job = static_cast<PosixExecutorJob&>(*jobs[index]);
+                if (job.nextSignal() <= now) {
+                    job.expire();
+                }
+            }
+
+            if (!pipes.empty() && now >= nextSample) {
+                for (auto&& pipe : pipes) {
+                    if (pipe.file < 0) {
+                        pipe.file = takePipeInput(
+                                static_cast<PosixExecutorJob&>(
+                                    *jobs[pipe.reader]));
+                    }
+
+                    if (pipe.file >= 0) {
+                        samplePipe(pipe);
+                    }
+                }
+
+                nextSample = now + pipeSampleInterval;
+            }
+        }
+    }
+    catch (...) {
+        release(jobs.size());
+        throw;
+    }
+
+    release(jobs.size());
+
+    // Wait for the remaining jobs, such as those without process descriptors,
+    // one at a time
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        if (jobs[i] != nullptr) {
+            statuses[i] = jobs[i]->wait();
+            jobs[i].reset();
+        }
+    }
+
+    return statuses;
+}
+
+pid_t PosixExecutor::forkFor(const ExecutionContext& context,
+        bool& isGroupLeader)
+{
+    // Place the child in its own process group from both sides, so that the
+    // group exists however the two processes are scheduled
+    isGroupLeader = context.isGroupLeader() ||
+        (context.hasDeadline() && !_isInGroup);
+    auto pid = fork();
+    if (pid == 0) {
+        if (isGroupLeader) {
+            ::setpgid(0, 0);
+        }
+
+        _isInGroup = _isInGroup || isGroupLeader || context.hasDeadline();
+    }
+    else if (pid > 0 && isGroupLeader) {
+        ::setpgid(pid, pid);
+    }
+
+    return pid;
+}
+
+int PosixExecutor::waitFor(pid_t pid,
+        std::chrono::steady_clock::time_point started,
+        const ExecutionContext& context, bool isGroupLeader)
+{
+    // A child with a deadline is waited for as a job, which signals it once
+    // the deadline passes
+    if (context.hasDeadline()) {
+        PosixExecutorJob job{pid, started, 0, context.deadline(),
+            isGroupLeader};
+        return job.wait().exitCode;
+    }
+
+    // Wait for the forked child process to exit.  If the return value of
+    // the waitpid system call is negative, an error occurred while waiting
+    int status;
+    if (waitpid(pid, &status, 0) < 0) {
+        std::perror("rshell: wait failed");
+        throw std::runtime_error{"error while waiting"};
+    }
+
+    // Return the exit code of the child process, or the conventional code
+    // for the signal that terminated it
+    return exitCodeOf(status);
+}
+
+std::vector<unsigned int> PosixExecutor::keptFiles(
+        const ExecutionContext& context)
+{
+    std::vector<unsigned int> kept;
+    for (auto&& stream : context.streams()) {
+        kept.push_back(static_cast<unsigned int>(stream.first));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{_shellFilesMutex};
+        for (auto slot : _shellFiles) {
+            kept.push_back(static_cast<unsigned int>(slot));
+        }
+    }
+
+    // The shell's ends of the coprocess pipes stay open, so that a subshell
+    // may redirect to and from the coprocesses as the shell does
+    for (auto&& stream : coprocessStreams()) {
+        auto pipeStream = dynamic_cast<PosixExecutorPipeStream*>(
+                stream.get());
+        if (pipeStream != nullptr && pipeStream->file() >= 0) {
+            kept.push_back(static_cast<unsigned int>(pipeStream->file()));
+        }
+    }
+
+    std::sort(std::begin(kept), std::end(kept));
+    kept.erase(std::unique(std::begin(kept), std::end(kept)),
+            std::end(kept));
+    return kept;
+}
+
+void PosixExecutor::exitSubshell(Command& command,
+        const ExecutionContext& context)
+{
+    int code;
+    try {
+        code = command.execute(*this, context, WaitMode::Wait);
+    }
+    catch (const ExitException& e) {
+        code = e.exitCode();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "rshell: error: " << e.what() << '\n';
+        code = 1;
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+    _exit(code);
+}
+
+void PosixExecutor::prepare(ExecutableCommand& command)
+{
+    locate(command.program, ExecutionContext{});
+}
+
+std::string PosixExecutor::locate(const std::string& program,
+        const ExecutionContext& context)
+{
+    if (program.empty() || program.find('/') != std::string::npos) {
+        return program;
+    }
+
+    // Only locations found on the PATH of the shell are cached, as a
+    // replaced environment may search elsewhere
+    auto isCached = !context.hasEnvironment();
+    if (isCached) {
+        std::lock_guard<std::mutex> lock{_locationsMutex};
+        auto iter = _locations.find(program);
+        if (iter != std::end(_locations)) {
+            if (::access(iter->second.c_str(), X_OK) == 0) {
+                return iter->second;
+            }
+
+            _locations.erase(iter);
+        }
+    }
+
+    // Search each directory of the PATH in order, treating empty entries as
+    // the working directory as execvp does
+    std::string path{"/usr/bin:/bin"};
+    context.variable("PATH", path);
+    std::istringstream directories{path};
+    std::string directory;
+    while (std::getline(directories, directory, ':')) {
+        auto candidate = (directory.empty() ? "." : directory) + '/' + program;
+
+        struct stat info;
+        if (::stat(candidate.c_str(), &info) == 0 && S_ISREG(info.st_mode) &&
+                ::access(candidate.c_str(), X_OK) == 0) {
+            // Locations relative to the working directory may not be cached,
+            // as the working directory can differ between executions
+            if (isCached && candidate.front() == '/') {
+                std::lock_guard<std::mutex> lock{_locationsMutex};
+                _locations[program] = candidate;
+            }
+
+            return candidate;
+        }
+    }
+
+    return {};
 }
 
 } // namespace rshell
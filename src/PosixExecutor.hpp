@@ -21,6 +21,12 @@
 #define hpp_rshell_PosixExecutor
 
 #include "Executor.hpp"
+#include "PosixExecutorFileCache.hpp"
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
 
 namespace rshell {
 
@@ -33,8 +39,53 @@ public:
     virtual ~PosixExecutor();
 
     /// \brief Creates a new pipe on the executor
+    /// \param capacity capacity of the pipe in bytes, or zero for the
+    /// default capacity of the executor
     /// \return pointer to new pipe
-    virtual std::unique_ptr<ExecutorPipe> createPipe();
+    virtual std::unique_ptr<ExecutorPipe> createPipe(
+            std::size_t capacity = 0) override;
+
+    /// \brief Creates a new relay for profiling the pipes of the executor
+    /// \return pointer to new relay
+    virtual std::unique_ptr<ExecutorPipeRelay> createPipeRelay() override;
+
+    /// \brief Creates a new buffer passing one pipe of the executor into
+    /// another, so that the writer of the first never waits on the reader of
+    /// the second
+    /// \param input pipe whose read end the buffer takes
+    /// \param output pipe whose write end the buffer takes
+    /// \return pointer to new buffer
+    virtual std::unique_ptr<ExecutorPipeBuffer> createPipeBuffer(
+            std::shared_ptr<ExecutorPipe> input,
+            std::shared_ptr<ExecutorPipe> output) override;
+
+    /// \brief Creates a new fan duplicating one pipe of the executor into
+    /// several
+    /// \param input pipe whose read end the fan takes
+    /// \param outputs pipes whose write ends the fan takes
+    /// \return pointer to new fan
+    virtual std::unique_ptr<ExecutorFan> createFanOut(
+            std::shared_ptr<ExecutorPipe> input,
+            std::vector<std::shared_ptr<ExecutorPipe>> outputs) override;
+
+    /// \brief Creates a new fan merging several pipes of the executor into
+    /// one a line at a time
+    /// \param inputs pipes whose read ends the fan takes
+    /// \param output pipe whose write end the fan takes
+    /// \return pointer to new fan
+    virtual std::unique_ptr<ExecutorFan> createFanIn(
+            std::vector<std::shared_ptr<ExecutorPipe>> inputs,
+            std::shared_ptr<ExecutorPipe> output) override;
+
+    /// \brief Creates a new race passing on the output of one of several
+    /// commands of the executor
+    /// \param inputs pipes whose read ends the race takes, one per command
+    /// \param output stream to pass the chosen output to, or \c null for
+    /// the standard output of the shell
+    /// \return pointer to new race
+    virtual std::unique_ptr<ExecutorRace> createRace(
+            std::vector<std::shared_ptr<ExecutorPipe>> inputs,
+            std::shared_ptr<ExecutorStream> output) override;
 
     /// \brief Creates a new input file stream on the executor
     /// \param path path to open the stream on
@@ -54,12 +105,153 @@ public:
     virtual std::unique_ptr<ExecutorStream> createAppendFileStream(
             const std::string& path);
 
+    /// \brief Creates a new stream on a copy of a descriptor of the shell
+    /// \param file descriptor of the shell to copy
+    /// \param mode input/output mode of the stream
+    /// \return pointer to new stream
+    virtual std::unique_ptr<ExecutorStream> createDuplicateStream(int file,
+            ExecutorStream::Mode mode) override;
+
+    /// \brief Creates a new stream closing the descriptor it replaces
+    /// \param mode input/output mode of the stream
+    /// \return pointer to new stream
+    virtual std::unique_ptr<ExecutorStream> createClosedStream(
+            ExecutorStream::Mode mode) override;
+
+    /// \brief Creates a new input stream reading the given text
+    /// \param text text to read
+    /// \return pointer to new stream
+    virtual std::unique_ptr<ExecutorStream> createDocumentStream(
+            const std::string& text) override;
+
+    /// \brief Places a stream on a descriptor of the shell itself, which
+    /// later commands inherit
+    /// \param slot descriptor of the shell to replace
+    /// \param stream stream to place on the descriptor
+    /// \return \c true
+    virtual bool redirectShell(int slot, ExecutorStream& stream) override;
+
+    using Executor::execute;
+
     /// \brief Executes the individual command given
     /// \param command command to execute
+    /// \param context context to execute the command within
     /// \param waitMode wait mode to use when executing
     /// \return exit code of the command
     virtual int execute(ExecutableCommand& command,
+            const ExecutionContext& context,
+            WaitMode waitMode = WaitMode::Wait) override;
+
+    /// \brief Executes the abstract command given in a forked subshell
+    /// \param command command to execute
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the command, or zero if not waiting
+    virtual int executeSubshell(Command& command,
+            const ExecutionContext& context,
             WaitMode waitMode = WaitMode::Wait) override;
+
+    /// \brief Executes the graph of sequential commands given
+    /// \param graph graph of commands to execute
+    /// \param context context to execute the commands within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the last command in the graph
+    ///
+    /// Commands whose dependencies have finished are executed concurrently
+    /// in forked subshells, up to the concurrency of the executor.  The
+    /// output of each subshell is captured and replayed in sequence order so
+    /// that the execution is observably sequential.
+    virtual int execute(DependencyGraph& graph,
+            const ExecutionContext& context,
+            WaitMode waitMode = WaitMode::Wait) override;
+
+    /// \brief Waits for every job given to finish
+    /// \param jobs jobs to wait for, any of which may be \c null
+    /// \return status of each job, in the order given
+    ///
+    /// Jobs are reaped in the order in which they exit, using process
+    /// descriptors where the system provides them.
+    virtual std::vector<JobStatus> wait(
+            std::vector<std::unique_ptr<ExecutorJob>>& jobs) override;
+
+    /// \brief Prepares the individual command given for repeated execution
+    /// \param command command to prepare
+    ///
+    /// Locates the program of the command so that later executions do not
+    /// search the PATH for it.
+    virtual void prepare(ExecutableCommand& command) override;
+
+protected:
+    /// \brief Cache of the locations of programs found on the PATH
+    std::map<std::string, std::string> _locations;
+
+    /// \brief Mutex guarding the cache of program locations
+    std::mutex _locationsMutex;
+
+    /// \brief Cache of the files redirections open
+    PosixExecutorFileCache _files;
+
+    /// \brief Descriptors of the shell that exec placed streams on, which
+    /// subshells keep open along with those of their contexts
+    std::set<int> _shellFiles;
+
+    /// \brief Mutex guarding the descriptors placed by exec
+    std::mutex _shellFilesMutex;
+
+    /// \brief Whether or not the shell is a subshell within the process
+    /// group of a command that is stopped as a whole, such as one with a
+    /// deadline, whose commands remain in it
+    bool _isInGroup{false};
+
+    /// \brief Forks a child to execute a command within the given context
+    /// \param context context of the command
+    /// \param isGroupLeader whether or not the child leads a process group
+    /// of its own
+    /// \return process identifier of the child in the parent, zero in the
+    /// child
+    ///
+    /// A command with a deadline leads a process group of its own, so that
+    /// everything it starts may be stopped along with it, unless the shell
+    /// is already within such a group.  A context may also ask for a group
+    /// regardless, as a race does for each alternative.
+    pid_t forkFor(const ExecutionContext& context, bool& isGroupLeader);
+
+    /// \brief Waits for a child executed in wait mode
+    /// \param pid process identifier of the child
+    /// \param started time at which the child was forked
+    /// \param context context of the command
+    /// \param isGroupLeader whether or not the child leads a process group
+    /// of its own
+    /// \return exit code of the child
+    int waitFor(pid_t pid, std::chrono::steady_clock::time_point started,
+            const ExecutionContext& context, bool isGroupLeader);
+
+    /// \brief Lists the descriptors a subshell of the given context keeps
+    /// open beyond the standard streams
+    /// \param context context of the subshell
+    /// \return descriptors in ascending order
+    ///
+    /// The list is gathered before forking, as the child of a process with
+    /// several threads may not safely allocate memory or lock a mutex.
+    std::vector<unsigned int> keptFiles(const ExecutionContext& context);
+
+    /// \brief Executes a command within a forked subshell, then exits the
+    /// subshell with its exit code
+    /// \param command command to execute
+    /// \param context context to execute the command within
+    [[noreturn]] void exitSubshell(Command& command,
+            const ExecutionContext& context);
+
+    /// \brief Locates a program by searching the directories of the PATH
+    /// environment variable
+    /// \param program name of the program
+    /// \param context context whose PATH to search
+    /// \return path to the program, or an empty string if it was not found
+    ///
+    /// Names containing a slash are returned as given.  Cached locations are
+    /// revalidated with a single access check before they are returned.
+    std::string locate(const std::string& program,
+            const ExecutionContext& context);
 };
 
 } // namespace rshell
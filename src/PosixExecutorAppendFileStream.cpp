@@ -15,6 +15,7 @@
 // SOFTWARE.
 
 #include "PosixExecutorAppendFileStream.hpp"
+#include "utility/raise_descriptor.hpp"
 #include <cstdlib>
 #include <stdexcept>
 #include <fcntl.h>
@@ -27,8 +28,9 @@ namespace rshell {
 PosixExecutorAppendFileStream::PosixExecutorAppendFileStream(
         const std::string& path)
     : ExecutorStream{Mode::Output}
-    , _file(::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND,
-                S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH))
+    , _file(utility::raise_descriptor(::open(path.c_str(),
+                    O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+                    S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)))
 {
     if (_file == -1) {
         std::perror("rshell: unable to open output file");
@@ -41,14 +43,17 @@ PosixExecutorAppendFileStream::~PosixExecutorAppendFileStream()
     close();
 }
 
-void PosixExecutorAppendFileStream::activate(Executor& executor)
+void PosixExecutorAppendFileStream::activate(int slot)
 {
-    ::dup2(_file, STDOUT_FILENO);
+    ::dup2(_file, slot);
 }
 
 void PosixExecutorAppendFileStream::close()
 {
-    ::close(_file);
+    if (_file >= 0) {
+        ::close(_file);
+        _file = -1;
+    }
 }
 
 } // namespace rshell
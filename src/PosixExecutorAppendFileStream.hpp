@@ -38,9 +38,14 @@ public:
     /// \brief Destructs the \ref PosixExecutorAppendFileStream instance
     virtual ~PosixExecutorAppendFileStream();
 
-    /// \brief Activates the stream within the given executor
-    /// \param executor executor to activate on
-    virtual void activate(Executor& executor) override;
+    /// \brief Gets the file descriptor of the stream
+    /// \return file descriptor, or -1 if the stream is closed
+    int file() const noexcept { return _file; }
+
+    /// \brief Activates the stream on the given descriptor of the calling
+    /// process
+    /// \param slot descriptor to replace with the stream
+    virtual void activate(int slot) override;
 
     /// \brief Closes the stream
     virtual void close() override;
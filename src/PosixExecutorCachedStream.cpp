@@ -14,39 +14,34 @@
 // ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
 // SOFTWARE.
 
-#include "ExecutorStreamSet.hpp"
-#include "ExecutorPipe.hpp"
-#include "ExecutorStream.hpp"
+#include "PosixExecutorCachedStream.hpp"
+#include <utility>
+#include <unistd.h>
 
 namespace rshell {
 
-void ExecutorStreamSet::insert(ExecutorPipe& pipe)
+PosixExecutorCachedStream::PosixExecutorCachedStream(
+        std::shared_ptr<PosixExecutorFileCache::Entry> entry, Mode mode)
+    : ExecutorStream{mode}
+    , _entry{std::move(entry)}
 {
-    insert(pipe.inputStream());
-    insert(pipe.outputStream());
 }
 
-void ExecutorStreamSet::insert(ExecutorStream& stream)
+PosixExecutorCachedStream::~PosixExecutorCachedStream()
 {
-    _streams.insert(&stream);
+    close();
 }
 
-void ExecutorStreamSet::erase(ExecutorPipe& pipe)
+void PosixExecutorCachedStream::activate(int slot)
 {
-    erase(pipe.inputStream());
-    erase(pipe.outputStream());
-}
-
-void ExecutorStreamSet::erase(ExecutorStream& stream)
-{
-    _streams.erase(&stream);
+    if (_entry) {
+        ::dup2(_entry->file, slot);
+    }
 }
 
-void ExecutorStreamSet::close()
+void PosixExecutorCachedStream::close()
 {
-    for (auto&& stream : _streams) {
-        stream->close();
-    }
+    _entry.reset();
 }
 
 } // namespace rshell
@@ -0,0 +1,68 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the
+/// \ref rshell::PosixExecutorCachedStream class
+
+#ifndef hpp_rshell_PosixExecutorCachedStream
+#define hpp_rshell_PosixExecutorCachedStream
+
+#include "ExecutorStream.hpp"
+#include "PosixExecutorFileCache.hpp"
+#include <memory>
+
+namespace rshell {
+
+/// \brief Stream on a file held open by a \ref PosixExecutorFileCache
+class PosixExecutorCachedStream : public ExecutorStream
+{
+public:
+    /// \brief Constructs a new instance of the
+    /// \ref PosixExecutorCachedStream class on the given cached file
+    /// \param entry cached file
+    /// \param mode input/output mode of the stream
+    PosixExecutorCachedStream(
+            std::shared_ptr<PosixExecutorFileCache::Entry> entry, Mode mode);
+
+    /// \brief Destructs the \ref PosixExecutorCachedStream instance
+    virtual ~PosixExecutorCachedStream();
+
+    /// \brief Gets the file descriptor of the stream
+    /// \return file descriptor, or -1 if the stream is closed
+    int file() const noexcept { return _entry ? _entry->file : -1; }
+
+    /// \brief Gets the cached file of the stream
+    /// \return cached file, or \c null if the stream is closed
+    const std::shared_ptr<PosixExecutorFileCache::Entry>& entry() const
+        noexcept { return _entry; }
+
+    /// \brief Activates the stream on the given descriptor of the calling
+    /// process
+    /// \param slot descriptor to replace with the stream
+    virtual void activate(int slot) override;
+
+    /// \brief Releases the stream's hold on the cached file, which stays
+    /// open for later redirections
+    virtual void close() override;
+
+protected:
+    std::shared_ptr<PosixExecutorFileCache::Entry> _entry; //!< Cached file
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_PosixExecutorCachedStream
@@ -0,0 +1,38 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "PosixExecutorClosedStream.hpp"
+#include <unistd.h>
+
+namespace rshell {
+
+PosixExecutorClosedStream::PosixExecutorClosedStream(Mode mode)
+    : ExecutorStream{mode}
+{
+}
+
+PosixExecutorClosedStream::~PosixExecutorClosedStream() = default;
+
+void PosixExecutorClosedStream::activate(int slot)
+{
+    ::close(slot);
+}
+
+void PosixExecutorClosedStream::close()
+{
+}
+
+} // namespace rshell
@@ -0,0 +1,52 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the
+/// \ref rshell::PosixExecutorClosedStream class
+
+#ifndef hpp_rshell_PosixExecutorClosedStream
+#define hpp_rshell_PosixExecutorClosedStream
+
+#include "ExecutorStream.hpp"
+
+namespace rshell {
+
+/// \brief Executor stream closing a descriptor with POSIX system calls, as
+/// in "foo 2>&-"
+class PosixExecutorClosedStream : public ExecutorStream
+{
+public:
+    /// \brief Constructs a new instance of the
+    /// \ref PosixExecutorClosedStream class
+    /// \param mode input/output mode of the stream
+    explicit PosixExecutorClosedStream(Mode mode);
+
+    /// \brief Destructs the \ref PosixExecutorClosedStream instance
+    virtual ~PosixExecutorClosedStream();
+
+    /// \brief Activates the stream on the given descriptor of the calling
+    /// process, closing it
+    /// \param slot descriptor to close
+    virtual void activate(int slot) override;
+
+    /// \brief Closes the stream, which holds no descriptor
+    virtual void close() override;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_PosixExecutorClosedStream
@@ -0,0 +1,123 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "PosixExecutorDocumentStream.hpp"
+#include "utility/raise_descriptor.hpp"
+#include "utility/read_write_all.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using utility::write_all;
+
+namespace rshell {
+
+PosixExecutorDocumentStream::PosixExecutorDocumentStream(
+        const std::string& text)
+    : ExecutorStream{Mode::Input}
+{
+    // A pipe takes up to PIPE_BUF bytes at once whatever its capacity, so
+    // short text, the usual case, needs neither a file nor a reader
+    auto isStored = text.size() <= PIPE_BUF ?
+        storeInPipe(text) : storeInFile(text);
+    if (!isStored) {
+        std::perror("rshell: unable to store here-document");
+        throw std::runtime_error{"unable to store here-document"};
+    }
+}
+
+PosixExecutorDocumentStream::~PosixExecutorDocumentStream()
+{
+    close();
+}
+
+void PosixExecutorDocumentStream::activate(int slot)
+{
+    ::dup2(_file, slot);
+}
+
+void PosixExecutorDocumentStream::close()
+{
+    if (_file >= 0) {
+        ::close(_file);
+        _file = -1;
+    }
+}
+
+bool PosixExecutorDocumentStream::storeInPipe(const std::string& text)
+{
+    int files[2];
+    if (::pipe2(files, O_CLOEXEC) != 0) {
+        return false;
+    }
+
+    auto isWritten = write_all(files[1], text.data(), text.size());
+    ::close(files[1]);
+    if (!isWritten) {
+        ::close(files[0]);
+        return false;
+    }
+
+    _file = utility::raise_descriptor(files[0]);
+    return _file >= 0;
+}
+
+bool PosixExecutorDocumentStream::storeInFile(const std::string& text)
+{
+    // A memfd lives in memory and needs no writable directory.  Once
+    // written, it is sealed against change, as every reader shares it.
+    // Otherwise, an unnamed file in the temporary directory is removed along
+    // with its last descriptor
+    auto file = -1;
+#ifdef SYS_memfd_create
+    file = static_cast<int>(::syscall(SYS_memfd_create, "rshell-document",
+                3u /* MFD_CLOEXEC | MFD_ALLOW_SEALING */));
+#endif
+
+#ifdef O_TMPFILE
+    if (file < 0) {
+        auto directory = std::getenv("TMPDIR");
+        file = ::open(directory != nullptr ? directory : "/tmp",
+                O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+    }
+#endif
+
+    if (file < 0) {
+        return false;
+    }
+
+    if (!write_all(file, text.data(), text.size()) ||
+            ::lseek(file, 0, SEEK_SET) != 0) {
+        ::close(file);
+        return false;
+    }
+
+#ifdef F_ADD_SEALS
+    // Files other than memfds do not take seals, which is harmless
+    ::fcntl(file, F_ADD_SEALS,
+            F_SEAL_SEAL | F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE);
+#endif
+
+    _file = utility::raise_descriptor(file);
+    return _file >= 0;
+}
+
+} // namespace rshell
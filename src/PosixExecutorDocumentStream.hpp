@@ -0,0 +1,76 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the
+/// \ref rshell::PosixExecutorDocumentStream class
+
+#ifndef hpp_rshell_PosixExecutorDocumentStream
+#define hpp_rshell_PosixExecutorDocumentStream
+
+#include "ExecutorStream.hpp"
+#include <string>
+
+namespace rshell {
+
+/// \brief Executor stream for reading text held by the shell, such as a
+/// here-document, with POSIX system calls
+///
+/// Text fitting in a pipe at once is written into a pipe, whose read end
+/// becomes the stream.  Longer text is written into a sealed memfd, or an
+/// unnamed temporary file where memfds are unavailable, so that no process
+/// needs to feed it and no file remains on disk.
+class PosixExecutorDocumentStream : public ExecutorStream
+{
+public:
+    /// \brief Constructs a new instance of the
+    /// \ref PosixExecutorDocumentStream class on the given text
+    /// \param text text to read
+    /// \throw std::runtime_error if the text cannot be stored
+    explicit PosixExecutorDocumentStream(const std::string& text);
+
+    /// \brief Destructs the \ref PosixExecutorDocumentStream instance
+    virtual ~PosixExecutorDocumentStream();
+
+    /// \brief Gets the file descriptor of the stream
+    /// \return file descriptor, or -1 if the stream is closed
+    int file() const noexcept { return _file; }
+
+    /// \brief Activates the stream on the given descriptor of the calling
+    /// process
+    /// \param slot descriptor to replace with the stream
+    virtual void activate(int slot) override;
+
+    /// \brief Closes the stream
+    virtual void close() override;
+
+protected:
+    int _file{-1}; //!< File descriptor
+
+    /// \brief Stores the text in a pipe
+    /// \param text text to store
+    /// \return whether or not the text was stored
+    bool storeInPipe(const std::string& text);
+
+    /// \brief Stores the text in a sealed anonymous file
+    /// \param text text to store
+    /// \return whether or not the text was stored
+    bool storeInFile(const std::string& text);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_PosixExecutorDocumentStream
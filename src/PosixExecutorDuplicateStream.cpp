@@ -0,0 +1,57 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "PosixExecutorDuplicateStream.hpp"
+#include "utility/raise_descriptor.hpp"
+#include <cstdio>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace rshell {
+
+PosixExecutorDuplicateStream::PosixExecutorDuplicateStream(int file,
+        Mode mode)
+    : ExecutorStream{mode}
+    , _file(utility::duplicate_descriptor(file))
+{
+    // The copy is taken now rather than in the child, so that it refers to
+    // the descriptor as it was when the redirection was written
+    if (_file == -1) {
+        std::perror("rshell: unable to duplicate descriptor");
+        throw std::runtime_error{"unable to duplicate descriptor"};
+    }
+}
+
+PosixExecutorDuplicateStream::~PosixExecutorDuplicateStream()
+{
+    close();
+}
+
+void PosixExecutorDuplicateStream::activate(int slot)
+{
+    ::dup2(_file, slot);
+}
+
+void PosixExecutorDuplicateStream::close()
+{
+    if (_file >= 0) {
+        ::close(_file);
+        _file = -1;
+    }
+}
+
+} // namespace rshell
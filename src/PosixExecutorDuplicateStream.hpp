@@ -0,0 +1,61 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the
+/// \ref rshell::PosixExecutorDuplicateStream class
+
+#ifndef hpp_rshell_PosixExecutorDuplicateStream
+#define hpp_rshell_PosixExecutorDuplicateStream
+
+#include "ExecutorStream.hpp"
+
+namespace rshell {
+
+/// \brief Executor stream for a copy of a descriptor of the shell with POSIX
+/// system calls
+class PosixExecutorDuplicateStream : public ExecutorStream
+{
+public:
+    /// \brief Constructs a new instance of the
+    /// \ref PosixExecutorDuplicateStream class on a copy of the given
+    /// descriptor
+    /// \param file descriptor of the shell to copy
+    /// \param mode input/output mode of the stream
+    PosixExecutorDuplicateStream(int file, Mode mode);
+
+    /// \brief Destructs the \ref PosixExecutorDuplicateStream instance
+    virtual ~PosixExecutorDuplicateStream();
+
+    /// \brief Gets the file descriptor of the stream
+    /// \return file descriptor, or -1 if the stream is closed
+    int file() const noexcept { return _file; }
+
+    /// \brief Activates the stream on the given descriptor of the calling
+    /// process
+    /// \param slot descriptor to replace with the stream
+    virtual void activate(int slot) override;
+
+    /// \brief Closes the stream
+    virtual void close() override;
+
+protected:
+    int _file; //!< File descriptor
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_PosixExecutorDuplicateStream
@@ -0,0 +1,181 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "PosixExecutorFanIn.hpp"
+#include "utility/block_sigpipe.hpp"
+#include "utility/pipe_file.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <poll.h>
+#include <unistd.h>
+
+using utility::block_sigpipe;
+using utility::pipe_file;
+
+namespace {
+
+/// \brief Size of the buffer each input is read into
+constexpr std::size_t bufferSize = 65536;
+
+}
+
+namespace rshell {
+
+PosixExecutorFanIn::PosixExecutorFanIn(
+        std::vector<std::shared_ptr<ExecutorPipe>> inputs,
+        std::shared_ptr<ExecutorPipe> output)
+    : _output(std::move(output))
+    , _sink(pipe_file(_output->outputStream(), "fanned"))
+{
+    for (auto&& input : inputs) {
+        Source source;
+        source.file = pipe_file(input->inputStream(), "fanned");
+        source.input = std::move(input);
+        _sources.push_back(std::move(source));
+    }
+}
+
+PosixExecutorFanIn::~PosixExecutorFanIn()
+{
+    finish();
+    for (auto&& source : _sources) {
+        close(source);
+    }
+
+    _output->outputStream().close();
+}
+
+void PosixExecutorFanIn::start()
+{
+    _thread = std::thread{&PosixExecutorFanIn::run, this};
+}
+
+void PosixExecutorFanIn::finish()
+{
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void PosixExecutorFanIn::run()
+{
+    block_sigpipe();
+
+    std::vector<char> buffer(bufferSize);
+    std::vector<pollfd> entries;
+    std::vector<Source*> waiting;
+    auto isOpen = true;
+    while (isOpen) {
+        entries.clear();
+        waiting.clear();
+        for (auto&& source : _sources) {
+            if (source.file >= 0) {
+                entries.push_back({source.file, POLLIN, 0});
+                waiting.push_back(&source);
+            }
+        }
+
+        if (entries.empty()) {
+            break;
+        }
+
+        if (::poll(entries.data(), entries.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            std::perror("rshell: unable to poll fanned pipes");
+            break;
+        }
+
+        for (std::size_t i = 0; isOpen && i < entries.size(); ++i) {
+            if (entries[i].revents == 0) {
+                continue;
+            }
+
+            auto& source = *waiting[i];
+            auto count = ::read(source.file, buffer.data(), buffer.size());
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (count <= 0) {
+                // The input has ended, so its unfinished line is finished
+                if (count < 0) {
+                    std::perror("rshell: unable to read fanned pipe");
+                }
+
+                isOpen = write(source.pending.data(), source.pending.size());
+                close(source);
+                continue;
+            }
+
+            // Write every whole line read so far from the input, keeping the
+            // rest until its line is finished or fills the buffer
+            source.pending.append(buffer.data(), count);
+            auto end = source.pending.rfind('\n');
+            auto length = end != std::string::npos ? end + 1 :
+                source.pending.size() >= bufferSize ?
+                source.pending.size() : 0;
+            isOpen = write(source.pending.data(), length);
+            source.pending.erase(0, length);
+        }
+    }
+
+    // Closing the inputs passes a broken pipe to the writers should the
+    // reader have gone, and closing the output passes the end of the data
+    for (auto&& source : _sources) {
+        close(source);
+    }
+
+    _output->outputStream().close();
+}
+
+bool PosixExecutorFanIn::write(const char* data, std::size_t length)
+{
+    while (length > 0) {
+        auto count = ::write(_sink, data, length);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (errno != EPIPE) {
+                std::perror("rshell: unable to fan in pipe");
+            }
+
+            return false;
+        }
+
+        data += count;
+        length -= count;
+    }
+
+    return true;
+}
+
+void PosixExecutorFanIn::close(Source& source)
+{
+    if (source.file < 0) {
+        return;
+    }
+
+    source.file = -1;
+    source.pending.clear();
+    source.input->inputStream().close();
+}
+
+} // namespace rshell
@@ -0,0 +1,93 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::PosixExecutorFanIn class
+
+#ifndef hpp_rshell_PosixExecutorFanIn
+#define hpp_rshell_PosixExecutorFanIn
+
+#include "ExecutorFan.hpp"
+#include "ExecutorPipe.hpp"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rshell {
+
+/// \brief Implementation of the executor fan merging several pipes into one
+/// a line at a time
+///
+/// A thread of the shell reads each input as its data arrives and writes
+/// only whole lines to the output, each batch of lines in one write, so the
+/// lines of the inputs never interleave.  The lines must be found in the
+/// data, so unlike the other fans and relays it copies the data once.  A
+/// line longer than the read buffer is written in parts, and an unfinished
+/// last line is written once its input ends.
+class PosixExecutorFanIn : public ExecutorFan
+{
+public:
+    /// \brief Constructs a new instance of the \ref PosixExecutorFanIn class
+    /// on the given pipes
+    /// \param inputs pipes whose read ends the fan takes
+    /// \param output pipe whose write end the fan takes
+    PosixExecutorFanIn(std::vector<std::shared_ptr<ExecutorPipe>> inputs,
+            std::shared_ptr<ExecutorPipe> output);
+
+    /// \brief Destructs the \ref PosixExecutorFanIn instance
+    ///
+    /// Finishes the fan if it has started.
+    virtual ~PosixExecutorFanIn();
+
+    /// \brief Starts moving data through the fan
+    virtual void start() override;
+
+    /// \brief Waits for the data through the fan to end
+    virtual void finish() override;
+
+private:
+    /// \brief Input of the fan
+    struct Source
+    {
+        std::shared_ptr<ExecutorPipe> input; //!< Pipe written by the writer
+        int file; //!< Read end of the input, or -1 once closed
+        std::string pending; //!< Unfinished line read from the input
+    };
+
+    std::vector<Source> _sources; //!< Inputs of the fan
+    std::shared_ptr<ExecutorPipe> _output; //!< Pipe read by the reader
+    int _sink; //!< Write end of the output
+    std::thread _thread; //!< Thread moving the data
+
+    /// \brief Moves data through the fan until every input ends or the
+    /// output closes
+    void run();
+
+    /// \brief Writes data to the output in full
+    /// \param data data to write
+    /// \param length length of the data in bytes
+    /// \return whether the output remains open
+    bool write(const char* data, std::size_t length);
+
+    /// \brief Closes an input that has ended
+    /// \param source input to close
+    void close(Source& source);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_PosixExecutorFanIn
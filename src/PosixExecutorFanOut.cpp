@@ -0,0 +1,249 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "PosixExecutorFanOut.hpp"
+#include "utility/block_sigpipe.hpp"
+#include "utility/make_unique.hpp"
+#include "utility/pipe_file.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+using utility::block_sigpipe;
+using utility::make_unique;
+using utility::pipe_file;
+
+namespace rshell {
+
+PosixExecutorFanOut::PosixExecutorFanOut(
+        std::shared_ptr<ExecutorPipe> input,
+        std::vector<std::shared_ptr<ExecutorPipe>> outputs)
+    : _input(std::move(input))
+    , _source(pipe_file(_input->inputStream(), "fanned"))
+{
+    // Each staging pipe must hold any chunk the input does, so it is made
+    // as large as the input
+    auto capacity = ::fcntl(_source, F_GETPIPE_SZ);
+    if (capacity < 0) {
+        std::perror("rshell: unable to get pipe capacity");
+        throw std::runtime_error{"unable to get pipe capacity"};
+    }
+
+    for (auto&& output : outputs) {
+        Branch branch;
+        branch.sink = pipe_file(output->outputStream(), "fanned");
+        branch.output = std::move(output);
+        if (outputs.size() > 1) {
+            branch.staging = make_unique<PosixExecutorPipe>(capacity);
+        }
+
+        branch.pending = 0;
+        _branches.push_back(std::move(branch));
+    }
+}
+
+PosixExecutorFanOut::~PosixExecutorFanOut()
+{
+    finish();
+    _input->inputStream().close();
+    for (auto&& branch : _branches) {
+        close(branch);
+    }
+}
+
+void PosixExecutorFanOut::start()
+{
+    _thread = std::thread{&PosixExecutorFanOut::run, this};
+}
+
+void PosixExecutorFanOut::finish()
+{
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void PosixExecutorFanOut::run()
+{
+    block_sigpipe();
+
+    while (true) {
+        pollfd entry{_source, POLLIN, 0};
+        if (::poll(&entry, 1, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            std::perror("rshell: unable to poll fanned pipe");
+            break;
+        }
+
+        // The input is readable but empty only once its writer has gone
+        int available = 0;
+        if (::ioctl(_source, FIONREAD, &available) < 0) {
+            std::perror("rshell: unable to query fanned pipe");
+            break;
+        }
+
+        if (available == 0 || !deliver(available)) {
+            break;
+        }
+    }
+
+    // Closing the input passes a broken pipe to the writer should every
+    // reader have gone, and closing the outputs passes the end of the data
+    _input->inputStream().close();
+    for (auto&& branch : _branches) {
+        close(branch);
+    }
+}
+
+bool PosixExecutorFanOut::deliver(std::size_t chunk)
+{
+    // The last open output takes the chunk out of the input itself, after
+    // every other open output has taken a copy of it
+    Branch* direct = nullptr;
+    for (auto branch = _branches.rbegin(); branch != _branches.rend();
+            ++branch) {
+        if (branch->sink >= 0) {
+            direct = &*branch;
+            break;
+        }
+    }
+
+    if (direct == nullptr) {
+        return false;
+    }
+
+    auto isFirstCopy = true;
+    for (auto&& branch : _branches) {
+        if (branch.sink < 0 || &branch == direct) {
+            continue;
+        }
+
+        // A staging pipe may hold fewer bytes than the input should the
+        // input hold many partly filled pages, so the first copy sets the
+        // size of the chunk.  The staging pipes are alike, so every later
+        // copy is of the same size
+        auto staging = pipe_file(branch.staging->outputStream(), "fanned");
+        auto count = ::tee(_source, staging, chunk, 0);
+        while (count < 0 && errno == EINTR) {
+            count = ::tee(_source, staging, chunk, 0);
+        }
+
+        if (count <= 0 || (!isFirstCopy &&
+                    static_cast<std::size_t>(count) != chunk)) {
+            std::cerr << "rshell: unable to copy fanned pipe\n";
+            close(branch);
+            continue;
+        }
+
+        chunk = count;
+        isFirstCopy = false;
+        branch.pending = count;
+    }
+
+    direct->pending = chunk;
+
+    // Move the chunk to every output at once, waiting on the outputs whose
+    // pipes are full
+    std::vector<pollfd> entries;
+    while (true) {
+        entries.clear();
+        for (auto&& branch : _branches) {
+            while (branch.sink >= 0 && branch.pending > 0) {
+                auto source = &branch == direct ? _source :
+                    pipe_file(branch.staging->inputStream(), "fanned");
+                auto count = ::splice(source, nullptr, branch.sink, nullptr,
+                        branch.pending, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+                if (count > 0) {
+                    branch.pending -= count;
+                    continue;
+                }
+
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+
+                if (count < 0 && errno == EAGAIN) {
+                    entries.push_back({branch.sink, POLLOUT, 0});
+                    break;
+                }
+
+                if (count < 0 && errno != EPIPE) {
+                    std::perror("rshell: unable to fan out pipe");
+                }
+
+                // The rest of the chunk must still leave the input, lest the
+                // next chunk repeat it to the other outputs
+                if (&branch == direct) {
+                    char buffer[4096];
+                    while (branch.pending > 0) {
+                        auto length = std::min(branch.pending,
+                                sizeof(buffer));
+                        count = ::read(_source, buffer, length);
+                        if (count == 0 || (count < 0 && errno != EINTR)) {
+                            break;
+                        }
+
+                        branch.pending -= std::max<ssize_t>(count, 0);
+                    }
+                }
+
+                close(branch);
+            }
+        }
+
+        if (entries.empty()) {
+            break;
+        }
+
+        if (::poll(entries.data(), entries.size(), -1) < 0 &&
+                errno != EINTR) {
+            std::perror("rshell: unable to poll fanned pipes");
+            return false;
+        }
+    }
+
+    for (auto&& branch : _branches) {
+        if (branch.sink >= 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void PosixExecutorFanOut::close(Branch& branch)
+{
+    if (branch.sink < 0) {
+        return;
+    }
+
+    branch.sink = -1;
+    branch.pending = 0;
+    branch.output->outputStream().close();
+    branch.staging.reset();
+}
+
+} // namespace rshell
@@ -0,0 +1,94 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::PosixExecutorFanOut class
+
+#ifndef hpp_rshell_PosixExecutorFanOut
+#define hpp_rshell_PosixExecutorFanOut
+
+#include "ExecutorFan.hpp"
+#include "PosixExecutorPipe.hpp"
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace rshell {
+
+/// \brief Implementation of the executor fan duplicating one pipe into
+/// several on top of tee and splice
+///
+/// A thread of the shell takes the data waiting in the input pipe as a
+/// chunk, duplicates it with tee into an empty staging pipe for every
+/// output but one, then moves the chunk out of the input to that output
+/// and out of each staging pipe to its output with splice.  Pages are
+/// shared between the pipes rather than copied.  Each chunk is delivered to
+/// every output before the next is taken, so the slowest reader sets the
+/// pace, as with tee(1).
+class PosixExecutorFanOut : public ExecutorFan
+{
+public:
+    /// \brief Constructs a new instance of the \ref PosixExecutorFanOut class
+    /// on the given pipes
+    /// \param input pipe whose read end the fan takes
+    /// \param outputs pipes whose write ends the fan takes
+    PosixExecutorFanOut(std::shared_ptr<ExecutorPipe> input,
+            std::vector<std::shared_ptr<ExecutorPipe>> outputs);
+
+    /// \brief Destructs the \ref PosixExecutorFanOut instance
+    ///
+    /// Finishes the fan if it has started.
+    virtual ~PosixExecutorFanOut();
+
+    /// \brief Starts moving data through the fan
+    virtual void start() override;
+
+    /// \brief Waits for the data through the fan to end
+    virtual void finish() override;
+
+private:
+    /// \brief Output of the fan
+    struct Branch
+    {
+        std::shared_ptr<ExecutorPipe> output; //!< Pipe read by the reader
+        std::unique_ptr<PosixExecutorPipe> staging; //!< Private copy
+        int sink; //!< Write end of the output, or -1 once closed
+        std::size_t pending; //!< Bytes of the chunk yet to be delivered
+    };
+
+    std::shared_ptr<ExecutorPipe> _input; //!< Pipe written by the writer
+    int _source; //!< Read end of the input
+    std::vector<Branch> _branches; //!< Outputs of the fan
+    std::thread _thread; //!< Thread moving the data
+
+    /// \brief Moves data through the fan until the input ends or every
+    /// output has closed
+    void run();
+
+    /// \brief Delivers a chunk waiting in the input to every output
+    /// \param chunk size of the chunk in bytes
+    /// \return whether any output remains open
+    bool deliver(std::size_t chunk);
+
+    /// \brief Closes an output whose reader has gone
+    /// \param branch output to close
+    void close(Branch& branch);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_PosixExecutorFanOut
@@ -0,0 +1,187 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "PosixExecutorFileCache.hpp"
+#include "PosixExecutorCachedStream.hpp"
+#include "utility/make_unique.hpp"
+#include "utility/raise_descriptor.hpp"
+#include <cerrno>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using utility::make_unique;
+
+namespace {
+
+/// \brief Path of the null device, which every redirection shares
+const char* const nullPath = "/dev/null";
+
+/// \brief Gets the mode of a stream on a file opened with the given flags
+/// \param flags flags the file was opened with
+/// \return mode of the stream
+rshell::ExecutorStream::Mode modeOf(int flags)
+{
+    return (flags & O_ACCMODE) == O_RDONLY ?
+        rshell::ExecutorStream::Mode::Input :
+        rshell::ExecutorStream::Mode::Output;
+}
+
+}
+
+namespace rshell {
+
+constexpr std::size_t PosixExecutorFileCache::limit;
+
+PosixExecutorFileCache::Entry::~Entry()
+{
+    ::close(file);
+}
+
+PosixExecutorFileCache::PosixExecutorFileCache()
+    : _pid{::getpid()}
+{
+}
+
+std::unique_ptr<ExecutorStream> PosixExecutorFileCache::open(
+        const std::string& path, int flags)
+{
+    if (::getpid() != _pid) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto mode = modeOf(flags);
+    if (path == nullPath) {
+        if (_null == nullptr) {
+            _null = openEntry(path, O_RDWR);
+            if (_null == nullptr) {
+                return nullptr;
+            }
+        }
+
+        return make_unique<PosixExecutorCachedStream>(_null, mode);
+    }
+
+    // Truncating a file is the point of opening it, so it is never cached
+    if ((flags & O_TRUNC) != 0) {
+        return nullptr;
+    }
+
+    // A cached file is reused only while the path still names it
+    auto key = Key{path, flags};
+    auto found = _entries.find(key);
+    if (found != std::end(_entries)) {
+        auto& entry = found->second;
+        struct stat status;
+        if (::stat(path.c_str(), &status) == 0 &&
+                status.st_dev == entry->device &&
+                status.st_ino == entry->inode) {
+            if (mode == ExecutorStream::Mode::Output) {
+                return make_unique<PosixExecutorCachedStream>(entry, mode);
+            }
+
+            // Another command still reading the file holds its position
+            if (entry.use_count() > 1 ||
+                    ::lseek(entry->file, 0, SEEK_SET) != 0) {
+                return nullptr;
+            }
+
+            return make_unique<PosixExecutorCachedStream>(entry, mode);
+        }
+
+        _entries.erase(found);
+    }
+
+    auto entry = openEntry(path, flags);
+    if (entry == nullptr) {
+        return nullptr;
+    }
+
+    // Only regular files are cached, as opening a device or FIFO may have
+    // effects of its own.  Uncached files close with their last stream
+    struct stat status;
+    if (::fstat(entry->file, &status) == 0 && S_ISREG(status.st_mode)) {
+        if (_entries.size() >= limit) {
+            evict();
+        }
+
+        if (_entries.size() < limit) {
+            _entries[key] = entry;
+        }
+    }
+
+    return make_unique<PosixExecutorCachedStream>(std::move(entry), mode);
+}
+
+void PosixExecutorFileCache::forget(const Entry& entry)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    for (auto iter = std::begin(_entries); iter != std::end(_entries);
+            ++iter) {
+        if (iter->second.get() == &entry) {
+            _entries.erase(iter);
+            return;
+        }
+    }
+}
+
+void PosixExecutorFileCache::flush()
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    evict();
+}
+
+std::shared_ptr<PosixExecutorFileCache::Entry>
+PosixExecutorFileCache::openEntry(const std::string& path, int flags)
+{
+    auto file = utility::raise_descriptor(::open(path.c_str(),
+                flags | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH));
+    if (file < 0 && (errno == EMFILE || errno == ENFILE)) {
+        evict();
+        file = utility::raise_descriptor(::open(path.c_str(),
+                    flags | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP |
+                    S_IROTH));
+    }
+
+    struct stat status;
+    if (file < 0) {
+        return nullptr;
+    }
+
+    if (::fstat(file, &status) != 0) {
+        ::close(file);
+        return nullptr;
+    }
+
+    return std::shared_ptr<Entry>{
+        new Entry{file, status.st_dev, status.st_ino}};
+}
+
+void PosixExecutorFileCache::evict()
+{
+    for (auto iter = std::begin(_entries); iter != std::end(_entries); ) {
+        if (iter->second.use_count() == 1) {
+            iter = _entries.erase(iter);
+        }
+        else {
+            ++iter;
+        }
+    }
+}
+
+} // namespace rshell
@@ -0,0 +1,110 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::PosixExecutorFileCache
+/// class
+
+#ifndef hpp_rshell_PosixExecutorFileCache
+#define hpp_rshell_PosixExecutorFileCache
+
+#include "ExecutorStream.hpp"
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <sys/types.h>
+
+namespace rshell {
+
+/// \brief Cache of the descriptors of files that redirections open again
+/// and again, such as ">> log" on every line of a script
+///
+/// Files opened for appending or reading are kept open by path, and
+/// revalidated on each reuse by comparing the device and inode the path
+/// names now with those of the open file, so that a renamed, removed, or
+/// replaced file is opened afresh.  Appending shares a descriptor freely,
+/// as every write goes to the end of the file.  Reading does not, as the
+/// position is shared: a descriptor is rewound and reused only when no
+/// command holds it, otherwise the file is opened independently.  A single
+/// descriptor of /dev/null serves every redirection to or from it.
+///
+/// Only the process that created the cache uses it, so a forked subshell
+/// never moves the position of a descriptor the shell hands out.
+class PosixExecutorFileCache
+{
+public:
+    /// \brief Open file held by the cache and the streams that use it
+    struct Entry
+    {
+        int file; //!< File descriptor
+        dev_t device; //!< Device of the file
+        ino_t inode; //!< Inode of the file
+
+        /// \brief Closes the file descriptor
+        ~Entry();
+    };
+
+    /// \brief Maximum number of files held open by the cache
+    static constexpr std::size_t limit = 64;
+
+    /// \brief Constructs a new instance of the \ref PosixExecutorFileCache
+    /// class for the calling process
+    PosixExecutorFileCache();
+
+    PosixExecutorFileCache(const PosixExecutorFileCache&) = delete;
+    PosixExecutorFileCache& operator=(const PosixExecutorFileCache&) = delete;
+
+    /// \brief Gets a stream on a cached file
+    /// \param path path of the file
+    /// \param flags flags to open the file with, as given to open
+    /// \return stream on the file, or \c null if the file must be opened
+    /// independently
+    std::unique_ptr<ExecutorStream> open(const std::string& path, int flags);
+
+    /// \brief Removes a file from the cache, so that it is never handed out
+    /// again, as when the shell keeps it on a descriptor of its own
+    /// \param entry file to remove
+    void forget(const Entry& entry);
+
+    /// \brief Closes every cached file no stream holds
+    void flush();
+
+private:
+    /// \brief Type of key of a cached file, its path and open flags
+    using Key = std::pair<std::string, int>;
+
+    std::map<Key, std::shared_ptr<Entry>> _entries; //!< Cached files
+    std::shared_ptr<Entry> _null; //!< Descriptor of /dev/null, if opened
+    std::mutex _mutex; //!< Mutex guarding the cache
+    pid_t _pid; //!< Process identifier of the process using the cache
+
+    /// \brief Opens a file to cache, making room for it if the process is
+    /// out of descriptors
+    /// \param path path of the file
+    /// \param flags flags to open the file with
+    /// \return open file, or \c null on failure
+    std::shared_ptr<Entry> openEntry(const std::string& path, int flags);
+
+    /// \brief Closes every cached file no stream holds, with the mutex held
+    void evict();
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_PosixExecutorFileCache
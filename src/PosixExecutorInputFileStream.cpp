@@ -15,6 +15,7 @@
 // SOFTWARE.
 
 #include "PosixExecutorInputFileStream.hpp"
+#include "utility/raise_descriptor.hpp"
 #include <cstdlib>
 #include <stdexcept>
 #include <fcntl.h>
@@ -27,7 +28,8 @@ namespace rshell {
 PosixExecutorInputFileStream::PosixExecutorInputFileStream(
         const std::string& path)
     : ExecutorStream{Mode::Input}
-    , _file(::open(path.c_str(), O_RDONLY))
+    , _file(utility::raise_descriptor(::open(path.c_str(),
+                    O_RDONLY | O_CLOEXEC)))
 {
     if (_file == -1) {
         std::perror("rshell: unable to open input file");
@@ -40,14 +42,17 @@ PosixExecutorInputFileStream::~PosixExecutorInputFileStream()
     close();
 }
 
-void PosixExecutorInputFileStream::activate(Executor& executor)
+void PosixExecutorInputFileStream::activate(int slot)
 {
-    ::dup2(_file, STDIN_FILENO);
+    ::dup2(_file, slot);
 }
 
 void PosixExecutorInputFileStream::close()
 {
-    ::close(_file);
+    if (_file >= 0) {
+        ::close(_file);
+        _file = -1;
+    }
 }
 
 } // namespace rshell
@@ -0,0 +1,244 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "PosixExecutorJob.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+/// \brief Converts a time value from resource usage into a duration
+/// \param time time value to convert
+/// \return equivalent duration
+std::chrono::nanoseconds durationOf(const timeval& time)
+{
+    return std::chrono::seconds{time.tv_sec} +
+        std::chrono::microseconds{time.tv_usec};
+}
+
+}
+
+namespace rshell {
+
+PosixExecutorJob::PosixExecutorJob(pid_t pid,
+        std::chrono::steady_clock::time_point started, ino_t inputPipe,
+        std::chrono::steady_clock::time_point deadline, bool isGroupLeader)
+    : _pid{pid}
+    , _started{started}
+    , _inputPipe{inputPipe}
+    , _deadline{deadline}
+    , _killTime{std::chrono::steady_clock::time_point::max()}
+    , _isGroupLeader{isGroupLeader}
+{
+#ifdef SYS_pidfd_open
+    // A process descriptor allows the executor to wait for several jobs at
+    // once without reaping the children of other commands
+    _file = static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+#endif
+
+    // The thread waiting for the child is woken when another cancels it, so
+    // that it may kill the child should it not exit in time
+    if (_file >= 0) {
+        _cancelFile = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    }
+}
+
+PosixExecutorJob::~PosixExecutorJob()
+{
+    if (_pid > 0) {
+        int status;
+        waitpid(_pid, &status, WNOHANG);
+    }
+
+    if (_file >= 0) {
+        ::close(_file);
+    }
+
+    if (_cancelFile >= 0) {
+        ::close(_cancelFile);
+    }
+}
+
+JobStatus PosixExecutorJob::wait()
+{
+    if (_pid <= 0) {
+        throw std::runtime_error{"job has already been waited for"};
+    }
+
+    // Until the child exits, wake at each time it must be signalled and on
+    // cancellation, on its process descriptor if it has one and by polling
+    // it otherwise
+    int status;
+    rusage usage;
+    pid_t result = 0;
+    while (result == 0) {
+        auto now = std::chrono::steady_clock::now();
+        auto next = nextSignal();
+        auto isScheduled =
+            next != std::chrono::steady_clock::time_point::max();
+        if (now >= next) {
+            expire();
+            continue;
+        }
+
+        if (_file >= 0) {
+            auto timeout = -1;
+            if (isScheduled) {
+                auto remaining = std::chrono::duration_cast<
+                    std::chrono::milliseconds>(next - now) +
+                    std::chrono::milliseconds{1};
+                timeout = static_cast<int>(
+                        std::min<long long>(remaining.count(), 60000));
+            }
+
+            pollfd entries[] = {{_file, POLLIN, 0}, {_cancelFile, POLLIN, 0}};
+            auto count = ::poll(entries, _cancelFile >= 0 ? 2 : 1, timeout);
+            if (count < 0 && errno != EINTR) {
+                break;
+            }
+
+            if (count > 0 && entries[1].revents != 0) {
+                eventfd_t value;
+                ::eventfd_read(_cancelFile, &value);
+                if (!_isTerminating) {
+                    terminate();
+                }
+            }
+
+            if (count > 0 && entries[0].revents != 0) {
+                break;
+            }
+        }
+        else if (!isScheduled) {
+            break;
+        }
+        else {
+            result = ::wait4(_pid, &status, WNOHANG, &usage);
+            if (result < 0 && errno == EINTR) {
+                result = 0;
+            }
+            else if (result == 0) {
+                ::usleep(1000);
+            }
+        }
+    }
+
+    while (result == 0 && (result = ::wait4(_pid, &status, 0, &usage)) < 0 &&
+            errno == EINTR) {
+        result = 0;
+    }
+
+    if (result < 0) {
+        std::perror("rshell: wait failed");
+        throw std::runtime_error{"error while waiting"};
+    }
+
+    // Members of a terminated group that ignored the signal may outlive its
+    // leader, and are killed along with it.  The group outlives the leader
+    // while it has members, so its identifier is not yet reused
+    if (_isGroupLeader && (_isTerminating || _isCancelled)) {
+        ::kill(-_pid, SIGKILL);
+    }
+
+    _pid = -1;
+
+    JobStatus jobStatus;
+    jobStatus.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) :
+        128 + WTERMSIG(status);
+    if (_isTimedOut) {
+        jobStatus.exitCode = timeoutExitCode;
+    }
+
+    jobStatus.wallTime = std::chrono::steady_clock::now() - _started;
+    jobStatus.userTime = durationOf(usage.ru_utime);
+    jobStatus.systemTime = durationOf(usage.ru_stime);
+    return jobStatus;
+}
+
+void PosixExecutorJob::cancel()
+{
+    // The waiting thread escalates to killing the child, as for a passed
+    // deadline, once woken
+    _isCancelled = true;
+    if (_cancelFile >= 0) {
+        ::eventfd_write(_cancelFile, 1);
+    }
+
+    signal(SIGTERM);
+}
+
+void PosixExecutorJob::retain(std::shared_ptr<void> resource)
+{
+    _resources.push_back(std::move(resource));
+}
+
+void PosixExecutorJob::expire()
+{
+    if (!_isTerminating) {
+        _isTimedOut = true;
+        terminate();
+    }
+    else {
+        _killTime = std::chrono::steady_clock::time_point::max();
+        signal(SIGKILL);
+    }
+}
+
+void PosixExecutorJob::terminate()
+{
+    _isTerminating = true;
+    _killTime = std::chrono::steady_clock::now() + terminationGrace;
+    signal(SIGTERM);
+}
+
+void PosixExecutorJob::signal(int signal)
+{
+    // The members of a group are signalled along with its leader until the
+    // leader is reaped, after which its identifier may be reused
+    if (_isGroupLeader) {
+        if (_pid > 0) {
+            ::kill(-_pid, signal);
+        }
+
+        return;
+    }
+
+    // The process descriptor names the child even once another thread has
+    // reaped it, where its identifier may have been reused
+#ifdef SYS_pidfd_send_signal
+    if (_file >= 0) {
+        ::syscall(SYS_pidfd_send_signal, _file, signal, nullptr, 0);
+        return;
+    }
+#endif
+
+    if (_pid > 0) {
+        ::kill(_pid, signal);
+    }
+}
+
+} // namespace rshell
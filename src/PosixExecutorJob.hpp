@@ -0,0 +1,125 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::PosixExecutorJob class
+
+#ifndef hpp_rshell_PosixExecutorJob
+#define hpp_rshell_PosixExecutorJob
+
+#include "ExecutorJob.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <sys/types.h>
+
+namespace rshell {
+
+/// \brief Implementation of the executor job on a forked child process
+class PosixExecutorJob : public ExecutorJob
+{
+public:
+    /// \brief Constructs a new instance of the \ref PosixExecutorJob class on
+    /// a child process
+    /// \param pid process identifier of the child
+    /// \param started time at which the child was forked
+    /// \param inputPipe inode of the pipe joined to the standard input of
+    /// the child, or zero if it is not to be observed
+    /// \param deadline time by which the child must exit, if any
+    /// \param isGroupLeader whether or not the child leads a process group
+    /// of its own, which is signalled as a whole
+    PosixExecutorJob(pid_t pid, std::chrono::steady_clock::time_point started,
+            ino_t inputPipe = 0,
+            std::chrono::steady_clock::time_point deadline =
+                std::chrono::steady_clock::time_point::max(),
+            bool isGroupLeader = false);
+
+    /// \brief Destructs the \ref PosixExecutorJob instance
+    ///
+    /// Reaps the child if it has already exited.
+    virtual ~PosixExecutorJob();
+
+    PosixExecutorJob(const PosixExecutorJob&) = delete;
+    PosixExecutorJob& operator=(const PosixExecutorJob&) = delete;
+
+    /// \brief Gets a descriptor which becomes readable once the child exits
+    /// \return process descriptor of the child, or -1 if unsupported
+    int file() const noexcept { return _file; }
+
+    /// \brief Gets the pipe joined to the standard input of the child
+    /// \return inode of the pipe, or zero if it is not to be observed
+    ino_t inputPipe() const noexcept { return _inputPipe; }
+
+    /// \brief Gets the time at which the child must next be signalled for
+    /// passing its deadline
+    /// \return time of the next signal, or the latest representable time if
+    /// there is none
+    std::chrono::steady_clock::time_point nextSignal() const noexcept
+    {
+        return _isTerminating ? _killTime : _deadline;
+    }
+
+    /// \brief Signals the child for passing its deadline
+    ///
+    /// The first call terminates the child, and the next, once the grace
+    /// period has passed, kills it.
+    void expire();
+
+    /// \brief Waits for the child to exit, signalling it once it passes its
+    /// deadline
+    /// \return status of the child, including its resource usage, with
+    /// \ref timeoutExitCode as the exit code if it passed its deadline
+    virtual JobStatus wait() override;
+
+    /// \brief Terminates the child, then kills it if it has not exited once
+    /// the grace period has passed
+    ///
+    /// A child leading a process group is signalled along with its group,
+    /// whose remaining members are killed once the grace period has passed.
+    virtual void cancel() override;
+
+    /// \brief Keeps the given resource alive until the job is destroyed
+    /// \param resource resource the child uses, such as a cached file it
+    /// reads
+    void retain(std::shared_ptr<void> resource);
+
+private:
+    pid_t _pid; //!< Process identifier of the child, or -1 once reaped
+    int _file{-1}; //!< Process descriptor of the child, if any
+    int _cancelFile{-1}; //!< Event descriptor signalled on cancellation
+    std::chrono::steady_clock::time_point _started; //!< Time of the fork
+    ino_t _inputPipe; //!< Pipe joined to the standard input, if observed
+    std::chrono::steady_clock::time_point _deadline; //!< Time to terminate
+    std::chrono::steady_clock::time_point _killTime; //!< Time to kill
+    bool _isGroupLeader; //!< Whether or not the child leads its group
+    bool _isTimedOut{false}; //!< Whether or not the deadline has passed
+    bool _isTerminating{false}; //!< Whether or not the child is terminated
+    std::atomic<bool> _isCancelled{false}; //!< Whether or not cancelled
+    std::vector<std::shared_ptr<void>> _resources; //!< Retained resources
+
+    /// \brief Terminates the child, and schedules it to be killed once the
+    /// grace period has passed
+    void terminate();
+
+    /// \brief Sends a signal to the child, and to its group if it leads one
+    /// \param signal signal to send
+    void signal(int signal);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_PosixExecutorJob
@@ -15,6 +15,7 @@
 // SOFTWARE.
 
 #include "PosixExecutorOutputFileStream.hpp"
+#include "utility/raise_descriptor.hpp"
 #include <cstdlib>
 #include <stdexcept>
 #include <fcntl.h>
@@ -27,7 +28,9 @@ namespace rshell {
 PosixExecutorOutputFileStream::PosixExecutorOutputFileStream(
         const std::string& path)
     : ExecutorStream{Mode::Output}
-    , _file(::creat(path.c_str(), S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH))
+    , _file(utility::raise_descriptor(::open(path.c_str(),
+                    O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)))
 {
     if (_file == -1) {
         std::perror("rshell: unable to open output file");
@@ -40,14 +43,17 @@ PosixExecutorOutputFileStream::~PosixExecutorOutputFileStream()
     close();
 }
 
-void PosixExecutorOutputFileStream::activate(Executor& executor)
+void PosixExecutorOutputFileStream::activate(int slot)
 {
-    ::dup2(_file, STDOUT_FILENO);
+    ::dup2(_file, slot);
 }
 
 void PosixExecutorOutputFileStream::close()
 {
-    ::close(_file);
+    if (_file >= 0) {
+        ::close(_file);
+        _file = -1;
+    }
 }
 
 } // namespace rshell
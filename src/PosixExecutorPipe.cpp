@@ -15,20 +15,75 @@
 // SOFTWARE.
 
 #include "PosixExecutorPipe.hpp"
+#include "utility/raise_descriptor.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <stdexcept>
+#include <fcntl.h>
+#include <sys/resource.h>
 #include <unistd.h>
 
+namespace {
+
+/// \brief Raises the soft limit on open descriptors of the shell to its
+/// hard limit
+/// \return whether or not the limit was raised
+bool raiseFileLimit()
+{
+    struct rlimit limit;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) != 0 ||
+            limit.rlim_cur == limit.rlim_max) {
+        return false;
+    }
+
+    limit.rlim_cur = limit.rlim_max;
+    return ::setrlimit(RLIMIT_NOFILE, &limit) == 0;
+}
+
+}
+
 namespace rshell {
 
-PosixExecutorPipe::PosixExecutorPipe()
+PosixExecutorPipe::PosixExecutorPipe(std::size_t capacity)
     : _inputStream{*this, _files[0], ExecutorStream::Mode::Input}
     , _outputStream{*this, _files[1], ExecutorStream::Mode::Output}
 {
-    if (::pipe(_files) != 0) {
+    // Both ends are closed on exec so that executed programs only inherit
+    // the ends activated on their standard streams.  Should the shell run
+    // out of descriptors, as with many pipelines started at once, raise its
+    // limit and try again
+    auto result = ::pipe2(_files, O_CLOEXEC);
+    if (result != 0 && errno == EMFILE && raiseFileLimit()) {
+        result = ::pipe2(_files, O_CLOEXEC);
+    }
+
+    if (result == 0) {
+        _files[0] = utility::raise_descriptor(_files[0]);
+        _files[1] = utility::raise_descriptor(_files[1]);
+        if (_files[0] < 0 || _files[1] < 0) {
+            close();
+            result = -1;
+        }
+    }
+
+    if (result != 0) {
         std::perror("rshell: unable to pipe");
         throw std::runtime_error{"unable to pipe"};
     }
+
+    // A larger pipe lets a fast writer run further ahead of its reader, so
+    // both switch contexts less often.  The system may refuse to grow the
+    // pipe once a user has too many large pipes, which is not an error
+    if (capacity > 0) {
+        auto size = std::min(capacity, maximumCapacity());
+        if (::fcntl(_files[1], F_SETPIPE_SZ, static_cast<int>(size)) < 0 &&
+                errno != EPERM) {
+            std::perror("rshell: unable to resize pipe");
+        }
+    }
 }
 
 PosixExecutorPipe::~PosixExecutorPipe()
@@ -38,8 +93,22 @@ PosixExecutorPipe::~PosixExecutorPipe()
 
 void PosixExecutorPipe::close()
 {
-    ::close(_files[0]);
-    ::close(_files[1]);
+    _inputStream.close();
+    _outputStream.close();
+}
+
+std::size_t PosixExecutorPipe::maximumCapacity()
+{
+    static const auto capacity = []
+    {
+        // Only privileged processes may exceed the configured maximum
+        std::size_t size = 1048576;
+        std::ifstream input{"/proc/sys/fs/pipe-max-size"};
+        input >> size;
+        return size;
+    }();
+
+    return capacity;
 }
 
 } // namespace rshell
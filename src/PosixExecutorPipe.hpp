@@ -22,6 +22,7 @@
 
 #include "ExecutorPipe.hpp"
 #include "PosixExecutorPipeStream.hpp"
+#include <cstddef>
 
 namespace rshell {
 
@@ -31,7 +32,11 @@ class PosixExecutorPipe : public ExecutorPipe
 {
 public:
     /// \brief Constructs a new instance of the \ref PosixExecutorPipe class
-    explicit PosixExecutorPipe();
+    /// \param capacity capacity of the pipe in bytes, or zero for the
+    /// default of the system
+    ///
+    /// Capacities beyond the maximum of the system are reduced to it.
+    explicit PosixExecutorPipe(std::size_t capacity = 0);
 
     /// \brief Destructs the \ref PosixExecutorPipe instance
     virtual ~PosixExecutorPipe();
@@ -47,6 +52,10 @@ public:
     /// \brief Closes the pipe
     void close();
 
+    /// \brief Gets the maximum capacity of a pipe allowed by the system
+    /// \return maximum capacity in bytes
+    static std::size_t maximumCapacity();
+
 protected:
     int _files[2]; //!< File descriptors for the pipe streams
     PosixExecutorPipeStream _inputStream; //!< Stream for read end of pipe
@@ -0,0 +1,330 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "PosixExecutorPipeBuffer.hpp"
+#include "utility/block_sigpipe.hpp"
+#include "utility/pipe_file.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using utility::block_sigpipe;
+using utility::pipe_file;
+
+namespace {
+
+/// \brief Bytes moved between the file and memory at once, and the unit in
+/// which space in the file is released
+constexpr std::size_t spillChunkSize = 1048576;
+
+/// \brief Creates an anonymous file to spill data to
+/// \return descriptor of the file, or -1 on failure
+int createSpillFile()
+{
+    // A memfd lives in memory the system may swap out, and needs no
+    // writable directory.  Otherwise, an unnamed file in the temporary
+    // directory is removed along with its last descriptor
+#ifdef SYS_memfd_create
+    auto file = static_cast<int>(::syscall(SYS_memfd_create, "rshell-buffer",
+                1u /* MFD_CLOEXEC */));
+    if (file >= 0) {
+        return file;
+    }
+#endif
+
+#ifdef O_TMPFILE
+    auto directory = std::getenv("TMPDIR");
+    return ::open(directory != nullptr ? directory : "/tmp",
+            O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+#else
+    return -1;
+#endif
+}
+
+}
+
+namespace rshell {
+
+PosixExecutorPipeBuffer::PosixExecutorPipeBuffer(
+        std::shared_ptr<ExecutorPipe> input,
+        std::shared_ptr<ExecutorPipe> output, std::size_t memoryLimit)
+    : _input(std::move(input))
+    , _output(std::move(output))
+    , _source(pipe_file(_input->inputStream(), "buffered"))
+    , _sink(pipe_file(_output->outputStream(), "buffered"))
+    , _memoryLimit(memoryLimit)
+{
+}
+
+PosixExecutorPipeBuffer::~PosixExecutorPipeBuffer()
+{
+    finish();
+    closeInput();
+    closeOutput();
+    if (_spill >= 0) {
+        ::close(_spill);
+    }
+}
+
+void PosixExecutorPipeBuffer::start()
+{
+    _thread = std::thread{&PosixExecutorPipeBuffer::run, this};
+}
+
+void PosixExecutorPipeBuffer::finish()
+{
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void PosixExecutorPipeBuffer::run()
+{
+    block_sigpipe();
+
+    // The output is written only as far as it has room, so that the input
+    // is read again as soon as it holds data
+    ::fcntl(_sink, F_SETFL, ::fcntl(_sink, F_GETFL) | O_NONBLOCK);
+
+    std::vector<pollfd> entries;
+    while (true) {
+        entries.clear();
+        if (_source >= 0 && _stalled.empty()) {
+            entries.push_back({_source, POLLIN, 0});
+        }
+
+        auto isEmpty = _chunks.empty() && _spillBegin == _spillEnd &&
+            _stalled.empty();
+        if (_sink >= 0 && !isEmpty) {
+            entries.push_back({_sink, POLLOUT, 0});
+        }
+
+        if (entries.empty()) {
+            break;
+        }
+
+        if (::poll(entries.data(), entries.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            std::perror("rshell: unable to poll buffered pipes");
+            break;
+        }
+
+        for (auto&& entry : entries) {
+            if (entry.revents == 0) {
+                continue;
+            }
+
+            if (entry.fd == _source) {
+                fill();
+            }
+            else if (entry.fd == _sink) {
+                drain();
+            }
+        }
+    }
+
+    // Closing the output passes the end of the data to the reader, and
+    // closing the input passes a broken pipe to the writer should the
+    // reader have gone
+    closeInput();
+    closeOutput();
+}
+
+void PosixExecutorPipeBuffer::fill()
+{
+    // Take everything waiting in the input at once, within reason
+    int available = 0;
+    ::ioctl(_source, FIONREAD, &available);
+    std::vector<char> data(std::min<std::size_t>(
+                std::max(available, 65536), spillChunkSize));
+
+    auto count = ::read(_source, data.data(), data.size());
+    if (count > 0) {
+        data.resize(count);
+        hold(std::move(data));
+        return;
+    }
+
+    if (count < 0 && (errno == EINTR || errno == EAGAIN)) {
+        return;
+    }
+
+    if (count < 0) {
+        std::perror("rshell: unable to read buffered pipe");
+    }
+
+    closeInput();
+}
+
+void PosixExecutorPipeBuffer::drain()
+{
+    while (_sink >= 0) {
+        if (_chunks.empty() && !unspill()) {
+            break;
+        }
+
+        auto& chunk = _chunks.front();
+        auto count = ::write(_sink, chunk.data() + _chunkOffset,
+                chunk.size() - _chunkOffset);
+        if (count > 0) {
+            _chunkOffset += count;
+            _memorySize -= count;
+            if (_chunkOffset == chunk.size()) {
+                _chunks.pop_front();
+                _chunkOffset = 0;
+            }
+
+            continue;
+        }
+
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (count < 0 && errno == EAGAIN) {
+            break;
+        }
+
+        if (count < 0 && errno != EPIPE) {
+            std::perror("rshell: unable to write buffered pipe");
+        }
+
+        // Without a reader, the rest of the data is not needed
+        closeOutput();
+        closeInput();
+    }
+}
+
+void PosixExecutorPipeBuffer::hold(std::vector<char> data)
+{
+    // Data goes to memory until the limit, then to the file until the file
+    // has been emptied, so that it leaves in the order it arrived
+    if (_spillBegin == _spillEnd && (_memorySize < _memoryLimit ||
+                (_spill < 0 && (_spill = createSpillFile()) < 0))) {
+        if (_spill < 0 && _memorySize >= _memoryLimit) {
+            // Holding the data in memory is better than blocking the writer
+            std::perror("rshell: unable to create buffer file");
+            _memoryLimit = static_cast<std::size_t>(-1);
+        }
+
+        _memorySize += data.size();
+        _chunks.push_back(std::move(data));
+        return;
+    }
+
+    std::size_t written = 0;
+    while (written < data.size()) {
+        auto count = ::pwrite(_spill, data.data() + written,
+                data.size() - written, _spillEnd);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (count <= 0) {
+            // Pause reading until the file has been emptied
+            std::perror("rshell: unable to spill buffered pipe");
+            _stalled.assign(std::begin(data) + written, std::end(data));
+            return;
+        }
+
+        written += count;
+        _spillEnd += count;
+    }
+}
+
+bool PosixExecutorPipeBuffer::unspill()
+{
+    if (_spillBegin == _spillEnd) {
+        // The data stalled when the file was full follows the data that
+        // was in the file
+        if (_stalled.empty()) {
+            return false;
+        }
+
+        _memorySize += _stalled.size();
+        _chunks.push_back(std::move(_stalled));
+        _stalled.clear();
+        return true;
+    }
+
+    std::vector<char> data(std::min<std::size_t>(_spillEnd - _spillBegin,
+                spillChunkSize));
+    auto count = ::pread(_spill, data.data(), data.size(), _spillBegin);
+    while (count < 0 && errno == EINTR) {
+        count = ::pread(_spill, data.data(), data.size(), _spillBegin);
+    }
+
+    if (count <= 0) {
+        std::perror("rshell: unable to read buffer file");
+        closeOutput();
+        closeInput();
+        return false;
+    }
+
+    data.resize(count);
+    _spillBegin += count;
+    _memorySize += count;
+    _chunks.push_back(std::move(data));
+
+    // Release the space of the data read back, all of it once the file is
+    // empty, so that the file never holds more than the data in flight
+    if (_spillBegin == _spillEnd) {
+        if (::ftruncate(_spill, 0) == 0) {
+            _spillBegin = _spillEnd = _spillReleased = 0;
+        }
+    }
+    else if (_spillBegin - _spillReleased >=
+            static_cast<off_t>(spillChunkSize)) {
+        ::fallocate(_spill, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                _spillReleased, _spillBegin - _spillReleased);
+        _spillReleased = _spillBegin;
+    }
+
+    return true;
+}
+
+void PosixExecutorPipeBuffer::closeInput()
+{
+    if (_source >= 0) {
+        _source = -1;
+        _input->inputStream().close();
+    }
+}
+
+void PosixExecutorPipeBuffer::closeOutput()
+{
+    if (_sink >= 0) {
+        _sink = -1;
+        _output->outputStream().close();
+        _chunks.clear();
+        _chunkOffset = 0;
+        _memorySize = 0;
+        _stalled.clear();
+        _spillBegin = _spillEnd;
+    }
+}
+
+} // namespace rshell
@@ -0,0 +1,110 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the
+/// \ref rshell::PosixExecutorPipeBuffer class
+
+#ifndef hpp_rshell_PosixExecutorPipeBuffer
+#define hpp_rshell_PosixExecutorPipeBuffer
+
+#include "ExecutorPipe.hpp"
+#include "ExecutorPipeBuffer.hpp"
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+
+namespace rshell {
+
+/// \brief Implementation of the executor pipe buffer holding data in memory
+/// and spilling the excess to an anonymous file
+///
+/// A thread of the shell reads the first pipe whenever it holds data and
+/// writes the second whenever it has room.  Up to the memory limit, the data
+/// in between is held in memory; beyond it, newer data is appended to a
+/// memfd, or an unnamed temporary file where memfds are unavailable, and is
+/// read back once the data in memory has been written.  Space in the file
+/// is released as its data is written.  Should the file be unable to take
+/// more data, reading pauses until the data in the file has been written.
+class PosixExecutorPipeBuffer : public ExecutorPipeBuffer
+{
+public:
+    /// \brief Constructs a new instance of the \ref PosixExecutorPipeBuffer
+    /// class on the given pipes
+    /// \param input pipe whose read end the buffer takes
+    /// \param output pipe whose write end the buffer takes
+    /// \param memoryLimit bytes held in memory before spilling to a file
+    PosixExecutorPipeBuffer(std::shared_ptr<ExecutorPipe> input,
+            std::shared_ptr<ExecutorPipe> output, std::size_t memoryLimit);
+
+    /// \brief Destructs the \ref PosixExecutorPipeBuffer instance
+    ///
+    /// Finishes the buffer if it has started.
+    virtual ~PosixExecutorPipeBuffer();
+
+    /// \brief Starts passing data through the buffer
+    virtual void start() override;
+
+    /// \brief Waits for the data through the buffer to end
+    virtual void finish() override;
+
+private:
+    std::shared_ptr<ExecutorPipe> _input; //!< Pipe written by the writer
+    std::shared_ptr<ExecutorPipe> _output; //!< Pipe read by the reader
+    int _source; //!< Read end of the input, or -1 once closed
+    int _sink; //!< Write end of the output, or -1 once closed
+    std::size_t _memoryLimit; //!< Bytes held in memory before spilling
+    std::deque<std::vector<char>> _chunks; //!< Data in memory, oldest first
+    std::size_t _chunkOffset{0}; //!< Bytes of the oldest chunk written
+    std::size_t _memorySize{0}; //!< Bytes of data in memory
+    int _spill{-1}; //!< File holding the newest data, if any
+    off_t _spillBegin{0}; //!< Offset of the oldest data in the file
+    off_t _spillEnd{0}; //!< Offset past the newest data in the file
+    off_t _spillReleased{0}; //!< Offset up to which space is released
+    std::vector<char> _stalled; //!< Data the file could not take
+    std::thread _thread; //!< Thread passing the data
+
+    /// \brief Passes data through the buffer until the input ends and every
+    /// byte is written, or the output closes
+    void run();
+
+    /// \brief Reads the data waiting in the input
+    void fill();
+
+    /// \brief Writes as much data as the output has room for
+    void drain();
+
+    /// \brief Holds newly read data
+    /// \param data data read
+    void hold(std::vector<char> data);
+
+    /// \brief Moves the oldest data in the file into memory
+    /// \return whether or not any data was moved
+    bool unspill();
+
+    /// \brief Closes the input once its data has ended
+    void closeInput();
+
+    /// \brief Closes the output, discarding the data held
+    void closeOutput();
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_PosixExecutorPipeBuffer
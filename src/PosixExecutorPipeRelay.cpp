@@ -0,0 +1,186 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "PosixExecutorPipeRelay.hpp"
+#include "ExecutorPipe.hpp"
+#include "utility/block_sigpipe.hpp"
+#include "utility/pipe_file.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+using utility::block_sigpipe;
+using utility::pipe_file;
+
+namespace rshell {
+
+PosixExecutorPipeRelay::~PosixExecutorPipeRelay()
+{
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    for (auto&& pair : _pairs) {
+        close(pair);
+    }
+}
+
+void PosixExecutorPipeRelay::add(std::shared_ptr<ExecutorPipe> input,
+        std::shared_ptr<ExecutorPipe> output)
+{
+    if (_thread.joinable()) {
+        throw std::logic_error{"pipes added to a started relay"};
+    }
+
+    Pair pair;
+    pair.source = pipe_file(input->inputStream(), "relayed");
+    pair.sink = pipe_file(output->outputStream(), "relayed");
+    pair.input = std::move(input);
+    pair.output = std::move(output);
+    pair.wait = Wait::None;
+    _pairs.push_back(std::move(pair));
+}
+
+void PosixExecutorPipeRelay::start()
+{
+    _started = std::chrono::steady_clock::now();
+    _thread = std::thread{&PosixExecutorPipeRelay::run, this};
+}
+
+std::vector<PipeProfile> PosixExecutorPipeRelay::finish()
+{
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    std::vector<PipeProfile> profiles;
+    for (auto&& pair : _pairs) {
+        profiles.push_back(pair.profile);
+    }
+
+    return profiles;
+}
+
+void PosixExecutorPipeRelay::run()
+{
+    block_sigpipe();
+
+    std::vector<pollfd> entries;
+    std::vector<Pair*> waiting;
+    while (true) {
+        entries.clear();
+        waiting.clear();
+        for (auto&& pair : _pairs) {
+            if (pair.wait == Wait::None) {
+                pump(pair);
+            }
+
+            if (pair.wait == Wait::Input) {
+                entries.push_back({pair.source, POLLIN, 0});
+                waiting.push_back(&pair);
+            }
+            else if (pair.wait == Wait::Output) {
+                entries.push_back({pair.sink, POLLOUT, 0});
+                waiting.push_back(&pair);
+            }
+        }
+
+        if (entries.empty()) {
+            break;
+        }
+
+        if (::poll(entries.data(), entries.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            std::perror("rshell: unable to poll relayed pipes");
+            for (auto&& pair : _pairs) {
+                close(pair);
+            }
+
+            break;
+        }
+
+        // Charge the time spent waiting to the stage waited on
+        auto now = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].revents == 0) {
+                continue;
+            }
+
+            auto& pair = *waiting[i];
+            auto& time = pair.wait == Wait::Input ?
+                pair.profile.starvedTime : pair.profile.blockedTime;
+            time += now - pair.since;
+            pair.wait = Wait::None;
+        }
+    }
+}
+
+void PosixExecutorPipeRelay::pump(Pair& pair)
+{
+    while (true) {
+        auto count = ::splice(pair.source, nullptr, pair.sink, nullptr,
+                1 << 20, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (count > 0) {
+            pair.profile.bytes += count;
+            continue;
+        }
+
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (count < 0 && errno == EAGAIN) {
+            // Either the first pipe is empty or the second is full; only in
+            // the latter case does the first hold data
+            int queued = 0;
+            ::ioctl(pair.source, FIONREAD, &queued);
+            pair.wait = queued > 0 ? Wait::Output : Wait::Input;
+            pair.since = std::chrono::steady_clock::now();
+            return;
+        }
+
+        // The data has ended, the reader has gone, or the pipes failed.
+        // Closing both ends passes the end of the data to the reader or the
+        // broken pipe to the writer
+        if (count < 0 && errno != EPIPE) {
+            std::perror("rshell: unable to relay pipe");
+        }
+
+        close(pair);
+        return;
+    }
+}
+
+void PosixExecutorPipeRelay::close(Pair& pair)
+{
+    if (pair.wait == Wait::Done) {
+        return;
+    }
+
+    pair.wait = Wait::Done;
+    pair.profile.activeTime = std::chrono::steady_clock::now() - _started;
+    pair.input->inputStream().close();
+    pair.output->outputStream().close();
+}
+
+} // namespace rshell
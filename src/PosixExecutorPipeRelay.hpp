@@ -0,0 +1,98 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::PosixExecutorPipeRelay
+/// class
+
+#ifndef hpp_rshell_PosixExecutorPipeRelay
+#define hpp_rshell_PosixExecutorPipeRelay
+
+#include "ExecutorPipeRelay.hpp"
+#include <chrono>
+#include <thread>
+
+namespace rshell {
+
+/// \brief Implementation of the executor pipe relay on top of splice
+///
+/// A single thread relays every pair of pipes, moving pages from one pipe
+/// to the other with splice so that the data is never copied and measuring
+/// does not slow the pipeline.  The thread polls the pipes it cannot move
+/// data between, timing how long each pair waits for input or for room.
+class PosixExecutorPipeRelay : public ExecutorPipeRelay
+{
+public:
+    /// \brief Destructs the \ref PosixExecutorPipeRelay instance
+    ///
+    /// Finishes the relay if it has started.
+    virtual ~PosixExecutorPipeRelay();
+
+    /// \brief Adds a pair of pipes to the relay, which takes ownership of the
+    /// read end of the first and the write end of the second
+    /// \param input pipe written by the earlier stage
+    /// \param output pipe read by the later stage
+    virtual void add(std::shared_ptr<ExecutorPipe> input,
+            std::shared_ptr<ExecutorPipe> output) override;
+
+    /// \brief Starts relaying data between each pair of pipes
+    virtual void start() override;
+
+    /// \brief Waits for every pair of pipes to reach the end of its data
+    /// \return profile of each pair, in the order added
+    virtual std::vector<PipeProfile> finish() override;
+
+private:
+    /// \brief Condition on which a pair of pipes is waiting
+    enum class Wait
+    {
+        None, //!< Data may be moved
+        Input, //!< The first pipe is empty
+        Output, //!< The second pipe is full
+        Done, //!< The first pipe has ended or the second is broken
+    };
+
+    /// \brief Pair of pipes being relayed
+    struct Pair
+    {
+        std::shared_ptr<ExecutorPipe> input; //!< Pipe written by the writer
+        std::shared_ptr<ExecutorPipe> output; //!< Pipe read by the reader
+        int source; //!< Read end of the first pipe
+        int sink; //!< Write end of the second pipe
+        Wait wait; //!< Condition on which the pair is waiting
+        std::chrono::steady_clock::time_point since; //!< Start of the wait
+        PipeProfile profile; //!< Traffic measured so far
+    };
+
+    std::vector<Pair> _pairs; //!< Pairs of pipes being relayed
+    std::thread _thread; //!< Thread relaying the pairs
+    std::chrono::steady_clock::time_point _started; //!< Start of the relay
+
+    /// \brief Relays every pair of pipes until each has ended
+    void run();
+
+    /// \brief Moves as much data as possible between a pair of pipes
+    /// \param pair pair of pipes to move data between
+    void pump(Pair& pair);
+
+    /// \brief Closes the ends of a pair of pipes held by the relay
+    /// \param pair pair of pipes to close
+    void close(Pair& pair);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_PosixExecutorPipeRelay
@@ -16,6 +16,8 @@
 
 #include "PosixExecutorPipeStream.hpp"
 #include "PosixExecutorPipe.hpp"
+#include <cstdio>
+#include <stdexcept>
 #include <unistd.h>
 
 namespace rshell {
@@ -30,22 +32,24 @@ PosixExecutorPipeStream::PosixExecutorPipeStream(PosixExecutorPipe& pipe,
 
 PosixExecutorPipeStream::~PosixExecutorPipeStream() = default;
 
-void PosixExecutorPipeStream::activate(Executor& executor)
+void PosixExecutorPipeStream::activate(int slot)
 {
-    // In input mode, the stream replaces the standard input; in output mode,
-    // it replaces the standard output
-    int slot = 0;
-    switch (_mode) {
-        case Mode::Input: slot = STDIN_FILENO; break;
-        case Mode::Output: slot = STDOUT_FILENO; break;
+    // A pipe that is no longer open, such as that of a closed coprocess,
+    // must not leave the descriptor as inherited
+    if (::dup2(_file, slot) < 0) {
+        std::perror("rshell: unable to activate pipe");
+        throw std::runtime_error{"unable to activate pipe"};
     }
-
-    ::dup2(_file, slot);
 }
 
 void PosixExecutorPipeStream::close()
 {
-    ::close(_file);
+    // Mark the descriptor closed so that closing the pipe afterward does not
+    // close a descriptor that has since been reused
+    if (_file >= 0) {
+        ::close(_file);
+        _file = -1;
+    }
 }
 
 } // namespace rshell
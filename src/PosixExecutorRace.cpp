@@ -0,0 +1,284 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "PosixExecutorRace.hpp"
+#include "PosixExecutorAppendFileStream.hpp"
+#include "PosixExecutorCachedStream.hpp"
+#include "PosixExecutorOutputFileStream.hpp"
+#include "PosixExecutorPipeStream.hpp"
+#include "utility/block_sigpipe.hpp"
+#include "utility/pipe_file.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+using utility::block_sigpipe;
+using utility::pipe_file;
+
+namespace {
+
+/// \brief Size of the buffer each input is read into
+constexpr std::size_t bufferSize = 65536;
+
+/// \brief Gets the descriptor the output of a race is written to
+/// \param stream stream of the output, or \c null for standard output
+/// \return descriptor of the output
+int outputFileOf(rshell::ExecutorStream* stream)
+{
+    using namespace rshell;
+
+    if (stream == nullptr) {
+        return STDOUT_FILENO;
+    }
+
+    auto file = -1;
+    if (auto pipeStream = dynamic_cast<PosixExecutorPipeStream*>(stream)) {
+        file = pipeStream->file();
+    }
+    else if (auto fileStream =
+            dynamic_cast<PosixExecutorOutputFileStream*>(stream)) {
+        file = fileStream->file();
+    }
+    else if (auto appendStream =
+            dynamic_cast<PosixExecutorAppendFileStream*>(stream)) {
+        file = appendStream->file();
+    }
+    else if (auto cachedStream =
+            dynamic_cast<PosixExecutorCachedStream*>(stream)) {
+        file = cachedStream->file();
+    }
+
+    if (file < 0) {
+        throw std::runtime_error{"race output is not an open local stream"};
+    }
+
+    return file;
+}
+
+}
+
+namespace rshell {
+
+constexpr std::size_t PosixExecutorRace::none;
+
+PosixExecutorRace::PosixExecutorRace(
+        std::vector<std::shared_ptr<ExecutorPipe>> inputs,
+        std::shared_ptr<ExecutorStream> output)
+    : _output(std::move(output))
+    , _sink(outputFileOf(_output.get()))
+{
+    for (auto&& input : inputs) {
+        Source source;
+        source.file = pipe_file(input->inputStream(), "raced");
+        source.input = std::move(input);
+        _sources.push_back(std::move(source));
+    }
+
+    if (::pipe2(_wake, O_CLOEXEC | O_NONBLOCK) != 0) {
+        std::perror("rshell: unable to pipe");
+        throw std::runtime_error{"unable to pipe"};
+    }
+}
+
+PosixExecutorRace::~PosixExecutorRace()
+{
+    finish();
+    for (auto&& source : _sources) {
+        close(source);
+    }
+
+    ::close(_wake[0]);
+    ::close(_wake[1]);
+}
+
+void PosixExecutorRace::start()
+{
+    _thread = std::thread{&PosixExecutorRace::run, this};
+}
+
+void PosixExecutorRace::commit(std::size_t index)
+{
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        if (_winner == none) {
+            _winner = index;
+        }
+    }
+
+    wake();
+}
+
+void PosixExecutorRace::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _isFinished = true;
+    }
+
+    wake();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void PosixExecutorRace::run()
+{
+    block_sigpipe();
+
+    std::vector<char> buffer(bufferSize);
+    std::vector<pollfd> entries;
+    std::vector<Source*> owners;
+    auto isCommitted = false;
+    while (true) {
+        std::size_t winner;
+        bool isFinished;
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            winner = _winner;
+            isFinished = _isFinished;
+        }
+
+        // Once an input is chosen, the others are no longer needed, even
+        // if the commands writing them have left descendants holding them
+        if (winner != none && !isCommitted) {
+            isCommitted = true;
+            for (std::size_t i = 0; i < _sources.size(); ++i) {
+                if (i != winner) {
+                    close(_sources[i]);
+                }
+            }
+
+            auto& source = _sources[winner];
+            if (!write(source.data.data(), source.data.size())) {
+                close(source);
+            }
+
+            source.data.clear();
+            source.data.shrink_to_fit();
+        }
+
+        if (isCommitted ? _sources[winner].file < 0 : isFinished) {
+            break;
+        }
+
+        entries.clear();
+        owners.clear();
+        entries.push_back({_wake[0], POLLIN, 0});
+        owners.push_back(nullptr);
+        for (auto&& source : _sources) {
+            if (source.file >= 0) {
+                entries.push_back({source.file, POLLIN, 0});
+                owners.push_back(&source);
+            }
+        }
+
+        if (::poll(entries.data(), entries.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            std::perror("rshell: unable to poll raced pipes");
+            break;
+        }
+
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].revents == 0) {
+                continue;
+            }
+
+            if (owners[i] == nullptr) {
+                while (::read(_wake[0], buffer.data(), buffer.size()) > 0) {
+                }
+
+                continue;
+            }
+
+            auto& source = *owners[i];
+            auto count = ::read(source.file, buffer.data(), buffer.size());
+            if (count > 0) {
+                // The data of the chosen input is passed on as it arrives
+                if (isCommitted) {
+                    if (!write(buffer.data(), count)) {
+                        close(source);
+                    }
+                }
+                else {
+                    source.data.append(buffer.data(), count);
+                }
+            }
+            else if (count == 0 || (errno != EINTR && errno != EAGAIN)) {
+                if (count < 0) {
+                    std::perror("rshell: unable to read raced pipe");
+                }
+
+                // An input that ends keeps its data until the race is
+                // decided
+                source.input->inputStream().close();
+                source.file = -1;
+            }
+        }
+    }
+
+    for (auto&& source : _sources) {
+        close(source);
+    }
+}
+
+void PosixExecutorRace::wake()
+{
+    char byte = 0;
+    while (::write(_wake[1], &byte, 1) < 0 && errno == EINTR) {
+    }
+}
+
+bool PosixExecutorRace::write(const char* data, std::size_t length)
+{
+    while (length > 0) {
+        auto count = ::write(_sink, data, length);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (count < 0) {
+            if (errno != EPIPE) {
+                std::perror("rshell: unable to write race output");
+            }
+
+            return false;
+        }
+
+        data += count;
+        length -= count;
+    }
+
+    return true;
+}
+
+void PosixExecutorRace::close(Source& source)
+{
+    if (source.input != nullptr) {
+        source.file = -1;
+        source.input->inputStream().close();
+        source.input.reset();
+        source.data.clear();
+    }
+}
+
+} // namespace rshell
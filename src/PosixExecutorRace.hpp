@@ -0,0 +1,111 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::PosixExecutorRace class
+
+#ifndef hpp_rshell_PosixExecutorRace
+#define hpp_rshell_PosixExecutorRace
+
+#include "ExecutorPipe.hpp"
+#include "ExecutorRace.hpp"
+#include "ExecutorStream.hpp"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rshell {
+
+/// \brief Implementation of the executor race holding the output of each
+/// command in memory until one is chosen
+///
+/// A thread of the shell reads every input as its data arrives.  Once an
+/// input is chosen, its data so far is written to the output in one piece
+/// and the rest as it arrives, while the other inputs are closed, so the
+/// output of the commands never interleaves.  The output is a descriptor of
+/// the shell itself, either that of a POSIX stream or standard output.
+class PosixExecutorRace : public ExecutorRace
+{
+public:
+    /// \brief Constructs a new instance of the \ref PosixExecutorRace class
+    /// on the given pipes
+    /// \param inputs pipes whose read ends the race takes
+    /// \param output stream to pass the chosen data to, or \c null for the
+    /// standard output of the shell
+    PosixExecutorRace(std::vector<std::shared_ptr<ExecutorPipe>> inputs,
+            std::shared_ptr<ExecutorStream> output);
+
+    /// \brief Destructs the \ref PosixExecutorRace instance
+    ///
+    /// Finishes the race if it has started.
+    virtual ~PosixExecutorRace();
+
+    /// \brief Starts collecting the data through the race
+    virtual void start() override;
+
+    /// \brief Chooses the pipe whose data is passed on
+    /// \param index index of the pipe
+    virtual void commit(std::size_t index) override;
+
+    /// \brief Waits for the data of the chosen pipe to end, or discards the
+    /// data of every pipe if none was chosen
+    virtual void finish() override;
+
+private:
+    /// \brief Input of the race
+    struct Source
+    {
+        std::shared_ptr<ExecutorPipe> input; //!< Pipe written by the command
+        int file; //!< Read end of the input, or -1 once closed
+        std::string data; //!< Data held until the input is chosen
+    };
+
+    /// \brief Index standing for no chosen input
+    static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+    std::vector<Source> _sources; //!< Inputs of the race
+    std::shared_ptr<ExecutorStream> _output; //!< Stream of the output
+    int _sink; //!< Descriptor of the output
+    int _wake[2]; //!< Pipe waking the thread once the state changes
+    std::mutex _mutex; //!< Guards the state shared with the thread
+    std::size_t _winner{none}; //!< Index of the chosen input, if any
+    bool _isFinished{false}; //!< Whether or not the race is finishing
+    std::thread _thread; //!< Thread collecting the data
+
+    /// \brief Collects data until the chosen input ends, or until the race
+    /// finishes without a chosen input
+    void run();
+
+    /// \brief Wakes the thread to observe a change of state
+    void wake();
+
+    /// \brief Writes data to the output in full
+    /// \param data data to write
+    /// \param length length of the data in bytes
+    /// \return whether the output remains open
+    bool write(const char* data, std::size_t length);
+
+    /// \brief Closes an input, discarding its data
+    /// \param source input to close
+    void close(Source& source);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_PosixExecutorRace
@@ -0,0 +1,151 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "ProcessSubstitutionCommand.hpp"
+#include "Executor.hpp"
+#include "ExecutorJob.hpp"
+#include "ExecutorPipe.hpp"
+#include "ExecutorStream.hpp"
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using namespace rshell;
+
+/// \brief Closes the shell's ends of the pipes of substituted commands,
+/// then waits for the commands to finish
+/// \param executor executor the commands were started on
+/// \param pipes pipes of the commands
+/// \param jobs jobs of the commands
+void reap(Executor& executor,
+        std::vector<std::shared_ptr<ExecutorPipe>>& pipes,
+        std::vector<std::unique_ptr<ExecutorJob>>& jobs)
+{
+    for (auto&& pipe : pipes) {
+        pipe->inputStream().close();
+        pipe->outputStream().close();
+    }
+
+    executor.wait(jobs);
+}
+
+}
+
+namespace rshell {
+
+constexpr int ProcessSubstitutionCommand::firstSlot;
+constexpr int ProcessSubstitutionCommand::lastSlot;
+
+ProcessSubstitutionCommand::~ProcessSubstitutionCommand() = default;
+
+int ProcessSubstitutionCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    return executeRedirected(executor, context, context, waitMode);
+}
+
+int ProcessSubstitutionCommand::executeRedirected(Executor& executor,
+        const ExecutionContext& context, const ExecutionContext& redirected,
+        WaitMode)
+{
+    // Collect the chain of nested substitutions down to the command they
+    // are arguments of
+    std::vector<ProcessSubstitutionCommand*> substitutions;
+    Command* primary = this;
+    while (auto substitution =
+            dynamic_cast<ProcessSubstitutionCommand*>(primary)) {
+        if (substitution->command == nullptr) {
+            throw std::runtime_error{"incomplete ProcessSubstitutionCommand"};
+        }
+
+        substitutions.push_back(substitution);
+        primary = substitution->primary.get();
+    }
+
+    if (primary == nullptr) {
+        throw std::runtime_error{"incomplete ProcessSubstitutionCommand"};
+    }
+
+    // Start every substituted command on a pipe within the context as
+    // given, so that none holds open the pipes of the others, and place the
+    // other end of each pipe on its descriptor for the primary command
+    std::vector<std::shared_ptr<ExecutorPipe>> pipes;
+    std::vector<std::unique_ptr<ExecutorJob>> jobs(substitutions.size());
+    auto substituted = redirected;
+    try {
+        for (std::size_t i = 0; i < substitutions.size(); ++i) {
+            auto& substitution = *substitutions[i];
+            std::shared_ptr<ExecutorPipe> pipe{executor.createPipe()};
+            pipes.push_back(pipe);
+
+            auto job = &jobs[i];
+            auto started = context.withJobHandler(
+                    [job](std::unique_ptr<ExecutorJob> adopted)
+                    {
+                        *job = std::move(adopted);
+                    });
+
+            std::shared_ptr<ExecutorStream> input{pipe, &pipe->inputStream()};
+            std::shared_ptr<ExecutorStream> output{pipe,
+                &pipe->outputStream()};
+            if (substitution.isOutput) {
+                started = started.withStream(STDIN_FILENO, input);
+                substituted = substituted.withStream(substitution.slot,
+                        output);
+            }
+            else {
+                started = started.withStream(STDOUT_FILENO, output);
+                substituted = substituted.withStream(substitution.slot,
+                        input);
+            }
+
+            executor.start(*substitution.command, started);
+
+            // The substituted command holds its own copy of its end
+            (substitution.isOutput ? input : output)->close();
+        }
+
+        // The primary command waits here whatever the wait mode, as the
+        // substituted commands are reaped once it ends.  Commands that run
+        // within the shell, such as builtins, run in a subshell instead, so
+        // that the descriptors exist where they are opened
+        auto exitCode = primary->isExternal() ?
+            primary->execute(executor, substituted, WaitMode::Wait) :
+            executor.executeSubshell(*primary, substituted, WaitMode::Wait);
+        reap(executor, pipes, jobs);
+        return exitCode;
+    }
+    catch (...) {
+        reap(executor, pipes, jobs);
+        throw;
+    }
+}
+
+void ProcessSubstitutionCommand::prepare(Executor& executor)
+{
+    if (primary != nullptr) {
+        primary->prepare(executor);
+    }
+
+    if (command != nullptr) {
+        command->prepare(executor);
+    }
+}
+
+} // namespace rshell
@@ -0,0 +1,91 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the
+/// \ref rshell::ProcessSubstitutionCommand class
+
+#ifndef hpp_rshell_ProcessSubstitutionCommand
+#define hpp_rshell_ProcessSubstitutionCommand
+
+#include "Command.hpp"
+#include "utility/raise_descriptor.hpp"
+#include <memory>
+
+namespace rshell {
+
+/// \brief Command to be executed with an argument naming a pipe from or to
+/// another command, as in "diff <(foo) <(bar)" and "tee >(foo)"
+///
+/// The argument is the path of a descriptor under /dev/fd, fixed when the
+/// command is parsed, which the pipe is placed on in the process of the
+/// command.  Substitutions within one command nest, the last outermost, and
+/// take descending descriptors starting at \ref firstSlot.  The outermost
+/// starts every substituted command concurrently, executes the command
+/// within, then closes the pipes and waits for the substituted commands.
+/// As substitutions are expanded before redirections, the substituted
+/// commands start within the context preceding any redirections of the
+/// command.
+class ProcessSubstitutionCommand : public Command
+{
+public:
+    /// \brief Descriptor of the first substitution of a command, the
+    /// highest below those the shell keeps its own streams at
+    static constexpr int firstSlot = utility::first_private_descriptor - 1;
+
+    /// \brief Descriptor of the last substitution a command may have, above
+    /// those redirections may name
+    static constexpr int lastSlot = 10;
+
+    std::unique_ptr<Command> primary; //!< Primary command to execute
+    std::unique_ptr<Command> command; //!< Substituted command
+    int slot{firstSlot}; //!< Descriptor the pipe is placed on
+
+    /// \brief Whether or not the primary command writes to the substituted
+    /// command, as in ">(foo)", rather than reading from it, as in "<(foo)"
+    bool isOutput{false};
+
+    /// \brief Destructs the \ref ProcessSubstitutionCommand instance
+    virtual ~ProcessSubstitutionCommand();
+
+    /// \brief Executes the command using the given executor
+    /// \param executor executor to use for execution
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the primary command
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Executes the command using the given executor, with the
+    /// redirections written after it already applied
+    /// \param executor executor to use for execution
+    /// \param context context to start the substituted commands within
+    /// \param redirected context to execute the primary command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the primary command
+    virtual int executeRedirected(Executor& executor,
+            const ExecutionContext& context,
+            const ExecutionContext& redirected, WaitMode waitMode) override;
+
+    /// \brief Prepares the command for repeated execution using the given
+    /// executor
+    /// \param executor executor to prepare with
+    virtual void prepare(Executor& executor) override;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_ProcessSubstitutionCommand
@@ -0,0 +1,197 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "RaceCommand.hpp"
+#include "Executor.hpp"
+#include "ExecutorJob.hpp"
+#include "ExecutorPipe.hpp"
+#include "ExecutorRace.hpp"
+#include "ExecutorStream.hpp"
+#include <exception>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using namespace rshell;
+
+/// \brief Lists the alternatives of a series of races
+/// \param command race or single alternative
+/// \param alternatives list to append the alternatives to
+void collectAlternatives(Command& command,
+        std::vector<Command*>& alternatives)
+{
+    auto race = dynamic_cast<RaceCommand*>(&command);
+    if (race == nullptr) {
+        alternatives.push_back(&command);
+        return;
+    }
+
+    collectAlternatives(*race->primary, alternatives);
+    collectAlternatives(*race->secondary, alternatives);
+}
+
+}
+
+namespace rshell {
+
+RaceCommand::~RaceCommand() = default;
+
+int RaceCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode)
+{
+    if (primary == nullptr || secondary == nullptr) {
+        throw std::runtime_error{"incomplete RaceCommand"};
+    }
+
+    std::vector<Command*> alternatives;
+    collectAlternatives(*this, alternatives);
+
+    std::vector<std::shared_ptr<ExecutorPipe>> pipes;
+    for (std::size_t i = 0; i < alternatives.size(); ++i) {
+        pipes.emplace_back(executor.createPipe());
+    }
+
+    // The race keeps the stream it writes to alive, should the context be
+    // released while the race passes on output
+    auto stream = context.streams().find(STDOUT_FILENO);
+    auto race = executor.createRace(pipes,
+            stream != std::end(context.streams()) ? stream->second : nullptr);
+    if (race == nullptr) {
+        throw std::runtime_error{"executor cannot race commands"};
+    }
+
+    // The race writes to the descriptors of the shell directly, so output
+    // buffered by builtins must reach them first.  The race collects the
+    // output before any alternative starts, as an executor may execute an
+    // alternative to completion while starting it
+    std::cout.flush();
+    race->start();
+
+    // An executor may leave no job for an alternative it executed while
+    // starting it, whose exit code is then known at once.  Each alternative
+    // leads a process group of its own, so that cancelling it stops every
+    // process it started
+    std::vector<std::unique_ptr<ExecutorJob>> jobs(alternatives.size());
+    std::vector<int> exitCodes(alternatives.size());
+    try {
+        for (std::size_t i = 0; i < alternatives.size(); ++i) {
+            auto slot = &jobs[i];
+            auto alternative = context
+                .withGroupLeader()
+                .withStream(STDOUT_FILENO, std::shared_ptr<ExecutorStream>{
+                        pipes[i], &pipes[i]->outputStream()})
+                .withJobHandler([slot](std::unique_ptr<ExecutorJob> job)
+                {
+                    *slot = std::move(job);
+                });
+            auto& command = *alternatives[i];
+            exitCodes[i] = command.isExternal() ?
+                command.execute(executor, alternative, WaitMode::Continue) :
+                executor.executeSubshell(command, alternative,
+                        WaitMode::Continue);
+            pipes[i]->outputStream().close();
+        }
+    }
+    catch (...) {
+        for (auto&& job : jobs) {
+            if (job != nullptr) {
+                job->cancel();
+                job->wait();
+            }
+        }
+
+        throw;
+    }
+
+    pipes.clear();
+
+    // Each alternative is waited for by a thread of its own, so that the
+    // first to succeed is known as soon as it exits and the others are
+    // cancelled at once
+    std::mutex mutex;
+    auto isWon = false;
+    auto exitCode = 0;
+    auto finish = [&](std::size_t index, int status)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (isWon) {
+            return;
+        }
+
+        if (status != 0) {
+            exitCode = status;
+            return;
+        }
+
+        isWon = true;
+        exitCode = 0;
+        race->commit(index);
+        for (std::size_t i = 0; i < jobs.size(); ++i) {
+            if (i != index && jobs[i] != nullptr) {
+                jobs[i]->cancel();
+            }
+        }
+    };
+
+    std::vector<std::thread> waiters;
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        if (jobs[i] == nullptr) {
+            finish(i, exitCodes[i]);
+            continue;
+        }
+
+        waiters.emplace_back([&, i]
+        {
+            auto status = 1;
+            try {
+                status = jobs[i]->wait().exitCode;
+            }
+            catch (const std::exception& e) {
+                std::cerr << "rshell: error: " << e.what() << '\n';
+            }
+
+            finish(i, status);
+        });
+    }
+
+    for (auto&& waiter : waiters) {
+        waiter.join();
+    }
+
+    race->finish();
+    return exitCode;
+}
+
+void RaceCommand::prepare(Executor& executor)
+{
+    if (primary != nullptr) {
+        primary->prepare(executor);
+    }
+
+    if (secondary != nullptr) {
+        secondary->prepare(executor);
+    }
+}
+
+} // namespace rshell
@@ -0,0 +1,62 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::RaceCommand class
+
+#ifndef hpp_rshell_RaceCommand
+#define hpp_rshell_RaceCommand
+
+#include "Command.hpp"
+#include <memory>
+
+namespace rshell {
+
+/// \brief Command executing the primary and secondary commands concurrently
+/// and keeping the output of the first to exit successfully
+///
+/// A series of races, as in "a &| b &| c", runs every alternative at once.
+/// The output of each is held by the shell until one exits with a zero
+/// exit code; its output is then passed on and the others are cancelled,
+/// along with every process they started.
+/// The race fails, with the exit code of the last alternative to fail, only
+/// if every alternative fails, in which case no output is passed on.
+class RaceCommand : public Command
+{
+public:
+    std::unique_ptr<Command> primary; //!< Primary command to execute
+    std::unique_ptr<Command> secondary; //!< Secondary command to execute
+
+    /// \brief Destructs the \ref RaceCommand instance
+    virtual ~RaceCommand();
+
+    /// \brief Executes the command using the given executor
+    /// \param executor executor to use for execution
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the command
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Prepares the command for repeated execution using the given
+    /// executor
+    /// \param executor executor to prepare with
+    virtual void prepare(Executor& executor) override;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_RaceCommand
@@ -0,0 +1,135 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "RecordedCommand.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <arpa/inet.h>
+
+namespace {
+
+/// \brief Appends a 32-bit integer to a record
+/// \param record record to append to
+/// \param value integer to append
+void putInteger(std::string& record, std::uint32_t value)
+{
+    value = htonl(value);
+    record.append(reinterpret_cast<const char*>(&value), sizeof value);
+}
+
+/// \brief Takes a 32-bit integer from a record
+/// \param record record to take from
+/// \param offset offset of the integer, advanced past it
+/// \return taken integer
+std::uint32_t takeInteger(const std::string& record, std::size_t& offset)
+{
+    std::uint32_t value;
+    if (record.size() - offset < sizeof value) {
+        throw std::runtime_error{"malformed recorded command"};
+    }
+
+    std::memcpy(&value, &record[offset], sizeof value);
+    offset += sizeof value;
+    return ntohl(value);
+}
+
+/// \brief Appends a length-prefixed string to a record
+/// \param record record to append to
+/// \param text string to append
+void putString(std::string& record, const std::string& text)
+{
+    putInteger(record, static_cast<std::uint32_t>(text.size()));
+    record += text;
+}
+
+/// \brief Takes a length-prefixed string from a record
+/// \param record record to take from
+/// \param offset offset of the string, advanced past it
+/// \return taken string
+std::string takeString(const std::string& record, std::size_t& offset)
+{
+    auto length = takeInteger(record, offset);
+    if (record.size() - offset < length) {
+        throw std::runtime_error{"malformed recorded command"};
+    }
+
+    auto text = record.substr(offset, length);
+    offset += length;
+    return text;
+}
+
+}
+
+namespace rshell {
+
+const std::string RecordedCommand::header{"rshell recording 2\n"};
+
+std::string RecordedCommand::describe() const
+{
+    if (isSubshell && arguments.empty()) {
+        return "subshell";
+    }
+
+    std::string description;
+    for (auto&& argument : arguments) {
+        description += (description.empty() ? "" : " ") + argument;
+    }
+
+    return description;
+}
+
+std::string RecordedCommand::encode() const
+{
+    std::string record;
+    putInteger(record, index);
+    record += static_cast<char>(isSubshell);
+    putInteger(record, static_cast<std::uint32_t>(arguments.size()));
+    for (auto&& argument : arguments) {
+        putString(record, argument);
+    }
+
+    putString(record, input);
+    putString(record, environment);
+    putString(record, output);
+    putString(record, error);
+    putInteger(record, static_cast<std::uint32_t>(exitCode));
+    return record;
+}
+
+RecordedCommand RecordedCommand::decode(const std::string& record)
+{
+    RecordedCommand command;
+    std::size_t offset = 0;
+    command.index = takeInteger(record, offset);
+    if (offset >= record.size()) {
+        throw std::runtime_error{"malformed recorded command"};
+    }
+
+    command.isSubshell = record[offset++] != 0;
+    auto count = takeInteger(record, offset);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        command.arguments.push_back(takeString(record, offset));
+    }
+
+    command.input = takeString(record, offset);
+    command.environment = takeString(record, offset);
+    command.output = takeString(record, offset);
+    command.error = takeString(record, offset);
+    command.exitCode = static_cast<std::int32_t>(takeInteger(record, offset));
+    return command;
+}
+
+} // namespace rshell
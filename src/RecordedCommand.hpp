@@ -0,0 +1,66 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::RecordedCommand
+/// structure
+
+#ifndef hpp_rshell_RecordedCommand
+#define hpp_rshell_RecordedCommand
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rshell {
+
+/// \brief Execution of a command captured by a \ref RecordingExecutor for a
+/// \ref ReplayExecutor to serve
+///
+/// A recording is a header line followed by the encoded commands, each
+/// prefixed by its length, in the order the commands finished.
+struct RecordedCommand
+{
+    /// \brief Header line beginning every recording
+    static const std::string header;
+
+    std::uint32_t index{0}; //!< Position of the command in execution order
+    bool isSubshell{false}; //!< Whether or not the command is a subshell
+    std::vector<std::string> arguments; //!< Program and its arguments
+    std::string input; //!< Digest of the standard input
+    std::string environment; //!< Digest of the replaced environment
+    std::string output; //!< Standard output written by the command
+    std::string error; //!< Standard error written by the command
+    std::int32_t exitCode{0}; //!< Exit code of the command
+
+    /// \brief Describes the command for messages
+    /// \return program and arguments, or "subshell" for a subshell
+    std::string describe() const;
+
+    /// \brief Encodes the command as a record
+    /// \return encoded record
+    std::string encode() const;
+
+    /// \brief Decodes a command from a record
+    /// \param record record to decode
+    /// \return decoded command
+    /// \throw std::runtime_error if the record is malformed
+    static RecordedCommand decode(const std::string& record);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_RecordedCommand
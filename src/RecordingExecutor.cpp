@@ -0,0 +1,275 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "RecordingExecutor.hpp"
+#include "ExecutorJob.hpp"
+#include "PosixExecutorAppendFileStream.hpp"
+#include "PosixExecutorCachedStream.hpp"
+#include "PosixExecutorInputFileStream.hpp"
+#include "PosixExecutorOutputFileStream.hpp"
+#include "PosixExecutorPipeStream.hpp"
+#include "RecordingExecutorJob.hpp"
+#include "RecordingExecutorTap.hpp"
+#include "utility/make_unique.hpp"
+#include "utility/read_write_all.hpp"
+#include "utility/sha256.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using utility::make_unique;
+using utility::write_all;
+
+namespace {
+
+/// \brief Size of the buffer files are digested through
+constexpr std::size_t bufferSize = 65536;
+
+}
+
+namespace rshell {
+
+RecordingExecutor::RecordingExecutor(const std::string& path)
+    : _file{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+            0666)}
+    , _pid{::getpid()}
+{
+    if (_file < 0 || !write_all(_file, RecordedCommand::header.data(),
+                RecordedCommand::header.size())) {
+        std::perror("rshell: unable to create recording");
+        if (_file >= 0) {
+            ::close(_file);
+        }
+
+        throw std::runtime_error{"unable to create recording " + path};
+    }
+}
+
+RecordingExecutor::~RecordingExecutor()
+{
+    ::close(_file);
+}
+
+int RecordingExecutor::execute(ExecutableCommand& command,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    // A forked subshell belongs to the recording of the subshell as a whole
+    if (::getpid() != _pid) {
+        return PosixExecutor::execute(command, context, waitMode);
+    }
+
+    RecordedCommand entry;
+    entry.arguments.push_back(command.program);
+    entry.arguments.insert(std::end(entry.arguments),
+            std::begin(command.arguments), std::end(command.arguments));
+    return record(std::move(entry), context, waitMode,
+            [&](const ExecutionContext& tapped, WaitMode mode)
+            {
+                return PosixExecutor::execute(command, tapped, mode);
+            });
+}
+
+int RecordingExecutor::executeSubshell(Command& command,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    if (::getpid() != _pid) {
+        return PosixExecutor::executeSubshell(command, context, waitMode);
+    }
+
+    RecordedCommand entry;
+    entry.isSubshell = true;
+    if (auto executable = dynamic_cast<ExecutableCommand*>(&command)) {
+        entry.arguments.push_back(executable->program);
+        entry.arguments.insert(std::end(entry.arguments),
+                std::begin(executable->arguments),
+                std::end(executable->arguments));
+    }
+
+    return record(std::move(entry), context, waitMode,
+            [&](const ExecutionContext& tapped, WaitMode mode)
+            {
+                return PosixExecutor::executeSubshell(command, tapped, mode);
+            });
+}
+
+int RecordingExecutor::execute(DependencyGraph& graph,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    return Executor::execute(graph, context, waitMode);
+}
+
+int RecordingExecutor::outputFileOf(const ExecutionContext& context,
+        int slot)
+{
+    auto stream = context.stream(slot);
+    if (stream == nullptr) {
+        return slot;
+    }
+
+    auto file = -1;
+    if (auto pipeStream = dynamic_cast<PosixExecutorPipeStream*>(stream)) {
+        file = pipeStream->file();
+    }
+    else if (auto fileStream =
+            dynamic_cast<PosixExecutorOutputFileStream*>(stream)) {
+        file = fileStream->file();
+    }
+    else if (auto appendStream =
+            dynamic_cast<PosixExecutorAppendFileStream*>(stream)) {
+        file = appendStream->file();
+    }
+    else if (auto cachedStream =
+            dynamic_cast<PosixExecutorCachedStream*>(stream)) {
+        file = cachedStream->file();
+    }
+
+    if (file < 0) {
+        throw std::runtime_error{"recorded output is not an open local "
+            "stream"};
+    }
+
+    return file;
+}
+
+std::string RecordingExecutor::digestInput(const ExecutionContext& context)
+{
+    auto stream = context.stream(0);
+    if (stream == nullptr) {
+        return "inherited";
+    }
+
+    auto file = -1;
+    if (auto fileStream =
+            dynamic_cast<PosixExecutorInputFileStream*>(stream)) {
+        file = fileStream->file();
+    }
+    else if (auto cachedStream =
+            dynamic_cast<PosixExecutorCachedStream*>(stream)) {
+        file = cachedStream->file();
+    }
+    else {
+        return "pipe";
+    }
+
+    // Read from the start by offset, leaving the position of the stream to
+    // the command
+    utility::sha256 hash;
+    char buffer[bufferSize];
+    off_t offset = 0;
+    ssize_t count;
+    while ((count = ::pread(file, buffer, sizeof(buffer),
+                    offset)) != 0) {
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return "unreadable";
+        }
+
+        hash.update(buffer, count);
+        offset += count;
+    }
+
+    return hash.hex_digest();
+}
+
+std::string RecordingExecutor::digestEnvironment(
+        const ExecutionContext& context)
+{
+    if (!context.hasEnvironment()) {
+        return "inherited";
+    }
+
+    // Terminate each entry, so that entries split differently digest
+    // differently
+    utility::sha256 hash;
+    for (auto&& entry : context.environment()) {
+        hash.update(entry.c_str(), entry.size() + 1);
+    }
+
+    return hash.hex_digest();
+}
+
+int RecordingExecutor::record(RecordedCommand record,
+        const ExecutionContext& context, WaitMode waitMode,
+        const Execution& execution)
+{
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        record.index = _next++;
+    }
+
+    record.input = digestInput(context);
+    record.environment = digestEnvironment(context);
+
+    // Flush the standard streams so that output written by builtins before
+    // the command precedes its output
+    std::cout.flush();
+    std::cerr.flush();
+
+    // Pass the output of the command through the tap, adopting its job so
+    // that it is recorded once waited for
+    auto tap = std::make_shared<RecordingExecutorTap>(
+            outputFileOf(context, STDOUT_FILENO),
+            outputFileOf(context, STDERR_FILENO));
+    std::unique_ptr<ExecutorJob> job;
+    auto tapped = context.withStream(1, tap->outputStream())
+        .withStream(2, tap->errorStream())
+        .withJobHandler([&](std::unique_ptr<ExecutorJob> adopted)
+                {
+                    job = std::move(adopted);
+                });
+
+    auto exitCode = execution(tapped, waitMode);
+    tap->release();
+    if (job != nullptr) {
+        context.adopt(make_unique<RecordingExecutorJob>(*this,
+                    std::move(job), std::move(record), std::move(tap)));
+        return exitCode;
+    }
+
+    finish(record, *tap, exitCode);
+    return exitCode;
+}
+
+void RecordingExecutor::finish(RecordedCommand& record,
+        RecordingExecutorTap& tap, int exitCode)
+{
+    tap.finish();
+    record.output = tap.output();
+    record.error = tap.error();
+    record.exitCode = exitCode;
+
+    // Prefix each record with its length, so that the recording may be
+    // read back one record at a time
+    auto encoded = record.encode();
+    auto length = htonl(static_cast<std::uint32_t>(encoded.size()));
+    encoded.insert(0, reinterpret_cast<const char*>(&length), sizeof length);
+
+    std::lock_guard<std::mutex> lock{_mutex};
+    if (!write_all(_file, encoded.data(), encoded.size())) {
+        std::perror("rshell: unable to write recording");
+        throw std::runtime_error{"unable to write recording"};
+    }
+}
+
+} // namespace rshell
@@ -0,0 +1,144 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::RecordingExecutor class
+
+#ifndef hpp_rshell_RecordingExecutor
+#define hpp_rshell_RecordingExecutor
+
+#include "PosixExecutor.hpp"
+#include "RecordedCommand.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+
+namespace rshell {
+
+// Forward declarations
+class RecordingExecutorTap;
+
+/// \brief Implementation of the execution algorithm on top of POSIX system
+/// calls which records every command executed to a file for a
+/// \ref ReplayExecutor to serve
+///
+/// Each external program, and each subshell as a whole, is recorded with its
+/// arguments, a digest of its standard input, everything it wrote to its
+/// standard output and error, and its exit code.  Builtins executing within
+/// the shell are not recorded, as they execute again on replay.  Commands
+/// executed by forked subshells belong to the recording of the subshell.
+class RecordingExecutor : public PosixExecutor
+{
+public:
+    /// \brief Constructs a new instance of the \ref RecordingExecutor class
+    /// \param path path of the recording, which is replaced
+    /// \throw std::runtime_error if the recording cannot be created
+    explicit RecordingExecutor(const std::string& path);
+
+    /// \brief Destructs the \ref RecordingExecutor instance
+    virtual ~RecordingExecutor();
+
+    using PosixExecutor::execute;
+
+    /// \brief Executes and records the individual command given
+    /// \param command command to execute
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the command
+    virtual int execute(ExecutableCommand& command,
+            const ExecutionContext& context,
+            WaitMode waitMode = WaitMode::Wait) override;
+
+    /// \brief Executes and records the abstract command given in a forked
+    /// subshell
+    /// \param command command to execute
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the command, or zero if not waiting
+    virtual int executeSubshell(Command& command,
+            const ExecutionContext& context,
+            WaitMode waitMode = WaitMode::Wait) override;
+
+    /// \brief Executes the graph of sequential commands given
+    /// \param graph graph of commands to execute
+    /// \param context context to execute the commands within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the last command in the graph
+    ///
+    /// The commands are executed one at a time in sequence order, so that
+    /// each is recorded rather than the subshells executing them.
+    virtual int execute(DependencyGraph& graph,
+            const ExecutionContext& context,
+            WaitMode waitMode = WaitMode::Wait) override;
+
+    /// \brief Gets the descriptor a command writes an output to
+    /// \param context context of the command
+    /// \param slot descriptor of the output
+    /// \return descriptor of the stream replacing the output, or the
+    /// descriptor itself if it is inherited from the shell
+    /// \throw std::runtime_error if the stream is not a local stream
+    static int outputFileOf(const ExecutionContext& context, int slot);
+
+    /// \brief Digests the standard input of a command
+    /// \param context context of the command
+    /// \return "inherited" for the input of the shell, "pipe" for a pipe,
+    /// and the SHA-256 of the contents for a file
+    ///
+    /// The input from a pipe is not digested, as the commands writing to it
+    /// are recorded themselves.
+    static std::string digestInput(const ExecutionContext& context);
+
+    /// \brief Digests the environment of a command
+    /// \param context context of the command
+    /// \return "inherited" for the environment of the shell, and the SHA-256
+    /// of the entries for a replaced environment
+    static std::string digestEnvironment(const ExecutionContext& context);
+
+private:
+    friend class RecordingExecutorJob;
+
+    /// \brief Type of function executing a command within a context
+    using Execution = std::function<int(const ExecutionContext&, WaitMode)>;
+
+    int _file; //!< Descriptor of the recording
+    std::mutex _mutex; //!< Guards the recording and the index
+    std::uint32_t _next{0}; //!< Index of the next command recorded
+    pid_t _pid; //!< Process identifier of the recording shell
+
+    /// \brief Executes a command through a tap, recording its execution
+    /// \param record record of the command, lacking its results
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \param execution function executing the command
+    /// \return exit code of the command, or zero if not waiting
+    int record(RecordedCommand record, const ExecutionContext& context,
+            WaitMode waitMode, const Execution& execution);
+
+    /// \brief Completes the record of a finished command and writes it to
+    /// the recording
+    /// \param record record of the command
+    /// \param tap tap passing on the output of the command
+    /// \param exitCode exit code of the command
+    void finish(RecordedCommand& record, RecordingExecutorTap& tap,
+            int exitCode);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_RecordingExecutor
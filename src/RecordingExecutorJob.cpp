@@ -0,0 +1,63 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "RecordingExecutorJob.hpp"
+#include "RecordingExecutor.hpp"
+#include "RecordingExecutorTap.hpp"
+#include <stdexcept>
+#include <utility>
+
+namespace rshell {
+
+RecordingExecutorJob::RecordingExecutorJob(RecordingExecutor& executor,
+        std::unique_ptr<ExecutorJob> job, RecordedCommand record,
+        std::shared_ptr<RecordingExecutorTap> tap)
+    : _executor(executor)
+    , _job{std::move(job)}
+    , _record(std::move(record))
+    , _tap{std::move(tap)}
+{
+}
+
+RecordingExecutorJob::~RecordingExecutorJob()
+{
+    if (!_isWaited) {
+        try {
+            wait();
+        }
+        catch (...) {
+        }
+    }
+}
+
+JobStatus RecordingExecutorJob::wait()
+{
+    if (_isWaited) {
+        throw std::runtime_error{"job has already been waited for"};
+    }
+
+    _isWaited = true;
+    auto status = _job->wait();
+    _executor.finish(_record, *_tap, status.exitCode);
+    return status;
+}
+
+void RecordingExecutorJob::cancel()
+{
+    _job->cancel();
+}
+
+} // namespace rshell
@@ -0,0 +1,77 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::RecordingExecutorJob
+/// class
+
+#ifndef hpp_rshell_RecordingExecutorJob
+#define hpp_rshell_RecordingExecutorJob
+
+#include "ExecutorJob.hpp"
+#include "RecordedCommand.hpp"
+#include <memory>
+
+namespace rshell {
+
+// Forward declarations
+class RecordingExecutor;
+class RecordingExecutorTap;
+
+/// \brief Implementation of the executor job on a recorded command started
+/// in continue mode
+///
+/// The command is recorded once it has been waited for.
+class RecordingExecutorJob : public ExecutorJob
+{
+public:
+    /// \brief Constructs a new instance of the \ref RecordingExecutorJob
+    /// class
+    /// \param executor executor which started the job
+    /// \param job job of the command
+    /// \param record record of the command, lacking its results
+    /// \param tap tap passing on the output of the command
+    RecordingExecutorJob(RecordingExecutor& executor,
+            std::unique_ptr<ExecutorJob> job, RecordedCommand record,
+            std::shared_ptr<RecordingExecutorTap> tap);
+
+    /// \brief Destructs the \ref RecordingExecutorJob instance
+    ///
+    /// Waits for the command if it has not been waited for, so that it is
+    /// still recorded.
+    virtual ~RecordingExecutorJob();
+
+    RecordingExecutorJob(const RecordingExecutorJob&) = delete;
+    RecordingExecutorJob& operator=(const RecordingExecutorJob&) = delete;
+
+    /// \brief Waits for the command to finish, then records it
+    /// \return status of the command
+    virtual JobStatus wait() override;
+
+    /// \brief Asks the command to stop early
+    virtual void cancel() override;
+
+private:
+    RecordingExecutor& _executor; //!< Executor which started the job
+    std::unique_ptr<ExecutorJob> _job; //!< Job of the command
+    RecordedCommand _record; //!< Record of the command
+    std::shared_ptr<RecordingExecutorTap> _tap; //!< Tap on the output
+    bool _isWaited{false}; //!< Whether or not the job has been waited for
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_RecordingExecutorJob
@@ -0,0 +1,159 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "RecordingExecutorTap.hpp"
+#include "PosixExecutorPipe.hpp"
+#include "PosixExecutorPipeStream.hpp"
+#include "utility/block_sigpipe.hpp"
+#include "utility/read_write_all.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+using utility::block_sigpipe;
+using utility::write_all;
+
+namespace {
+
+/// \brief Size of the buffer the pipes are read into
+constexpr std::size_t bufferSize = 65536;
+
+}
+
+namespace rshell {
+
+RecordingExecutorTap::RecordingExecutorTap(int output, int error)
+    : _pipes{std::make_shared<PosixExecutorPipe>(),
+        std::make_shared<PosixExecutorPipe>()}
+    , _sources{-1, -1}
+    , _sinks{::fcntl(output, F_DUPFD_CLOEXEC, 0),
+        ::fcntl(error, F_DUPFD_CLOEXEC, 0)}
+{
+    // Take the read ends from the pipes, so that the shell holds only the
+    // write ends for the command
+    for (auto i = 0; i < 2; ++i) {
+        auto& stream = static_cast<PosixExecutorPipeStream&>(
+                _pipes[i]->inputStream());
+        _sources[i] = ::fcntl(stream.file(), F_DUPFD_CLOEXEC, 0);
+        stream.close();
+    }
+
+    if (_sources[0] < 0 || _sources[1] < 0 || _sinks[0] < 0 ||
+            _sinks[1] < 0) {
+        std::perror("rshell: unable to tap command");
+        for (auto file : {_sources[0], _sources[1], _sinks[0], _sinks[1]}) {
+            if (file >= 0) {
+                ::close(file);
+            }
+        }
+
+        throw std::runtime_error{"unable to tap command"};
+    }
+
+    _thread = std::thread{&RecordingExecutorTap::run, this};
+}
+
+RecordingExecutorTap::~RecordingExecutorTap()
+{
+    release();
+    finish();
+}
+
+std::shared_ptr<ExecutorStream> RecordingExecutorTap::outputStream() const
+{
+    return {_pipes[0], &_pipes[0]->outputStream()};
+}
+
+std::shared_ptr<ExecutorStream> RecordingExecutorTap::errorStream() const
+{
+    return {_pipes[1], &_pipes[1]->outputStream()};
+}
+
+void RecordingExecutorTap::release()
+{
+    for (auto&& pipe : _pipes) {
+        pipe->outputStream().close();
+    }
+}
+
+void RecordingExecutorTap::finish()
+{
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void RecordingExecutorTap::run()
+{
+    block_sigpipe();
+
+    char buffer[bufferSize];
+    while (_sources[0] >= 0 || _sources[1] >= 0) {
+        pollfd entries[2] = {
+            {_sources[0], POLLIN, 0},
+            {_sources[1], POLLIN, 0},
+        };
+
+        if (::poll(entries, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            break;
+        }
+
+        for (auto i = 0; i < 2; ++i) {
+            if (entries[i].revents == 0) {
+                continue;
+            }
+
+            auto count = ::read(_sources[i], buffer, sizeof(buffer));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            // Close the pipe at its end, or once its destination fails, so
+            // that the command sees a broken pipe on its next write.  The
+            // destination is closed along with it, so that its reader sees
+            // the end as soon as the command is done with it
+            if (count <= 0 || !write_all(_sinks[i], buffer, count)) {
+                close(i);
+                continue;
+            }
+
+            _captured[i].append(buffer, count);
+        }
+    }
+
+    for (auto i = 0; i < 2; ++i) {
+        close(i);
+    }
+}
+
+void RecordingExecutorTap::close(int index)
+{
+    if (_sources[index] >= 0) {
+        ::close(_sources[index]);
+        ::close(_sinks[index]);
+        _sources[index] = -1;
+        _sinks[index] = -1;
+    }
+}
+
+} // namespace rshell
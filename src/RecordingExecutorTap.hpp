@@ -0,0 +1,100 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::RecordingExecutorTap
+/// class
+
+#ifndef hpp_rshell_RecordingExecutorTap
+#define hpp_rshell_RecordingExecutorTap
+
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace rshell {
+
+// Forward declarations
+class ExecutorStream;
+class PosixExecutorPipe;
+
+/// \brief Passes the standard output and error of a recorded command on to
+/// their destinations while capturing them
+///
+/// The command writes to pipes of the tap, whose thread copies everything
+/// it reads to the destinations.  Should a destination close, the tap
+/// closes the pipe it feeds, so the command sees a broken pipe as it would
+/// have without the tap.  Only what reached a destination is captured.
+class RecordingExecutorTap
+{
+public:
+    /// \brief Constructs a new instance of the \ref RecordingExecutorTap
+    /// class and starts its thread
+    /// \param output descriptor the standard output is passed on to, which
+    /// is duplicated
+    /// \param error descriptor the standard error is passed on to, which is
+    /// duplicated
+    RecordingExecutorTap(int output, int error);
+
+    /// \brief Destructs the \ref RecordingExecutorTap instance
+    ///
+    /// Waits for the command to close its standard output and error.
+    ~RecordingExecutorTap();
+
+    RecordingExecutorTap(const RecordingExecutorTap&) = delete;
+    RecordingExecutorTap& operator=(const RecordingExecutorTap&) = delete;
+
+    /// \brief Gets the stream the command writes its standard output to
+    /// \return write end of the output pipe
+    std::shared_ptr<ExecutorStream> outputStream() const;
+
+    /// \brief Gets the stream the command writes its standard error to
+    /// \return write end of the error pipe
+    std::shared_ptr<ExecutorStream> errorStream() const;
+
+    /// \brief Closes the write ends held by the shell, once the command
+    /// holds its own copies
+    void release();
+
+    /// \brief Waits for the command to close its standard output and error
+    void finish();
+
+    /// \brief Gets the captured standard output, once finished
+    /// \return captured output
+    const std::string& output() const noexcept { return _captured[0]; }
+
+    /// \brief Gets the captured standard error, once finished
+    /// \return captured error
+    const std::string& error() const noexcept { return _captured[1]; }
+
+private:
+    std::shared_ptr<PosixExecutorPipe> _pipes[2]; //!< Pipes of the command
+    int _sources[2]; //!< Read ends of the pipes
+    int _sinks[2]; //!< Descriptors the pipes are passed on to
+    std::string _captured[2]; //!< Data passed on from each pipe
+    std::thread _thread; //!< Thread passing the pipes on
+
+    /// \brief Passes the pipes on until the command closes both
+    void run();
+
+    /// \brief Closes a pipe and its destination
+    /// \param index index of the pipe
+    void close(int index);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_RecordingExecutorTap
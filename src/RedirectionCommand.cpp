@@ -0,0 +1,70 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "RedirectionCommand.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace rshell {
+
+RedirectionCommand::RedirectionCommand(int slot)
+    : slot{slot}
+{
+}
+
+RedirectionCommand::~RedirectionCommand() = default;
+
+int RedirectionCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    // Collect the chain of nested redirections, outermost first, down to
+    // the command they apply to
+    std::vector<const RedirectionCommand*> actions;
+    Command* command = this;
+    while (auto redirection = dynamic_cast<RedirectionCommand*>(command)) {
+        actions.push_back(redirection);
+        command = redirection->primary.get();
+    }
+
+    if (command == nullptr) {
+        throw std::runtime_error{"incomplete RedirectionCommand"};
+    }
+
+    // Apply the redirections in the order written, innermost first, so that
+    // a duplication refers to the descriptor as already redirected
+    auto redirected = context;
+    for (auto action = actions.rbegin(); action != actions.rend();
+            ++action) {
+        redirected = (*action)->redirect(executor, redirected);
+    }
+
+    return command->executeRedirected(executor, context, redirected,
+            waitMode);
+}
+
+void RedirectionCommand::prepare(Executor& executor)
+{
+    if (primary != nullptr) {
+        primary->prepare(executor);
+    }
+}
+
+bool RedirectionCommand::isExternal() const
+{
+    return primary != nullptr && primary->isExternal();
+}
+
+} // namespace rshell
@@ -0,0 +1,81 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::RedirectionCommand class
+
+#ifndef hpp_rshell_RedirectionCommand
+#define hpp_rshell_RedirectionCommand
+
+#include "Command.hpp"
+#include "ExecutionContext.hpp"
+#include <memory>
+
+namespace rshell {
+
+/// \brief Abstract base class for commands to be executed with a replaced
+/// descriptor
+///
+/// Redirections written one after another nest, the last outermost.  The
+/// outermost collects the whole chain into a table of descriptor actions,
+/// which it applies to the context in the order written before executing
+/// the command within, so that "foo > bar 2>&1" sends the standard error to
+/// bar as well.  The executor then places every stream of the context on
+/// its descriptor in a single pass.
+class RedirectionCommand : public Command
+{
+public:
+    std::unique_ptr<Command> primary; //!< Primary command to execute
+    int slot; //!< Descriptor to replace
+
+    /// \brief Destructs the \ref RedirectionCommand instance
+    virtual ~RedirectionCommand();
+
+    /// \brief Executes the command using the given executor
+    /// \param executor executor to use for execution
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the command
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Prepares the command for repeated execution using the given
+    /// executor
+    /// \param executor executor to prepare with
+    virtual void prepare(Executor& executor) override;
+
+    /// \brief Gets a value indicating whether or not the command only starts
+    /// an external program
+    /// \return whether or not the primary command is external
+    virtual bool isExternal() const override;
+
+    /// \brief Applies the redirection alone to a context
+    /// \param executor executor to create streams on
+    /// \param context context to redirect
+    /// \return redirected context
+    virtual ExecutionContext redirect(Executor& executor,
+            const ExecutionContext& context) const = 0;
+
+protected:
+    /// \brief Constructs a new instance of the \ref RedirectionCommand class
+    /// replacing the given descriptor
+    /// \param slot descriptor to replace
+    explicit RedirectionCommand(int slot);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_RedirectionCommand
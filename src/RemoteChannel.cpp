@@ -0,0 +1,108 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "RemoteChannel.hpp"
+#include "utility/read_write_all.hpp"
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using utility::read_all;
+using utility::write_all;
+
+namespace {
+
+/// \brief Size of the encoded frame header
+constexpr std::size_t headerSize = 9;
+
+/// \brief Upper bound on the length of a frame payload
+constexpr std::uint32_t maxPayloadLength = 1 << 24;
+
+}
+
+namespace rshell {
+
+RemoteChannel::RemoteChannel(int input, int output)
+    : _input{input}
+    , _output{output}
+{
+}
+
+bool RemoteChannel::send(const Frame& frame)
+{
+    if (frame.payload.size() > maxPayloadLength) {
+        return false;
+    }
+
+    // Assemble the header and payload so that each frame is a single write
+    // wherever possible
+    auto buffer = encode(frame);
+    return write_all(_output, buffer.data(), buffer.size());
+}
+
+bool RemoteChannel::receive(Frame& frame)
+{
+    char header[headerSize];
+    if (!read_all(_input, header, sizeof header)) {
+        return false;
+    }
+
+    std::uint32_t job;
+    std::uint32_t length;
+    std::memcpy(&job, &header[1], sizeof job);
+    std::memcpy(&length, &header[5], sizeof length);
+    length = ntohl(length);
+    if (length > maxPayloadLength) {
+        return false;
+    }
+
+    frame.type = static_cast<FrameType>(header[0]);
+    frame.job = ntohl(job);
+    frame.payload.resize(length);
+    return length == 0 || read_all(_input, &frame.payload[0], length);
+}
+
+std::string RemoteChannel::encode(const Frame& frame)
+{
+    std::string buffer(headerSize, '\0');
+    auto job = htonl(frame.job);
+    auto length = htonl(static_cast<std::uint32_t>(frame.payload.size()));
+    buffer[0] = static_cast<char>(frame.type);
+    std::memcpy(&buffer[1], &job, sizeof job);
+    std::memcpy(&buffer[5], &length, sizeof length);
+    buffer += frame.payload;
+    return buffer;
+}
+
+std::string RemoteChannel::encodeExitCode(int exitCode)
+{
+    auto value = htonl(static_cast<std::uint32_t>(exitCode));
+    return std::string(reinterpret_cast<const char*>(&value), sizeof value);
+}
+
+int RemoteChannel::decodeExitCode(const std::string& payload)
+{
+    std::uint32_t value = 0;
+    if (payload.size() == sizeof value) {
+        std::memcpy(&value, payload.data(), sizeof value);
+    }
+
+    return static_cast<int>(ntohl(value));
+}
+
+} // namespace rshell
@@ -0,0 +1,101 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::RemoteChannel class
+
+#ifndef hpp_rshell_RemoteChannel
+#define hpp_rshell_RemoteChannel
+
+#include <cstdint>
+#include <string>
+
+namespace rshell {
+
+/// \brief Framed, bidirectional channel between a \ref RemoteExecutor and a
+/// \ref RemoteWorker
+///
+/// Each frame consists of a type, the identifier of the job it concerns, and
+/// a payload of arbitrary length, with integers in network byte order.  The
+/// channel performs no locking; concurrent senders must be serialized by the
+/// owner.
+class RemoteChannel
+{
+public:
+    /// \brief Types of frames that may be exchanged
+    enum class FrameType : std::uint8_t
+    {
+        Spawn = 1, //!< Executor requests a job, payload is a \ref RemoteSpawn
+        Input = 2, //!< Executor sends standard input, empty at end of input
+        Hangup = 3, //!< Executor no longer accepts standard output
+        Output = 4, //!< Worker sends standard output
+        Error = 5, //!< Worker sends standard error
+        Exit = 6, //!< Worker reports the exit code of a finished job
+        Cancel = 7, //!< Executor asks the worker to terminate a job, or to
+                    //!< kill it if the payload is "kill"
+    };
+
+    /// \brief Frame exchanged over the channel
+    struct Frame
+    {
+        FrameType type; //!< Type of the frame
+        std::uint32_t job; //!< Identifier of the job the frame concerns
+        std::string payload; //!< Body of the frame
+    };
+
+    /// \brief Constructs a new instance of the \ref RemoteChannel class on
+    /// the given file descriptors
+    /// \param input descriptor to receive frames from
+    /// \param output descriptor to send frames to
+    ///
+    /// The channel does not take ownership of the descriptors.
+    explicit RemoteChannel(int input, int output);
+
+    /// \brief Sends a frame, blocking until it is sent
+    /// \param frame frame to send
+    /// \return whether or not the frame was sent
+    bool send(const Frame& frame);
+
+    /// \brief Encodes a frame for sending
+    /// \param frame frame to encode
+    /// \return encoded frame
+    ///
+    /// Allows a sender which must not block to queue frames itself.
+    static std::string encode(const Frame& frame);
+
+    /// \brief Receives a frame, blocking until one is available
+    /// \param frame frame to receive into
+    /// \return whether or not a frame was received
+    bool receive(Frame& frame);
+
+    /// \brief Encodes an exit code as a frame payload
+    /// \param exitCode exit code to encode
+    /// \return encoded payload
+    static std::string encodeExitCode(int exitCode);
+
+    /// \brief Decodes an exit code from a frame payload
+    /// \param payload payload to decode
+    /// \return decoded exit code
+    static int decodeExitCode(const std::string& payload);
+
+private:
+    int _input; //!< Descriptor to receive frames from
+    int _output; //!< Descriptor to send frames to
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_RemoteChannel
@@ -0,0 +1,485 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "RemoteExecutor.hpp"
+#include "ArgVector.hpp"
+#include "PosixExecutorFanIn.hpp"
+#include "PosixExecutorFanOut.hpp"
+#include "PosixExecutorPipe.hpp"
+#include "PosixExecutorPipeBuffer.hpp"
+#include "PosixExecutorPipeRelay.hpp"
+#include "PosixExecutorRace.hpp"
+#include "PosixExecutorPipeStream.hpp"
+#include "RemoteExecutorFileStream.hpp"
+#include "RemoteExecutorJob.hpp"
+#include "RemoteSpawn.hpp"
+#include "utility/block_sigpipe.hpp"
+#include "utility/make_unique.hpp"
+#include "utility/read_write_all.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using utility::block_sigpipe;
+using utility::make_unique;
+using utility::write_all;
+
+namespace {
+
+/// \brief Duplicates a descriptor for exclusive use by a job
+/// \param file descriptor to duplicate
+/// \return duplicated descriptor
+int duplicate(int file)
+{
+    auto copy = ::fcntl(file, F_DUPFD_CLOEXEC, 0);
+    if (copy < 0) {
+        std::perror("rshell: unable to duplicate descriptor");
+        throw std::runtime_error{"unable to duplicate descriptor"};
+    }
+
+    return copy;
+}
+
+}
+
+namespace rshell {
+
+RemoteExecutor::RemoteExecutor(int socket)
+    : _socket{socket}
+    , _channel{socket, socket}
+{
+    _receiver = std::thread{&RemoteExecutor::receive, this};
+}
+
+RemoteExecutor::~RemoteExecutor()
+{
+    // Ending the stream to the worker lets it finish its jobs and disconnect,
+    // which ends the receiver and, in turn, the input relays
+    ::shutdown(_socket, SHUT_WR);
+    _receiver.join();
+
+    {
+        std::unique_lock<std::mutex> lock{_mutex};
+        _changed.wait(lock, [this] { return _relays == 0; });
+    }
+
+    ::close(_socket);
+
+    if (_transport > 0) {
+        int status;
+        waitpid(_transport, &status, 0);
+    }
+}
+
+std::unique_ptr<RemoteExecutor> RemoteExecutor::spawn(
+        const std::string& transport)
+{
+    int sockets[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0) {
+        std::perror("rshell: unable to create socket pair");
+        throw std::runtime_error{"unable to create socket pair"};
+    }
+
+    auto pid = fork();
+    if (pid == 0) {
+        // The transport reaches the worker through its standard input and
+        // output; its standard error remains the shell's
+        ::dup2(sockets[1], STDIN_FILENO);
+        ::dup2(sockets[1], STDOUT_FILENO);
+
+        ArgVector argv{"sh", {"-c", transport}};
+        execv("/bin/sh", argv);
+
+        std::perror("rshell: exec failed");
+        _exit(1);
+    }
+    else if (pid < 0) {
+        std::perror("rshell: fork failed");
+        ::close(sockets[0]);
+        ::close(sockets[1]);
+        throw std::runtime_error{"unable to fork"};
+    }
+
+    ::close(sockets[1]);
+    auto executor = make_unique<RemoteExecutor>(sockets[0]);
+    executor->_transport = pid;
+    return executor;
+}
+
+std::unique_ptr<ExecutorPipe> RemoteExecutor::createPipe(
+        std::size_t capacity)
+{
+    return make_unique<PosixExecutorPipe>(
+            capacity > 0 ? capacity : _pipeCapacity);
+}
+
+std::unique_ptr<ExecutorPipeRelay> RemoteExecutor::createPipeRelay()
+{
+    return make_unique<PosixExecutorPipeRelay>();
+}
+
+std::unique_ptr<ExecutorPipeBuffer> RemoteExecutor::createPipeBuffer(
+        std::shared_ptr<ExecutorPipe> input,
+        std::shared_ptr<ExecutorPipe> output)
+{
+    return make_unique<PosixExecutorPipeBuffer>(std::move(input),
+            std::move(output), _pipeBufferLimit);
+}
+
+std::unique_ptr<ExecutorFan> RemoteExecutor::createFanOut(
+        std::shared_ptr<ExecutorPipe> input,
+        std::vector<std::shared_ptr<ExecutorPipe>> outputs)
+{
+    return make_unique<PosixExecutorFanOut>(std::move(input),
+            std::move(outputs));
+}
+
+std::unique_ptr<ExecutorFan> RemoteExecutor::createFanIn(
+        std::vector<std::shared_ptr<ExecutorPipe>> inputs,
+        std::shared_ptr<ExecutorPipe> output)
+{
+    return make_unique<PosixExecutorFanIn>(std::move(inputs),
+            std::move(output));
+}
+
+std::unique_ptr<ExecutorRace> RemoteExecutor::createRace(
+        std::vector<std::shared_ptr<ExecutorPipe>> inputs,
+        std::shared_ptr<ExecutorStream> output)
+{
+    return make_unique<PosixExecutorRace>(std::move(inputs),
+            std::move(output));
+}
+
+std::unique_ptr<ExecutorStream> RemoteExecutor::createInputFileStream(
+        const std::string& path)
+{
+    return make_unique<RemoteExecutorFileStream>(path,
+            RemoteSpawn::StreamKind::ReadFile);
+}
+
+std::unique_ptr<ExecutorStream> RemoteExecutor::createOutputFileStream(
+        const std::string& path)
+{
+    return make_unique<RemoteExecutorFileStream>(path,
+            RemoteSpawn::StreamKind::WriteFile);
+}
+
+std::unique_ptr<ExecutorStream> RemoteExecutor::createAppendFileStream(
+        const std::string& path)
+{
+    return make_unique<RemoteExecutorFileStream>(path,
+            RemoteSpawn::StreamKind::AppendFile);
+}
+
+int RemoteExecutor::execute(ExecutableCommand& command,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    // A command whose deadline has already passed is not started
+    if (context.isPastDeadline()) {
+        return ExecutorJob::timeoutExitCode;
+    }
+
+    RemoteSpawn spawn;
+    spawn.arguments.push_back(command.program);
+    spawn.arguments.insert(std::end(spawn.arguments),
+            std::begin(command.arguments), std::end(command.arguments));
+
+    // Translate the streams of the context.  Files are opened by the worker,
+    // while local pipes are duplicated so that the job may outlive the
+    // streams.  Only the standard input and output may be replaced
+    for (auto&& stream : context.streams()) {
+        if (stream.first != STDIN_FILENO && stream.first != STDOUT_FILENO) {
+            throw std::runtime_error{"unsupported stream descriptor"};
+        }
+    }
+
+    auto inputStream = context.stream(STDIN_FILENO);
+    auto outputStream = context.stream(STDOUT_FILENO);
+
+    int input = -1;
+    if (auto stream = dynamic_cast<RemoteExecutorFileStream*>(inputStream)) {
+        spawn.inputKind = stream->kind();
+        spawn.inputPath = stream->path();
+    }
+    else if (auto stream =
+            dynamic_cast<PosixExecutorPipeStream*>(inputStream)) {
+        spawn.inputKind = RemoteSpawn::StreamKind::Relay;
+        input = duplicate(stream->file());
+    }
+    else if (inputStream != nullptr) {
+        throw std::runtime_error{"unsupported input stream"};
+    }
+
+    int output = -1;
+    if (auto stream = dynamic_cast<RemoteExecutorFileStream*>(outputStream)) {
+        spawn.outputKind = stream->kind();
+        spawn.outputPath = stream->path();
+    }
+    else if (auto stream =
+            dynamic_cast<PosixExecutorPipeStream*>(outputStream)) {
+        output = duplicate(stream->file());
+    }
+    else if (outputStream == nullptr) {
+        output = duplicate(STDOUT_FILENO);
+    }
+    else {
+        if (input >= 0) {
+            ::close(input);
+        }
+
+        throw std::runtime_error{"unsupported output stream"};
+    }
+
+    std::uint32_t id;
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        id = _nextJob++;
+
+        // Jobs left running are forgotten once they finish, unless the
+        // context adopts them to wait for them later
+        auto& job = _jobs[id];
+        job.output = output;
+        job.isDetached = waitMode == WaitMode::Continue &&
+            !context.hasJobHandler();
+        job.started = std::chrono::steady_clock::now();
+
+        if (!_isConnected ||
+                !_channel.send({RemoteChannel::FrameType::Spawn, id,
+                    spawn.encode()})) {
+            finish(job, 1);
+            _jobs.erase(id);
+            if (input >= 0) {
+                ::close(input);
+            }
+
+            throw std::runtime_error{"worker is not connected"};
+        }
+
+        if (input >= 0) {
+            ++_relays;
+        }
+    }
+
+    if (input >= 0) {
+        std::thread{&RemoteExecutor::relay, this, id, input}.detach();
+    }
+
+    // Skip waiting if we are meant to continue, handing the job to whoever
+    // will wait for it instead
+    switch (waitMode) {
+        case WaitMode::Continue:
+            if (context.hasJobHandler()) {
+                context.adopt(make_unique<RemoteExecutorJob>(*this, id,
+                            context.deadline()));
+            }
+
+            return 0;
+
+        case WaitMode::Wait:
+            break;
+    }
+
+    return await(id, context.deadline()).exitCode;
+}
+
+JobStatus RemoteExecutor::await(std::uint32_t id,
+        std::chrono::steady_clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> lock{_mutex};
+    auto isFinished = [&] { return _jobs[id].isFinished; };
+
+    // Terminate a job which passes its deadline, then kill it if it outlasts
+    // the grace period
+    auto isTimedOut = false;
+    if (deadline != std::chrono::steady_clock::time_point::max() &&
+            !_changed.wait_until(lock, deadline, isFinished)) {
+        isTimedOut = true;
+        lock.unlock();
+        cancel(id);
+        lock.lock();
+        if (!_changed.wait_for(lock, ExecutorJob::terminationGrace,
+                    isFinished)) {
+            lock.unlock();
+            cancel(id, true);
+            lock.lock();
+        }
+    }
+
+    _changed.wait(lock, isFinished);
+
+    JobStatus status;
+    status.exitCode = isTimedOut ? ExecutorJob::timeoutExitCode :
+        _jobs[id].exitCode;
+    status.wallTime = _jobs[id].finished - _jobs[id].started;
+    _jobs.erase(id);
+    return status;
+}
+
+void RemoteExecutor::cancel(std::uint32_t id, bool kills)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto job = _jobs.find(id);
+    if (_isConnected && job != std::end(_jobs) && !job->second.isFinished) {
+        _channel.send({RemoteChannel::FrameType::Cancel, id,
+                kills ? "kill" : ""});
+    }
+}
+
+void RemoteExecutor::detach(std::uint32_t id)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto job = _jobs.find(id);
+    if (job != std::end(_jobs)) {
+        if (job->second.isFinished) {
+            _jobs.erase(job);
+        }
+        else {
+            job->second.isDetached = true;
+        }
+    }
+}
+
+void RemoteExecutor::receive()
+{
+    block_sigpipe();
+
+    RemoteChannel::Frame frame;
+    while (_channel.receive(frame)) {
+        switch (frame.type) {
+            case RemoteChannel::FrameType::Output: {
+                int output;
+                {
+                    std::lock_guard<std::mutex> lock{_mutex};
+                    auto job = _jobs.find(frame.job);
+                    output = job != std::end(_jobs) ? job->second.output : -1;
+                }
+
+                // Write outside of the lock, as the reader of a local pipe
+                // may be another job relaying through this executor
+                if (output >= 0 && !write_all(output, frame.payload.data(),
+                            frame.payload.size())) {
+                    std::lock_guard<std::mutex> lock{_mutex};
+                    auto job = _jobs.find(frame.job);
+                    if (job != std::end(_jobs) && job->second.output >= 0) {
+                        ::close(job->second.output);
+                        job->second.output = -1;
+                        _channel.send({RemoteChannel::FrameType::Hangup,
+                                frame.job, {}});
+                    }
+                }
+
+                break;
+            }
+
+            case RemoteChannel::FrameType::Error:
+                write_all(STDERR_FILENO, frame.payload.data(),
+                        frame.payload.size());
+                break;
+
+            case RemoteChannel::FrameType::Exit: {
+                std::lock_guard<std::mutex> lock{_mutex};
+                auto job = _jobs.find(frame.job);
+                if (job != std::end(_jobs)) {
+                    finish(job->second,
+                            RemoteChannel::decodeExitCode(frame.payload));
+                    if (job->second.isDetached) {
+                        _jobs.erase(job);
+                    }
+                }
+
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    // Jobs cannot finish once the worker is gone, so fail them
+    std::lock_guard<std::mutex> lock{_mutex};
+    _isConnected = false;
+    for (auto job = std::begin(_jobs); job != std::end(_jobs); ) {
+        if (!job->second.isFinished) {
+            std::fputs("rshell: worker disconnected\n", stderr);
+            finish(job->second, 1);
+        }
+
+        job = job->second.isDetached ? _jobs.erase(job) : std::next(job);
+    }
+}
+
+void RemoteExecutor::relay(std::uint32_t id, int file)
+{
+    char buffer[65536];
+    while (true) {
+        // Poll with a timeout so that the relay notices when its job has
+        // finished without consuming all of its input
+        pollfd entry{file, POLLIN, 0};
+        auto ready = ::poll(&entry, 1, 100);
+
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            auto job = _jobs.find(id);
+            if (!_isConnected || job == std::end(_jobs) ||
+                    job->second.isFinished) {
+                break;
+            }
+        }
+
+        if (ready <= 0) {
+            continue;
+        }
+
+        auto count = ::read(file, buffer, sizeof buffer);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+
+        // An empty input frame marks the end of the input
+        std::lock_guard<std::mutex> lock{_mutex};
+        std::string payload(buffer, count > 0 ? count : 0);
+        if (!_channel.send({RemoteChannel::FrameType::Input, id, payload}) ||
+                count <= 0) {
+            break;
+        }
+    }
+
+    ::close(file);
+
+    std::lock_guard<std::mutex> lock{_mutex};
+    --_relays;
+    _changed.notify_all();
+}
+
+void RemoteExecutor::finish(Job& job, int exitCode)
+{
+    if (job.output >= 0) {
+        ::close(job.output);
+        job.output = -1;
+    }
+
+    job.isFinished = true;
+    job.exitCode = exitCode;
+    job.finished = std::chrono::steady_clock::now();
+    _changed.notify_all();
+}
+
+} // namespace rshell
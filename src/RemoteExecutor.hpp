@@ -0,0 +1,227 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::RemoteExecutor class
+
+#ifndef hpp_rshell_RemoteExecutor
+#define hpp_rshell_RemoteExecutor
+
+#include "Executor.hpp"
+#include "RemoteChannel.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <sys/types.h>
+
+namespace rshell {
+
+/// \brief Implementation of the executor strategy which executes commands on
+/// a \ref RemoteWorker over a framed protocol
+///
+/// Each executable command is sent to the worker as a job with its argv and
+/// redirections.  Redirections to files name files on the worker host.
+/// Pipes between commands are local to the executor, which relays their
+/// contents to and from the worker, so a pipeline may mix executors.  The
+/// standard input of the shell is not relayed; jobs without an input stream
+/// read from an empty input, as with asynchronous commands.  The standard
+/// output and error of each job are streamed back as the job runs.
+class RemoteExecutor : public Executor
+{
+public:
+    /// \brief Constructs a new instance of the \ref RemoteExecutor class on a
+    /// connected socket
+    /// \param socket socket connected to a worker, which the executor takes
+    /// ownership of
+    explicit RemoteExecutor(int socket);
+
+    /// \brief Destructs the \ref RemoteExecutor instance
+    ///
+    /// Closes the connection, waiting for relayed jobs to finish and for the
+    /// transport process, if any, to exit.
+    virtual ~RemoteExecutor();
+
+    RemoteExecutor(const RemoteExecutor&) = delete;
+    RemoteExecutor& operator=(const RemoteExecutor&) = delete;
+
+    /// \brief Creates an executor connected to a worker through a transport
+    /// command
+    /// \param transport shell command whose standard input and output reach
+    /// a worker, such as "ssh host rshell -w"
+    /// \return executor connected to the worker
+    ///
+    /// The transport command is run with /bin/sh on one end of a socketpair.
+    static std::unique_ptr<RemoteExecutor> spawn(const std::string& transport);
+
+    /// \brief Creates a new local pipe on the executor
+    /// \param capacity capacity of the pipe in bytes, or zero for the
+    /// default capacity of the executor
+    /// \return pointer to new pipe
+    virtual std::unique_ptr<ExecutorPipe> createPipe(
+            std::size_t capacity = 0) override;
+
+    /// \brief Creates a new relay for profiling the local pipes of the
+    /// executor
+    /// \return pointer to new relay
+    virtual std::unique_ptr<ExecutorPipeRelay> createPipeRelay() override;
+
+    /// \brief Creates a new buffer passing one local pipe of the executor into
+    /// another, so that the writer of the first never waits on the reader of
+    /// the second
+    /// \param input pipe whose read end the buffer takes
+    /// \param output pipe whose write end the buffer takes
+    /// \return pointer to new buffer
+    virtual std::unique_ptr<ExecutorPipeBuffer> createPipeBuffer(
+            std::shared_ptr<ExecutorPipe> input,
+            std::shared_ptr<ExecutorPipe> output) override;
+
+    /// \brief Creates a new fan duplicating one local pipe of the executor
+    /// into several
+    /// \param input pipe whose read end the fan takes
+    /// \param outputs pipes whose write ends the fan takes
+    /// \return pointer to new fan
+    virtual std::unique_ptr<ExecutorFan> createFanOut(
+            std::shared_ptr<ExecutorPipe> input,
+            std::vector<std::shared_ptr<ExecutorPipe>> outputs) override;
+
+    /// \brief Creates a new fan merging several local pipes of the executor
+    /// into one a line at a time
+    /// \param inputs pipes whose read ends the fan takes
+    /// \param output pipe whose write end the fan takes
+    /// \return pointer to new fan
+    virtual std::unique_ptr<ExecutorFan> createFanIn(
+            std::vector<std::shared_ptr<ExecutorPipe>> inputs,
+            std::shared_ptr<ExecutorPipe> output) override;
+
+    /// \brief Creates a new race passing on the output of one of several
+    /// commands of the executor
+    /// \param inputs local pipes whose read ends the race takes, one per
+    /// command
+    /// \param output local stream to pass the chosen output to, or \c null
+    /// for the standard output of the shell
+    /// \return pointer to new race
+    virtual std::unique_ptr<ExecutorRace> createRace(
+            std::vector<std::shared_ptr<ExecutorPipe>> inputs,
+            std::shared_ptr<ExecutorStream> output) override;
+
+    /// \brief Creates a new input file stream on the worker host
+    /// \param path path to open the stream on
+    /// \return pointer to new stream
+    virtual std::unique_ptr<ExecutorStream> createInputFileStream(
+            const std::string& path) override;
+
+    /// \brief Creates a new output file stream on the worker host
+    /// \param path path to open the stream on
+    /// \return pointer to new stream
+    virtual std::unique_ptr<ExecutorStream> createOutputFileStream(
+            const std::string& path) override;
+
+    /// \brief Creates a new append file stream on the worker host
+    /// \param path path to open the stream on
+    /// \return pointer to new stream
+    virtual std::unique_ptr<ExecutorStream> createAppendFileStream(
+            const std::string& path) override;
+
+    using Executor::execute;
+
+    /// \brief Executes the individual command given on the worker
+    /// \param command command to execute
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the command
+    ///
+    /// Jobs execute in the environment of the worker, so a replaced
+    /// environment in the context is not forwarded.
+    virtual int execute(ExecutableCommand& command,
+            const ExecutionContext& context,
+            WaitMode waitMode = WaitMode::Wait) override;
+
+private:
+    friend class RemoteExecutorJob;
+
+    /// \brief State of a job executing on the worker
+    struct Job
+    {
+        int output{-1}; //!< Local descriptor receiving standard output
+        bool isDetached{false}; //!< Whether or not no one waits for the job
+        bool isFinished{false}; //!< Whether or not the job has finished
+        int exitCode{0}; //!< Exit code of the job
+
+        /// \brief Time at which the job was started
+        std::chrono::steady_clock::time_point started;
+
+        /// \brief Time at which the job finished
+        std::chrono::steady_clock::time_point finished;
+    };
+
+    int _socket; //!< Socket connected to the worker
+    pid_t _transport{-1}; //!< Process identifier of the transport, if any
+    RemoteChannel _channel; //!< Framed channel over the socket
+
+    std::mutex _mutex; //!< Guards the members below and sending frames
+    std::condition_variable _changed; //!< Signals job and relay changes
+    std::map<std::uint32_t, Job> _jobs; //!< Jobs by identifier
+    std::uint32_t _nextJob{0}; //!< Identifier of the next job
+    std::size_t _relays{0}; //!< Number of running input relays
+    bool _isConnected{true}; //!< Whether or not the worker is reachable
+
+    std::thread _receiver; //!< Thread receiving frames from the worker
+
+    /// \brief Receives frames from the worker until it disconnects,
+    /// dispatching them to their jobs
+    void receive();
+
+    /// \brief Relays a local descriptor to the standard input of a job
+    /// \param job identifier of the job
+    /// \param file descriptor to relay, which the relay closes
+    void relay(std::uint32_t job, int file);
+
+    /// \brief Waits for a job to finish and forgets it
+    /// \param job identifier of the job
+    /// \param deadline time after which the job is terminated, and killed
+    /// if it outlasts the grace period
+    /// \return status of the job, without resource usage, with
+    /// \ref ExecutorJob::timeoutExitCode as the exit code if it passed its
+    /// deadline
+    JobStatus await(std::uint32_t job,
+            std::chrono::steady_clock::time_point deadline =
+                std::chrono::steady_clock::time_point::max());
+
+    /// \brief Asks the worker to terminate a job
+    /// \param job identifier of the job
+    /// \param kills whether the job is killed rather than terminated
+    void cancel(std::uint32_t job, bool kills = false);
+
+    /// \brief Abandons a job, forgetting it once it has finished
+    /// \param job identifier of the job
+    void detach(std::uint32_t job);
+
+    /// \brief Marks a job finished and releases its output descriptor
+    /// \param job job to finish
+    /// \param exitCode exit code of the job
+    ///
+    /// The mutex must be held.
+    void finish(Job& job, int exitCode);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_RemoteExecutor
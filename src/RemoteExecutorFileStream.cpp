@@ -0,0 +1,40 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "RemoteExecutorFileStream.hpp"
+
+namespace rshell {
+
+RemoteExecutorFileStream::RemoteExecutorFileStream(const std::string& path,
+        RemoteSpawn::StreamKind kind)
+    : ExecutorStream{kind == RemoteSpawn::StreamKind::ReadFile ?
+        Mode::Input : Mode::Output}
+    , _path{path}
+    , _kind{kind}
+{
+}
+
+RemoteExecutorFileStream::~RemoteExecutorFileStream() = default;
+
+void RemoteExecutorFileStream::activate(int slot)
+{
+}
+
+void RemoteExecutorFileStream::close()
+{
+}
+
+} // namespace rshell
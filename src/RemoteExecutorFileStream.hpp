@@ -0,0 +1,74 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the
+/// \ref rshell::RemoteExecutorFileStream class
+
+#ifndef hpp_rshell_RemoteExecutorFileStream
+#define hpp_rshell_RemoteExecutorFileStream
+
+#include "ExecutorStream.hpp"
+#include "RemoteSpawn.hpp"
+#include <string>
+
+namespace rshell {
+
+/// \brief Executor stream for a file on the host of a \ref RemoteWorker
+///
+/// The stream is only a path; the worker opens the file when it spawns the
+/// job that uses the stream.
+class RemoteExecutorFileStream : public ExecutorStream
+{
+public:
+    /// \brief Constructs a new instance of the
+    /// \ref RemoteExecutorFileStream class on the given path
+    /// \param path path to the file on the worker host
+    /// \param kind how the worker opens the file
+    explicit RemoteExecutorFileStream(const std::string& path,
+            RemoteSpawn::StreamKind kind);
+
+    /// \brief Destructs the \ref RemoteExecutorFileStream instance
+    virtual ~RemoteExecutorFileStream();
+
+    /// \brief Gets the path to the file on the worker host
+    /// \return path to the file
+    const std::string& path() const noexcept { return _path; }
+
+    /// \brief Gets how the worker opens the file
+    /// \return kind of the stream
+    RemoteSpawn::StreamKind kind() const noexcept { return _kind; }
+
+    /// \brief Activates the stream on the given descriptor of the calling
+    /// process
+    /// \param slot descriptor to replace with the stream
+    ///
+    /// Does nothing, as the worker opens the file.
+    virtual void activate(int slot) override;
+
+    /// \brief Closes the stream
+    ///
+    /// Does nothing, as the worker closes the file.
+    virtual void close() override;
+
+protected:
+    std::string _path; //!< Path to the file on the worker host
+    RemoteSpawn::StreamKind _kind; //!< How the worker opens the file
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_RemoteExecutorFileStream
@@ -0,0 +1,53 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "RemoteExecutorJob.hpp"
+#include "RemoteExecutor.hpp"
+#include <stdexcept>
+
+namespace rshell {
+
+RemoteExecutorJob::RemoteExecutorJob(RemoteExecutor& executor,
+        std::uint32_t id, std::chrono::steady_clock::time_point deadline)
+    : _executor(executor)
+    , _id{id}
+    , _deadline{deadline}
+{
+}
+
+RemoteExecutorJob::~RemoteExecutorJob()
+{
+    if (!_isWaited) {
+        _executor.detach(_id);
+    }
+}
+
+JobStatus RemoteExecutorJob::wait()
+{
+    if (_isWaited) {
+        throw std::runtime_error{"job has already been waited for"};
+    }
+
+    _isWaited = true;
+    return _executor.await(_id, _deadline);
+}
+
+void RemoteExecutorJob::cancel()
+{
+    _executor.cancel(_id);
+}
+
+} // namespace rshell
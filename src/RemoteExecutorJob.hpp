@@ -0,0 +1,74 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::RemoteExecutorJob class
+
+#ifndef hpp_rshell_RemoteExecutorJob
+#define hpp_rshell_RemoteExecutorJob
+
+#include "ExecutorJob.hpp"
+#include <chrono>
+#include <cstdint>
+
+namespace rshell {
+
+// Forward declarations
+class RemoteExecutor;
+
+/// \brief Implementation of the executor job on a job of a remote worker
+///
+/// The worker reports only the exit code of its jobs, so the status of a
+/// remote job includes its wall time but no resource usage.
+class RemoteExecutorJob : public ExecutorJob
+{
+public:
+    /// \brief Constructs a new instance of the \ref RemoteExecutorJob class
+    /// \param executor executor which started the job
+    /// \param id identifier of the job on the executor
+    /// \param deadline time after which the job is terminated
+    RemoteExecutorJob(RemoteExecutor& executor, std::uint32_t id,
+            std::chrono::steady_clock::time_point deadline =
+                std::chrono::steady_clock::time_point::max());
+
+    /// \brief Destructs the \ref RemoteExecutorJob instance
+    ///
+    /// Abandons the job if it has not been waited for.
+    virtual ~RemoteExecutorJob();
+
+    RemoteExecutorJob(const RemoteExecutorJob&) = delete;
+    RemoteExecutorJob& operator=(const RemoteExecutorJob&) = delete;
+
+    /// \brief Waits for the job to finish on the worker
+    /// \return status of the job
+    virtual JobStatus wait() override;
+
+    /// \brief Asks the worker to terminate the job
+    virtual void cancel() override;
+
+private:
+    RemoteExecutor& _executor; //!< Executor which started the job
+    std::uint32_t _id; //!< Identifier of the job on the executor
+
+    /// \brief Time after which the job is terminated
+    std::chrono::steady_clock::time_point _deadline;
+
+    bool _isWaited{false}; //!< Whether or not the job has been waited for
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_RemoteExecutorJob
@@ -0,0 +1,126 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "RemoteSpawn.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <arpa/inet.h>
+
+namespace {
+
+/// \brief Appends a length-prefixed string to a payload
+/// \param payload payload to append to
+/// \param text string to append
+void putString(std::string& payload, const std::string& text)
+{
+    auto length = htonl(static_cast<std::uint32_t>(text.size()));
+    payload.append(reinterpret_cast<const char*>(&length), sizeof length);
+    payload += text;
+}
+
+/// \brief Takes a length-prefixed string from a payload
+/// \param payload payload to take from
+/// \param offset offset of the string, advanced past it
+/// \return taken string
+std::string takeString(const std::string& payload, std::size_t& offset)
+{
+    std::uint32_t length;
+    if (payload.size() - offset < sizeof length) {
+        throw std::runtime_error{"malformed spawn request"};
+    }
+
+    std::memcpy(&length, &payload[offset], sizeof length);
+    length = ntohl(length);
+    offset += sizeof length;
+    if (payload.size() - offset < length) {
+        throw std::runtime_error{"malformed spawn request"};
+    }
+
+    auto text = payload.substr(offset, length);
+    offset += length;
+    return text;
+}
+
+/// \brief Takes a stream kind from a payload
+/// \param payload payload to take from
+/// \param offset offset of the kind, advanced past it
+/// \return taken stream kind
+rshell::RemoteSpawn::StreamKind takeKind(const std::string& payload,
+        std::size_t& offset)
+{
+    if (offset >= payload.size()) {
+        throw std::runtime_error{"malformed spawn request"};
+    }
+
+    auto kind = static_cast<std::uint8_t>(payload[offset++]);
+    if (kind > static_cast<std::uint8_t>(
+                rshell::RemoteSpawn::StreamKind::AppendFile)) {
+        throw std::runtime_error{"malformed spawn request"};
+    }
+
+    return static_cast<rshell::RemoteSpawn::StreamKind>(kind);
+}
+
+}
+
+namespace rshell {
+
+std::string RemoteSpawn::encode() const
+{
+    std::string payload;
+    auto count = htonl(static_cast<std::uint32_t>(arguments.size()));
+    payload.append(reinterpret_cast<const char*>(&count), sizeof count);
+    for (auto&& argument : arguments) {
+        putString(payload, argument);
+    }
+
+    payload += static_cast<char>(inputKind);
+    putString(payload, inputPath);
+    payload += static_cast<char>(outputKind);
+    putString(payload, outputPath);
+    return payload;
+}
+
+RemoteSpawn RemoteSpawn::decode(const std::string& payload)
+{
+    RemoteSpawn spawn;
+    std::size_t offset = 0;
+
+    std::uint32_t count;
+    if (payload.size() < sizeof count) {
+        throw std::runtime_error{"malformed spawn request"};
+    }
+
+    std::memcpy(&count, payload.data(), sizeof count);
+    count = ntohl(count);
+    offset += sizeof count;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        spawn.arguments.push_back(takeString(payload, offset));
+    }
+
+    spawn.inputKind = takeKind(payload, offset);
+    spawn.inputPath = takeString(payload, offset);
+    spawn.outputKind = takeKind(payload, offset);
+    spawn.outputPath = takeString(payload, offset);
+
+    if (spawn.arguments.empty()) {
+        throw std::runtime_error{"spawn request has no program"};
+    }
+
+    return spawn;
+}
+
+} // namespace rshell
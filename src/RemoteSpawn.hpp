@@ -0,0 +1,61 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::RemoteSpawn structure
+
+#ifndef hpp_rshell_RemoteSpawn
+#define hpp_rshell_RemoteSpawn
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rshell {
+
+/// \brief Request for a \ref RemoteWorker to execute a command
+struct RemoteSpawn
+{
+    /// \brief Sources and destinations of the standard streams of a job
+    enum class StreamKind : std::uint8_t
+    {
+        Null = 0, //!< Standard input is empty
+        Relay = 1, //!< Stream is relayed over the channel
+        ReadFile = 2, //!< Standard input is a file on the worker
+        WriteFile = 3, //!< Standard output truncates a file on the worker
+        AppendFile = 4, //!< Standard output appends to a file on the worker
+    };
+
+    std::vector<std::string> arguments; //!< Program and its arguments
+    StreamKind inputKind{StreamKind::Null}; //!< Source of standard input
+    std::string inputPath; //!< Path of the input file, if any
+    StreamKind outputKind{StreamKind::Relay}; //!< Destination of output
+    std::string outputPath; //!< Path of the output file, if any
+
+    /// \brief Encodes the request as a frame payload
+    /// \return encoded payload
+    std::string encode() const;
+
+    /// \brief Decodes a request from a frame payload
+    /// \param payload payload to decode
+    /// \return decoded request
+    /// \throw std::runtime_error if the payload is malformed
+    static RemoteSpawn decode(const std::string& payload);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_RemoteSpawn
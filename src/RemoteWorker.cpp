@@ -0,0 +1,425 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "RemoteWorker.hpp"
+#include "ExecutableCommand.hpp"
+#include "ExecutionContext.hpp"
+#include "ExecutorStream.hpp"
+#include "ExitException.hpp"
+#include "Parser.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+/// \brief Closes a descriptor if it is open and marks it closed
+/// \param file descriptor to close
+void release(int& file)
+{
+    if (file >= 0) {
+        ::close(file);
+        file = -1;
+    }
+}
+
+}
+
+namespace rshell {
+
+constexpr std::size_t RemoteWorker::outgoingLimit;
+
+RemoteWorker::RemoteWorker(Executor& executor, int input, int output)
+    : _executor(executor)
+    , _input{input}
+    , _output{output}
+    , _channel{input, output}
+{
+}
+
+int RemoteWorker::run()
+{
+    // Input relayed to a job that has exited must fail rather than terminate
+    // the worker.  Jobs restore the default disposition before executing
+    ::signal(SIGPIPE, SIG_IGN);
+
+    // The worker never blocks sending frames, as the executor may itself be
+    // blocked sending input to the worker
+    ::fcntl(_output, F_SETFL, ::fcntl(_output, F_GETFL) | O_NONBLOCK);
+
+    auto isConnected = true;
+    while (isConnected || !_jobs.empty() || !_outgoing.empty()) {
+        // Watch the channel, the output of every job while the outgoing
+        // frames are below their limit, and the input of every job with
+        // pending input
+        std::vector<pollfd> entries;
+        std::vector<std::pair<std::uint32_t, int*>> files;
+        if (isConnected) {
+            entries.push_back({_input, POLLIN, 0});
+            files.push_back({0, &_input});
+        }
+
+        if (!_outgoing.empty()) {
+            entries.push_back({_output, POLLOUT, 0});
+            files.push_back({0, &_output});
+        }
+
+        for (auto&& job : _jobs) {
+            if (_outgoing.size() < outgoingLimit && job.second.output >= 0) {
+                entries.push_back({job.second.output, POLLIN, 0});
+                files.push_back({job.first, &job.second.output});
+            }
+
+            if (_outgoing.size() < outgoingLimit && job.second.error >= 0) {
+                entries.push_back({job.second.error, POLLIN, 0});
+                files.push_back({job.first, &job.second.error});
+            }
+
+            if (job.second.input >= 0 && !job.second.pending.empty()) {
+                entries.push_back({job.second.input, POLLOUT, 0});
+                files.push_back({job.first, &job.second.input});
+            }
+        }
+
+        if (::poll(entries.data(), entries.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            std::perror("rshell: unable to poll");
+            return 1;
+        }
+
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].revents == 0) {
+                continue;
+            }
+
+            auto file = files[i].second;
+            if (file == &_input) {
+                RemoteChannel::Frame frame;
+                if (_channel.receive(frame)) {
+                    handle(frame);
+                    continue;
+                }
+
+                // No more input can arrive once the executor is gone
+                isConnected = false;
+                for (auto&& job : _jobs) {
+                    job.second.isInputEnded = true;
+                    flush(job.second);
+                }
+            }
+            else if (file == &_output) {
+                if (!drain()) {
+                    isConnected = false;
+                }
+            }
+            else {
+                auto& job = _jobs[files[i].first];
+                if (file == &job.input) {
+                    flush(job);
+                }
+                else {
+                    forward(files[i].first, *file, file == &job.output ?
+                            RemoteChannel::FrameType::Output :
+                            RemoteChannel::FrameType::Error);
+                }
+            }
+        }
+
+        // A job is finished once it has exited and closed its output
+        for (auto job = std::begin(_jobs); job != std::end(_jobs); ) {
+            if (job->second.output >= 0 || job->second.error >= 0) {
+                ++job;
+                continue;
+            }
+
+            int status;
+            auto exitCode = 1;
+            if (waitpid(job->second.pid, &status, 0) == job->second.pid &&
+                    WIFEXITED(status)) {
+                exitCode = WEXITSTATUS(status);
+            }
+
+            queue({RemoteChannel::FrameType::Exit, job->first,
+                    RemoteChannel::encodeExitCode(exitCode)});
+            release(job->second.input);
+            job = _jobs.erase(job);
+        }
+
+        // Nothing can be delivered once the executor is gone
+        if (!isConnected && _outgoing.size() > 0 && !drain()) {
+            _outgoing.clear();
+        }
+    }
+
+    return 0;
+}
+
+void RemoteWorker::handle(const RemoteChannel::Frame& frame)
+{
+    switch (frame.type) {
+        case RemoteChannel::FrameType::Spawn:
+            try {
+                start(frame.job, RemoteSpawn::decode(frame.payload));
+            }
+            catch (const std::exception& e) {
+                auto message = std::string{"rshell: error: "} + e.what() +
+                    '\n';
+                queue({RemoteChannel::FrameType::Error, frame.job, message});
+                queue({RemoteChannel::FrameType::Exit, frame.job,
+                        RemoteChannel::encodeExitCode(1)});
+            }
+
+            break;
+
+        case RemoteChannel::FrameType::Input: {
+            auto job = _jobs.find(frame.job);
+            if (job == std::end(_jobs) || job->second.input < 0) {
+                break;
+            }
+
+            if (frame.payload.empty()) {
+                job->second.isInputEnded = true;
+            }
+            else {
+                job->second.pending += frame.payload;
+            }
+
+            flush(job->second);
+            break;
+        }
+
+        case RemoteChannel::FrameType::Hangup: {
+            // Closing the read end delivers SIGPIPE to a job that continues
+            // writing, as in a local pipeline
+            auto job = _jobs.find(frame.job);
+            if (job != std::end(_jobs)) {
+                release(job->second.output);
+            }
+
+            break;
+        }
+
+        case RemoteChannel::FrameType::Cancel: {
+            // The job remains until it closes its output, so its process
+            // has not been reaped and still leads its group
+            auto job = _jobs.find(frame.job);
+            if (job != std::end(_jobs)) {
+                ::kill(-job->second.pid,
+                        frame.payload == "kill" ? SIGKILL : SIGTERM);
+            }
+
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void RemoteWorker::start(std::uint32_t id, const RemoteSpawn& spawn)
+{
+    // Create the pipes connecting the job to the worker.  Every descriptor
+    // of the worker is close-on-exec so that jobs do not hold each other's
+    // pipes open
+    int input[2] = {-1, -1};
+    int output[2] = {-1, -1};
+    int error[2] = {-1, -1};
+    auto isRelayed = spawn.inputKind == RemoteSpawn::StreamKind::Relay;
+    auto isCaptured = spawn.outputKind == RemoteSpawn::StreamKind::Relay;
+    if ((isRelayed && ::pipe2(input, O_CLOEXEC) != 0) ||
+            (isCaptured && ::pipe2(output, O_CLOEXEC) != 0) ||
+            ::pipe2(error, O_CLOEXEC) != 0) {
+        std::perror("rshell: unable to pipe");
+        for (auto file : {input[0], input[1], output[0], output[1]}) {
+            release(file);
+        }
+
+        throw std::runtime_error{"unable to pipe"};
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+
+    // Each job leads a process group of its own, so that cancelling it
+    // reaches the programs it executes as well
+    auto pid = fork();
+    if (pid == 0) {
+        ::setpgid(0, 0);
+
+        // Connect the job's end of each pipe to its standard streams
+        auto null = ::open("/dev/null", O_RDONLY);
+        ::dup2(isRelayed ? input[0] : null, STDIN_FILENO);
+        ::dup2(isCaptured ? output[1] : error[1], STDOUT_FILENO);
+        ::dup2(error[1], STDERR_FILENO);
+        ::close(null);
+
+        // The job process does not exec itself, so it must close the
+        // worker's descriptors explicitly; a job holding the input of
+        // another job open would keep that job from reaching end of input
+        for (auto file : {input[0], input[1], output[0], output[1], error[0],
+                error[1], _input, _output}) {
+            release(file);
+        }
+
+        for (auto&& job : _jobs) {
+            release(job.second.input);
+            release(job.second.output);
+            release(job.second.error);
+        }
+
+        work(spawn);
+    }
+
+    // Keep only the worker's end of each pipe
+    release(input[0]);
+    release(output[1]);
+    release(error[1]);
+    if (pid < 0) {
+        std::perror("rshell: fork failed");
+        release(input[1]);
+        release(output[0]);
+        release(error[0]);
+        throw std::runtime_error{"unable to fork"};
+    }
+
+    ::setpgid(pid, pid);
+    auto& job = _jobs[id];
+    job.pid = pid;
+    job.input = input[1];
+    job.output = output[0];
+    job.error = error[0];
+    if (job.input >= 0) {
+        ::fcntl(job.input, F_SETFL, ::fcntl(job.input, F_GETFL) | O_NONBLOCK);
+    }
+}
+
+void RemoteWorker::work(const RemoteSpawn& spawn)
+{
+    ::signal(SIGPIPE, SIG_DFL);
+
+    auto exitCode = 1;
+    try {
+        // Open the files named by the request as executor streams, which
+        // replace the standard streams connected above
+        ExecutionContext context;
+        if (spawn.inputKind == RemoteSpawn::StreamKind::ReadFile) {
+            context = context.withStream(STDIN_FILENO,
+                    _executor.createInputFileStream(spawn.inputPath));
+        }
+
+        if (spawn.outputKind == RemoteSpawn::StreamKind::WriteFile) {
+            context = context.withStream(STDOUT_FILENO,
+                    _executor.createOutputFileStream(spawn.outputPath));
+        }
+        else if (spawn.outputKind == RemoteSpawn::StreamKind::AppendFile) {
+            context = context.withStream(STDOUT_FILENO,
+                    _executor.createAppendFileStream(spawn.outputPath));
+        }
+
+        auto command = Parser::createExecutableCommand(spawn.arguments[0]);
+        command->program = spawn.arguments[0];
+        command->arguments.assign(std::next(std::begin(spawn.arguments)),
+                std::end(spawn.arguments));
+        exitCode = command->execute(_executor, context, WaitMode::Wait);
+    }
+    catch (const ExitException& e) {
+        exitCode = e.exitCode();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "rshell: error: " << e.what() << '\n';
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+    _exit(exitCode);
+}
+
+void RemoteWorker::flush(Job& job)
+{
+    while (!job.pending.empty()) {
+        auto count = ::write(job.input, job.pending.data(),
+                job.pending.size());
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (count < 0 && errno == EAGAIN) {
+            return;
+        }
+        else if (count < 0) {
+            // The job no longer reads its input; discard the rest
+            job.pending.clear();
+            job.isInputEnded = true;
+            break;
+        }
+
+        job.pending.erase(0, count);
+    }
+
+    if (job.isInputEnded) {
+        release(job.input);
+    }
+}
+
+void RemoteWorker::forward(std::uint32_t id, int& file,
+        RemoteChannel::FrameType type)
+{
+    char buffer[65536];
+    auto count = ::read(file, buffer, sizeof buffer);
+    if (count < 0 && (errno == EINTR || errno == EAGAIN)) {
+        return;
+    }
+    else if (count <= 0) {
+        release(file);
+        return;
+    }
+
+    queue({type, id, std::string(buffer, count)});
+}
+
+void RemoteWorker::queue(const RemoteChannel::Frame& frame)
+{
+    _outgoing += RemoteChannel::encode(frame);
+}
+
+bool RemoteWorker::drain()
+{
+    while (!_outgoing.empty()) {
+        auto count = ::write(_output, _outgoing.data(), _outgoing.size());
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (count < 0) {
+            return errno == EAGAIN;
+        }
+
+        _outgoing.erase(0, count);
+    }
+
+    return true;
+}
+
+} // namespace rshell
@@ -0,0 +1,111 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::RemoteWorker class
+
+#ifndef hpp_rshell_RemoteWorker
+#define hpp_rshell_RemoteWorker
+
+#include "Executor.hpp"
+#include "RemoteChannel.hpp"
+#include "RemoteSpawn.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <sys/types.h>
+
+namespace rshell {
+
+/// \brief Executes the jobs requested by a \ref RemoteExecutor with a local
+/// executor, streaming back their output and exit codes
+///
+/// Every job executes in its own forked process, so that any number of jobs,
+/// such as the stages of a pipeline, may execute concurrently.
+class RemoteWorker
+{
+public:
+    /// \brief Number of bytes of outgoing frames above which the output of
+    /// jobs is no longer read
+    static constexpr std::size_t outgoingLimit = 1 << 20;
+
+    /// \brief Constructs a new instance of the \ref RemoteWorker class
+    /// \param executor executor with which to execute jobs
+    /// \param input descriptor to receive frames from
+    /// \param output descriptor to send frames to
+    explicit RemoteWorker(Executor& executor, int input, int output);
+
+    /// \brief Serves jobs until the executor disconnects and every job has
+    /// finished
+    /// \return exit code of the worker
+    int run();
+
+private:
+    /// \brief State of a job executing on the worker
+    struct Job
+    {
+        pid_t pid{-1}; //!< Process identifier of the job
+        int input{-1}; //!< Write end of the job's standard input, if any
+        int output{-1}; //!< Read end of the job's standard output, if any
+        int error{-1}; //!< Read end of the job's standard error, if any
+        std::string pending; //!< Relayed input not yet written to the job
+        bool isInputEnded{false}; //!< Whether or not the input has ended
+    };
+
+    Executor& _executor; //!< Executor with which to execute jobs
+    int _input; //!< Descriptor to receive frames from
+    int _output; //!< Descriptor to send frames to
+    RemoteChannel _channel; //!< Framed channel to the executor
+    std::map<std::uint32_t, Job> _jobs; //!< Jobs by identifier
+    std::string _outgoing; //!< Encoded frames not yet sent
+
+    /// \brief Handles a frame received from the executor
+    /// \param frame frame to handle
+    void handle(const RemoteChannel::Frame& frame);
+
+    /// \brief Starts a requested job
+    /// \param id identifier of the job
+    /// \param spawn request describing the job
+    void start(std::uint32_t id, const RemoteSpawn& spawn);
+
+    /// \brief Executes a job within its forked process
+    /// \param spawn request describing the job
+    [[noreturn]] void work(const RemoteSpawn& spawn);
+
+    /// \brief Writes as much pending input to a job as it accepts, closing
+    /// its input once the input has ended
+    /// \param job job to write to
+    void flush(Job& job);
+
+    /// \brief Forwards available output of a job to the executor
+    /// \param id identifier of the job
+    /// \param file output descriptor, closed at end of output
+    /// \param type type of frame to forward as
+    void forward(std::uint32_t id, int& file, RemoteChannel::FrameType type);
+
+    /// \brief Queues a frame to be sent to the executor
+    /// \param frame frame to queue
+    void queue(const RemoteChannel::Frame& frame);
+
+    /// \brief Sends as much of the queued frames as the channel accepts
+    /// \return whether or not the executor is still reachable
+    bool drain();
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_RemoteWorker
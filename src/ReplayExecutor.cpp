@@ -0,0 +1,210 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "ReplayExecutor.hpp"
+#include "ExitException.hpp"
+#include "PosixExecutorPipeStream.hpp"
+#include "RecordingExecutor.hpp"
+#include "ReplayExecutorJob.hpp"
+#include "utility/make_unique.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <arpa/inet.h>
+
+using utility::make_unique;
+
+namespace {
+
+using namespace rshell;
+
+/// \brief Describes how a command differs from its recording
+/// \param recorded command as recorded
+/// \param command command as executed
+/// \return field that differs with both of its values, or an empty string
+/// if the command matches its recording
+std::string differenceOf(const RecordedCommand& recorded,
+        const RecordedCommand& command)
+{
+    if (recorded.isSubshell != command.isSubshell ||
+            recorded.arguments != command.arguments) {
+        return "arguments differ: expected " + recorded.describe() +
+            ", got " + command.describe();
+    }
+
+    if (recorded.input != command.input) {
+        return command.describe() + ": input digest differs: expected " +
+            recorded.input + ", got " + command.input;
+    }
+
+    if (recorded.environment != command.environment) {
+        return command.describe() + ": environment differs: expected " +
+            recorded.environment + ", got " + command.environment;
+    }
+
+    return {};
+}
+
+}
+
+namespace rshell {
+
+ReplayExecutor::ReplayExecutor(const std::string& path)
+{
+    std::ifstream input{path, std::ios::binary};
+    if (!input) {
+        std::perror("rshell: unable to open recording");
+        throw std::runtime_error{"unable to open recording " + path};
+    }
+
+    std::string recording{std::istreambuf_iterator<char>{input},
+        std::istreambuf_iterator<char>{}};
+    if (recording.compare(0, RecordedCommand::header.size(),
+                RecordedCommand::header) != 0) {
+        throw std::runtime_error{path + " is not a recording"};
+    }
+
+    // Each record is prefixed by its length.  A record cut short, as by a
+    // recording shell that was killed, ends the recording
+    auto offset = RecordedCommand::header.size();
+    std::uint32_t length;
+    while (recording.size() - offset >= sizeof length) {
+        recording.copy(reinterpret_cast<char*>(&length), sizeof length,
+                offset);
+        length = ntohl(length);
+        offset += sizeof length;
+        if (recording.size() - offset < length) {
+            break;
+        }
+
+        auto command = RecordedCommand::decode(
+                recording.substr(offset, length));
+        offset += length;
+        _commands[command.index] = std::move(command);
+    }
+}
+
+ReplayExecutor::~ReplayExecutor() = default;
+
+int ReplayExecutor::finish(int exitCode)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    if (_isDiverged || _commands.empty()) {
+        return exitCode;
+    }
+
+    _isDiverged = true;
+    std::cerr << "rshell: replay: " << _commands.size()
+        << " recorded commands were not executed\n";
+    return divergenceExitCode;
+}
+
+int ReplayExecutor::execute(ExecutableCommand& command,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    RecordedCommand entry;
+    entry.arguments.push_back(command.program);
+    entry.arguments.insert(std::end(entry.arguments),
+            std::begin(command.arguments), std::end(command.arguments));
+    return serve(std::move(entry), context, waitMode);
+}
+
+int ReplayExecutor::executeSubshell(Command& command,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    RecordedCommand entry;
+    entry.isSubshell = true;
+    if (auto executable = dynamic_cast<ExecutableCommand*>(&command)) {
+        entry.arguments.push_back(executable->program);
+        entry.arguments.insert(std::end(entry.arguments),
+                std::begin(executable->arguments),
+                std::end(executable->arguments));
+    }
+
+    return serve(std::move(entry), context, waitMode);
+}
+
+int ReplayExecutor::execute(DependencyGraph& graph,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    return Executor::execute(graph, context, waitMode);
+}
+
+int ReplayExecutor::serve(RecordedCommand command,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    command.input = RecordingExecutor::digestInput(context);
+    command.environment = RecordingExecutor::digestEnvironment(context);
+
+    RecordedCommand recorded;
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        command.index = _next++;
+        auto found = _commands.find(command.index);
+        auto difference = found == std::end(_commands) ?
+            "expected end of recording, got " + command.describe() :
+            differenceOf(found->second, command);
+        if (_isDiverged || !difference.empty()) {
+            // Report only the first divergence, as every command after it
+            // follows from it
+            if (!_isDiverged) {
+                _isDiverged = true;
+                std::cerr << "rshell: replay: diverged at command "
+                    << command.index << ": " << difference << '\n';
+            }
+
+            throw ExitException{divergenceExitCode};
+        }
+
+        recorded = std::move(found->second);
+        _commands.erase(found);
+    }
+
+    // Flush the standard streams so that output written by builtins before
+    // the command precedes its output
+    std::cout.flush();
+    std::cerr.flush();
+
+    // Read a piped input to its end, as the command did when it was recorded
+    auto input = -1;
+    if (auto pipeStream = dynamic_cast<PosixExecutorPipeStream*>(
+                context.stream(0))) {
+        input = pipeStream->file();
+    }
+
+    auto job = make_unique<ReplayExecutorJob>(
+            RecordingExecutor::outputFileOf(context, 1),
+            RecordingExecutor::outputFileOf(context, 2), input,
+            std::move(recorded.output), std::move(recorded.error),
+            recorded.exitCode);
+    switch (waitMode) {
+        case WaitMode::Continue:
+            context.adopt(std::move(job));
+            return 0;
+
+        case WaitMode::Wait:
+            break;
+    }
+
+    return job->wait().exitCode;
+}
+
+} // namespace rshell
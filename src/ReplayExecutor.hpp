@@ -0,0 +1,117 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::ReplayExecutor class
+
+#ifndef hpp_rshell_ReplayExecutor
+#define hpp_rshell_ReplayExecutor
+
+#include "PosixExecutor.hpp"
+#include "RecordedCommand.hpp"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace rshell {
+
+/// \brief Implementation of the execution algorithm which serves the
+/// results of the commands in a recording made by a \ref RecordingExecutor
+/// within the shell, without forking
+///
+/// Each command executed must match the next command of the recording in
+/// its arguments and the digests of its standard input and environment.
+/// At the first that does not, the replay has diverged from the recording,
+/// and the shell exits.
+class ReplayExecutor : public PosixExecutor
+{
+public:
+    /// \brief Exit code of the shell once the replay has diverged
+    static constexpr int divergenceExitCode = 1;
+
+    /// \brief Constructs a new instance of the \ref ReplayExecutor class
+    /// \param path path of the recording
+    /// \throw std::runtime_error if the recording cannot be read
+    explicit ReplayExecutor(const std::string& path);
+
+    /// \brief Destructs the \ref ReplayExecutor instance
+    virtual ~ReplayExecutor();
+
+    /// \brief Finishes the replay once the shell has run
+    /// \param exitCode exit code of the shell
+    /// \return the exit code given, or \ref divergenceExitCode if any
+    /// recorded command was not executed
+    ///
+    /// Recorded commands left unexecuted are reported, as the replay has
+    /// diverged from the recording.
+    int finish(int exitCode);
+
+    using PosixExecutor::execute;
+
+    /// \brief Serves the recorded results of the individual command given
+    /// \param command command to serve
+    /// \param context context to serve the command within
+    /// \param waitMode wait mode to use when serving
+    /// \return recorded exit code of the command, or zero if not waiting
+    /// \throw ExitException if the command diverges from the recording
+    virtual int execute(ExecutableCommand& command,
+            const ExecutionContext& context,
+            WaitMode waitMode = WaitMode::Wait) override;
+
+    /// \brief Serves the recorded results of the abstract command given as
+    /// a subshell
+    /// \param command command to serve
+    /// \param context context to serve the command within
+    /// \param waitMode wait mode to use when serving
+    /// \return recorded exit code of the command, or zero if not waiting
+    /// \throw ExitException if the command diverges from the recording
+    virtual int executeSubshell(Command& command,
+            const ExecutionContext& context,
+            WaitMode waitMode = WaitMode::Wait) override;
+
+    /// \brief Executes the graph of sequential commands given
+    /// \param graph graph of commands to execute
+    /// \param context context to execute the commands within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the last command in the graph
+    ///
+    /// The commands are executed one at a time in sequence order, as they
+    /// were recorded.
+    virtual int execute(DependencyGraph& graph,
+            const ExecutionContext& context,
+            WaitMode waitMode = WaitMode::Wait) override;
+
+private:
+    /// \brief Recorded commands by index
+    std::map<std::uint32_t, RecordedCommand> _commands;
+
+    std::mutex _mutex; //!< Guards the recorded commands and the index
+    std::uint32_t _next{0}; //!< Index of the next command served
+    bool _isDiverged{false}; //!< Whether or not the replay has diverged
+
+    /// \brief Serves the recorded results of a command
+    /// \param command command as executed, lacking its results
+    /// \param context context to serve the command within
+    /// \param waitMode wait mode to use when serving
+    /// \return recorded exit code of the command, or zero if not waiting
+    int serve(RecordedCommand command, const ExecutionContext& context,
+            WaitMode waitMode);
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_ReplayExecutor
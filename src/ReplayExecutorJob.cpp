@@ -0,0 +1,139 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "ReplayExecutorJob.hpp"
+#include "utility/block_sigpipe.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+using utility::block_sigpipe;
+
+namespace {
+
+/// \brief Size of the chunks results are written and input is read in
+constexpr std::size_t bufferSize = 65536;
+
+/// \brief Interval at which a waiting thread checks whether it is cancelled
+constexpr int cancelInterval = 100;
+
+}
+
+namespace rshell {
+
+ReplayExecutorJob::ReplayExecutorJob(int output, int error, int input,
+        std::string outputData, std::string errorData, int exitCode)
+    : _files{::fcntl(output, F_DUPFD_CLOEXEC, 0),
+        ::fcntl(error, F_DUPFD_CLOEXEC, 0),
+        input < 0 ? -1 : ::fcntl(input, F_DUPFD_CLOEXEC, 0)}
+    , _output(std::move(outputData))
+    , _error(std::move(errorData))
+    , _exitCode{exitCode}
+    , _started{std::chrono::steady_clock::now()}
+{
+    _thread = std::thread{&ReplayExecutorJob::run, this};
+}
+
+ReplayExecutorJob::~ReplayExecutorJob()
+{
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+JobStatus ReplayExecutorJob::wait()
+{
+    if (_isWaited) {
+        throw std::runtime_error{"job has already been waited for"};
+    }
+
+    _isWaited = true;
+    _thread.join();
+
+    JobStatus status;
+    status.exitCode = _exitCode;
+    status.wallTime = std::chrono::steady_clock::now() - _started;
+    return status;
+}
+
+void ReplayExecutorJob::cancel()
+{
+    _isCancelled = true;
+}
+
+void ReplayExecutorJob::run()
+{
+    block_sigpipe();
+
+    // Wait for each descriptor to be ready in intervals, so that the thread
+    // notices when it is cancelled
+    auto await = [this](int file, short events)
+    {
+        pollfd entry{file, events, 0};
+        while (!_isCancelled) {
+            auto count = ::poll(&entry, 1, cancelInterval);
+            if (count > 0 || (count < 0 && errno != EINTR)) {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    const std::string* data[] = {&_output, &_error};
+    for (auto i = 0; i < 2; ++i) {
+        std::size_t written = 0;
+        while (_files[i] >= 0 && written < data[i]->size() &&
+                await(_files[i], POLLOUT)) {
+            auto count = ::write(_files[i], data[i]->data() + written,
+                    std::min(data[i]->size() - written, bufferSize));
+            if (count < 0) {
+                if (errno == EINTR || errno == EAGAIN) {
+                    continue;
+                }
+
+                break;
+            }
+
+            written += count;
+        }
+
+        if (_files[i] >= 0) {
+            ::close(_files[i]);
+        }
+    }
+
+    // Read the input to its end as the command would have, so that the
+    // command writing to it finishes
+    char buffer[bufferSize];
+    while (_files[2] >= 0 && await(_files[2], POLLIN)) {
+        auto count = ::read(_files[2], buffer, sizeof(buffer));
+        if (count == 0 || (count < 0 && errno != EINTR &&
+                    errno != EAGAIN)) {
+            break;
+        }
+    }
+
+    if (_files[2] >= 0) {
+        ::close(_files[2]);
+    }
+}
+
+} // namespace rshell
@@ -0,0 +1,85 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::ReplayExecutorJob class
+
+#ifndef hpp_rshell_ReplayExecutorJob
+#define hpp_rshell_ReplayExecutorJob
+
+#include "ExecutorJob.hpp"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace rshell {
+
+/// \brief Implementation of the executor job on a recorded command served
+/// in continue mode
+///
+/// A thread writes the recorded output to the destinations of the command,
+/// then reads its standard input to the end, as the command would have, so
+/// that a command writing to it is not left waiting.
+class ReplayExecutorJob : public ExecutorJob
+{
+public:
+    /// \brief Constructs a new instance of the \ref ReplayExecutorJob class
+    /// and starts its thread
+    /// \param output descriptor the standard output is written to, which is
+    /// duplicated
+    /// \param error descriptor the standard error is written to, which is
+    /// duplicated
+    /// \param input descriptor the standard input is read from, which is
+    /// duplicated, or -1 to leave it
+    /// \param outputData recorded standard output
+    /// \param errorData recorded standard error
+    /// \param exitCode recorded exit code
+    ReplayExecutorJob(int output, int error, int input,
+            std::string outputData, std::string errorData, int exitCode);
+
+    /// \brief Destructs the \ref ReplayExecutorJob instance
+    ///
+    /// Waits for the thread to finish.
+    virtual ~ReplayExecutorJob();
+
+    ReplayExecutorJob(const ReplayExecutorJob&) = delete;
+    ReplayExecutorJob& operator=(const ReplayExecutorJob&) = delete;
+
+    /// \brief Waits for the recorded results to be written
+    /// \return status of the command, with its recorded exit code
+    virtual JobStatus wait() override;
+
+    /// \brief Stops writing the recorded results
+    virtual void cancel() override;
+
+private:
+    int _files[3]; //!< Descriptors of the output, error, and input
+    std::string _output; //!< Recorded standard output
+    std::string _error; //!< Recorded standard error
+    int _exitCode; //!< Recorded exit code
+    std::atomic<bool> _isCancelled{false}; //!< Whether or not to stop
+    std::chrono::steady_clock::time_point _started; //!< Time of start
+    std::thread _thread; //!< Thread writing the results
+    bool _isWaited{false}; //!< Whether or not the job has been waited for
+
+    /// \brief Writes the recorded results, then drains the input
+    void run();
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_ReplayExecutorJob
@@ -15,6 +15,7 @@
 // SOFTWARE.
 
 #include "SequentialCommand.hpp"
+#include "DependencyGraph.hpp"
 #include "Executor.hpp"
 #include <stdexcept>
 
@@ -22,20 +23,56 @@ namespace rshell {
 
 SequentialCommand::~SequentialCommand() = default;
 
-int SequentialCommand::execute(Executor& executor, WaitMode waitMode)
+int SequentialCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
 {
     if (sequence.empty()) {
         throw std::runtime_error{"incomplete SequentialCommand"};
     }
 
+    // A scope with a timeout carries the remaining time into every command
+    // in it, unless an enclosing deadline is earlier
+    if (timeout.count() > 0) {
+        auto deadline = ExecutionContext::Clock::now() +
+            std::chrono::duration_cast<ExecutionContext::Clock::duration>(
+                    timeout);
+        return executeSequence(executor, context.withDeadline(deadline),
+                waitMode);
+    }
+
+    return executeSequence(executor, context, waitMode);
+}
+
+int SequentialCommand::executeSequence(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    // When concurrency is enabled, let the executor schedule the sequence
+    // according to the dependencies between its commands.  Sequences with
+    // redirected standard streams execute in order, since capturing the
+    // output of their subshells would replace the redirections
+    if (executor.concurrency() > 1 && waitMode == WaitMode::Wait &&
+            context.streams().empty()) {
+        DependencyGraph graph{sequence};
+        return executor.execute(graph, context, waitMode);
+    }
+
     auto exitCode = 0;
     for (auto&& command : sequence) {
         if (command != nullptr) {
-            exitCode = command->execute(executor, waitMode);
+            exitCode = command->execute(executor, context, waitMode);
         }
     }
 
     return exitCode;
 }
 
+void SequentialCommand::prepare(Executor& executor)
+{
+    for (auto&& command : sequence) {
+        if (command != nullptr) {
+            command->prepare(executor);
+        }
+    }
+}
+
 } // namespace rshell
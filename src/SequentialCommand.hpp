@@ -21,6 +21,7 @@
 #define hpp_rshell_SequentialCommand
 
 #include "Command.hpp"
+#include <chrono>
 #include <memory>
 #include <vector>
 
@@ -33,14 +34,35 @@ public:
     /// \brief Sequence of commands to execute
     std::vector<std::unique_ptr<Command>> sequence;
 
+    /// \brief Time after the sequence starts by which every command in it
+    /// must finish, or zero for no deadline of its own
+    std::chrono::nanoseconds timeout{0};
+
     /// \brief Destructs the \ref SequentialCommand instance
     virtual ~SequentialCommand();
 
     /// \brief Executes the command using the given executor
     /// \param executor executor to use for execution
+    /// \param context context to execute the command within
     /// \param waitMode wait mode to use when executing
     /// \return exit code of the command
-    virtual int execute(Executor& executor, WaitMode waitMode) override;
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Prepares the command for repeated execution using the given
+    /// executor
+    /// \param executor executor to prepare with
+    virtual void prepare(Executor& executor) override;
+
+private:
+    /// \brief Executes the sequence within the given context, which carries
+    /// the deadline of the sequence
+    /// \param executor executor to use for execution
+    /// \param context context to execute the sequence within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the last command
+    int executeSequence(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode);
 };
 
 } // namespace rshell
@@ -0,0 +1,174 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "SetBuiltinCommand.hpp"
+#include "Executor.hpp"
+#include "utility/parse_size.hpp"
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+/// \brief Whether or not the calling thread is executing the command in a
+/// subshell of its own
+thread_local bool isInSubshell = false;
+
+}
+
+namespace rshell {
+
+SetBuiltinCommand::~SetBuiltinCommand() = default;
+
+int SetBuiltinCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    // Without an option name, list the options and their states
+    if (arguments.size() == 1 &&
+            (arguments.front() == "-o" || arguments.front() == "+o")) {
+        // The listing is written to the standard output of the process
+        // executing the command, so should the context replace it, the
+        // command executes in a subshell where it is in place
+        if (context.stream(STDOUT_FILENO) != nullptr && !isInSubshell) {
+            isInSubshell = true;
+            try {
+                auto exitCode = executor.executeSubshell(*this, context,
+                        waitMode);
+                isInSubshell = false;
+                return exitCode;
+            }
+            catch (...) {
+                isInSubshell = false;
+                throw;
+            }
+        }
+
+        std::cout << "cachedir " << (executor.cacheDirectory().empty() ?
+                "default" : executor.cacheDirectory())
+            << "\ncachesize " << executor.cacheLimit()
+            << "\npipebuffer " << executor.pipeBufferLimit()
+            << "\npipefail " << (executor.isPipefail() ? "on" : "off")
+            << "\npipegrow " << (executor.isPipeGrowth() ? "on" : "off")
+            << "\npipeprofile " << (executor.isPipeProfile() ? "on" : "off")
+            << "\npipesize ";
+        if (executor.pipeCapacity() > 0) {
+            std::cout << executor.pipeCapacity() << std::endl;
+        }
+        else {
+            std::cout << "default" << std::endl;
+        }
+
+        return 0;
+    }
+
+    if (arguments.size() != 2 ||
+            (arguments.front() != "-o" && arguments.front() != "+o")) {
+        std::cerr << "rshell: set: usage: set -o|+o [option]\n";
+        return 1;
+    }
+
+    auto isEnabled = arguments.front() == "-o";
+    auto& option = arguments.back();
+    if (option == "pipefail") {
+        executor.setPipefail(isEnabled);
+        return 0;
+    }
+
+    if (option == "pipegrow") {
+        executor.setPipeGrowth(isEnabled);
+        return 0;
+    }
+
+    if (option == "pipeprofile") {
+        executor.setPipeProfile(isEnabled);
+        return 0;
+    }
+
+    // The pipe size option takes a value when enabled, as in
+    // "set -o pipesize=1M", and restores the default of the system when
+    // disabled
+    auto separator = option.find('=');
+    if (option.substr(0, separator) == "pipesize") {
+        std::size_t capacity = 0;
+        if (isEnabled && (separator == std::string::npos ||
+                    !utility::parse_size(option.substr(separator + 1),
+                        capacity) || capacity == 0)) {
+            std::cerr << "rshell: set: pipesize: invalid size\n";
+            return 1;
+        }
+
+        executor.setPipeCapacity(capacity);
+        return 0;
+    }
+
+    // The pipe buffer option likewise takes a value when enabled, and
+    // restores the default of the executor when disabled
+    if (option.substr(0, separator) == "pipebuffer") {
+        std::size_t limit = Executor::defaultPipeBufferLimit;
+        if (isEnabled && (separator == std::string::npos ||
+                    !utility::parse_size(option.substr(separator + 1),
+                        limit))) {
+            std::cerr << "rshell: set: pipebuffer: invalid size\n";
+            return 1;
+        }
+
+        executor.setPipeBufferLimit(limit);
+        return 0;
+    }
+
+    // The cache options likewise take a value when enabled, and restore
+    // the defaults when disabled
+    if (option.substr(0, separator) == "cachedir") {
+        if (isEnabled && (separator == std::string::npos ||
+                    separator + 1 == option.size())) {
+            std::cerr << "rshell: set: cachedir: invalid path\n";
+            return 1;
+        }
+
+        executor.setCacheDirectory(isEnabled ?
+                option.substr(separator + 1) : std::string{});
+        return 0;
+    }
+
+    if (option.substr(0, separator) == "cachesize") {
+        std::size_t limit = Executor::defaultCacheLimit;
+        if (isEnabled && (separator == std::string::npos ||
+                    !utility::parse_size(option.substr(separator + 1),
+                        limit))) {
+            std::cerr << "rshell: set: cachesize: invalid size\n";
+            return 1;
+        }
+
+        executor.setCacheLimit(limit);
+        return 0;
+    }
+
+    std::cerr << "rshell: set: " << option << ": unknown option\n";
+    return 1;
+}
+
+void SetBuiltinCommand::prepare(Executor& executor)
+{
+    // Builtins execute within the shell and require no preparation
+}
+
+bool SetBuiltinCommand::isExternal() const
+{
+    return false;
+}
+
+} // namespace rshell
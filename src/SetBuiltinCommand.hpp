@@ -0,0 +1,74 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::SetBuiltinCommand class
+
+#ifndef hpp_rshell_SetBuiltinCommand
+#define hpp_rshell_SetBuiltinCommand
+
+#include "ExecutableCommand.hpp"
+
+namespace rshell {
+
+/// \brief Represents an invocation of the set builtin command
+///
+/// The set command enables shell options with "-o name" and disables them
+/// with "+o name".  Without a name, it lists the options and their states.
+/// The options are as follows:
+///
+/// - cachedir=PATH: the directory of the command result cache, by default
+///   rshell under $XDG_CACHE_HOME or $HOME/.cache
+/// - cachesize=SIZE: the bytes of results the cache keeps before evicting
+///   the least recently used, with an optional K, M, or G suffix
+/// - pipebuffer=SIZE: the bytes a buffered pipe ("a |+ b") holds in memory
+///   before spilling to a file, with an optional K, M, or G suffix
+/// - pipefail: the exit code of a pipeline is that of its last failing
+///   stage rather than that of its last stage
+/// - pipegrow: the pipes of a pipeline double in capacity while they stay
+///   full, up to the maximum of the system
+/// - pipeprofile: the pipes of a pipeline are relayed by the shell, which
+///   reports the traffic through each and names the slowest stage
+/// - pipesize=SIZE: the capacity of pipes without one of their own, in
+///   bytes with an optional K, M, or G suffix
+class SetBuiltinCommand : public ExecutableCommand
+{
+public:
+    /// \brief Destructs the \ref SetBuiltinCommand instance
+    virtual ~SetBuiltinCommand();
+
+    /// \brief Executes the command using the given executor
+    /// \param executor executor to use for execution
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the command
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Prepares the command for repeated execution using the given
+    /// executor
+    /// \param executor executor to prepare with
+    virtual void prepare(Executor& executor) override;
+
+    /// \brief Gets a value indicating whether or not the command only starts
+    /// an external program
+    /// \return \c false, as builtins execute within the shell
+    virtual bool isExternal() const override;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_SetBuiltinCommand
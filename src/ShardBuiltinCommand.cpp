@@ -0,0 +1,632 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "ShardBuiltinCommand.hpp"
+#include "Executor.hpp"
+#include "ExecutorJob.hpp"
+#include "ExecutorPipe.hpp"
+#include "ExecutorStream.hpp"
+#include "Parser.hpp"
+#include "PosixExecutorPipeStream.hpp"
+#include "utility/make_unique.hpp"
+#include "utility/parse_size.hpp"
+#include "utility/pipe_file.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+
+using utility::make_unique;
+using utility::pipe_file;
+
+namespace {
+
+using namespace rshell;
+
+/// \brief Default size of each block of input in bytes
+constexpr std::size_t defaultBlockSize = 1048576;
+
+/// \brief Size of the buffer standard input and the copies are read into
+constexpr std::size_t bufferSize = 65536;
+
+/// \brief Whether or not the calling thread is executing the command in a
+/// subshell of its own
+thread_local bool isInSubshell = false;
+
+/// \brief Copy of the sharded program and the data in flight to and from it
+struct Shard
+{
+    std::shared_ptr<ExecutorPipe> input; //!< Pipe read by the copy
+    std::shared_ptr<ExecutorPipe> output; //!< Pipe written by the copy
+    int sink{-1}; //!< Write end of the input, or -1 once closed
+    int source{-1}; //!< Read end of the output, or -1 once closed
+    std::string queued; //!< Input yet to be written to the copy
+    std::string produced; //!< Output yet to be written by the shell
+    std::unique_ptr<ExecutorJob> job; //!< Job of the copy
+};
+
+/// \brief Parses a positive decimal number
+/// \param text text to parse
+/// \param value parsed number
+/// \return whether or not the text is a positive decimal number
+bool parseNumber(const std::string& text, std::size_t& value)
+{
+    if (text.empty() ||
+            text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+
+    std::istringstream input{text};
+    return input >> value && value > 0;
+}
+
+/// \brief Starts a copy of the sharded program
+/// \param executor executor to use for execution
+/// \param context context to execute the copy within
+/// \param command command of the program
+/// \return copy of the program
+std::unique_ptr<Shard> startShard(Executor& executor,
+        const ExecutionContext& context, Command& command)
+{
+    auto shard = make_unique<Shard>();
+    shard->input = executor.createPipe();
+    shard->output = executor.createPipe();
+
+    auto slot = &shard->job;
+    executor.start(command, context
+        .withJobHandler([slot](std::unique_ptr<ExecutorJob> job)
+        {
+            *slot = std::move(job);
+        })
+        .withStream(STDIN_FILENO, std::shared_ptr<ExecutorStream>{
+            shard->input, &shard->input->inputStream()})
+        .withStream(STDOUT_FILENO, std::shared_ptr<ExecutorStream>{
+            shard->output, &shard->output->outputStream()}));
+
+    // The shell moves the data of every copy from one thread, so it must
+    // never block on any one copy.  The copy holds its own ends
+    shard->input->inputStream().close();
+    shard->output->outputStream().close();
+    shard->sink = pipe_file(shard->input->outputStream(), "sharded");
+    shard->source = pipe_file(shard->output->inputStream(), "sharded");
+    ::fcntl(shard->sink, F_SETFL, O_NONBLOCK);
+    ::fcntl(shard->source, F_SETFL, O_NONBLOCK);
+    return shard;
+}
+
+/// \brief Closes the input of a copy, ending its data
+/// \param shard copy to close the input of
+void closeSink(Shard& shard)
+{
+    if (shard.sink >= 0) {
+        shard.sink = -1;
+        shard.queued.clear();
+        shard.input->outputStream().close();
+    }
+}
+
+/// \brief Closes the output of a copy once its data has ended
+/// \param shard copy to close the output of
+void closeSource(Shard& shard)
+{
+    if (shard.source >= 0) {
+        shard.source = -1;
+        shard.output->inputStream().close();
+    }
+}
+
+/// \brief Waits for a copy to terminate
+/// \param shard copy to wait for
+/// \return exit code of the copy
+int finishShard(Shard& shard)
+{
+    closeSink(shard);
+    closeSource(shard);
+    auto exitCode = shard.job != nullptr ? shard.job->wait().exitCode : 0;
+    shard.job.reset();
+    return exitCode;
+}
+
+/// \brief Writes to a pipe without raising SIGPIPE should its reader have
+/// gone
+/// \param file descriptor of the pipe
+/// \param data data to write
+/// \param length length of the data in bytes
+/// \return number of bytes written, or -1 on error
+ssize_t writePipe(int file, const char* data, std::size_t length)
+{
+    sigset_t signals;
+    sigset_t previous;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &signals, &previous);
+
+    // A broken pipe leaves SIGPIPE pending, which is taken before it can be
+    // unblocked
+    auto count = ::write(file, data, length);
+    if (count < 0 && errno == EPIPE) {
+        timespec zero{0, 0};
+        while (::sigtimedwait(&signals, nullptr, &zero) < 0 &&
+                errno == EINTR);
+        errno = EPIPE;
+    }
+
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+    return count;
+}
+
+/// \brief Writes data to standard output in full
+/// \param data data to write
+/// \param length length of the data in bytes
+/// \return whether or not the data was written
+bool writeOutput(const char* data, std::size_t length)
+{
+    while (length > 0) {
+        auto count = ::write(STDOUT_FILENO, data, length);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (errno != EPIPE) {
+                std::perror("rshell: shard: unable to write output");
+            }
+
+            return false;
+        }
+
+        data += count;
+        length -= count;
+    }
+
+    return true;
+}
+
+/// \brief Finds the length of the next block of input
+/// \param pending input yet to be cut into blocks
+/// \param blockSize size of each block in bytes
+/// \param isInputOpen whether or not more input may follow
+/// \return length of the next block, or zero if it is not yet complete
+///
+/// Blocks end with the last whole line that fits.  A line longer than a
+/// block is a block of its own.
+std::size_t blockLength(const std::string& pending, std::size_t blockSize,
+        bool isInputOpen)
+{
+    if (pending.size() < blockSize) {
+        return isInputOpen ? 0 : pending.size();
+    }
+
+    auto end = pending.rfind('\n', blockSize - 1);
+    if (end == std::string::npos) {
+        end = pending.find('\n', blockSize);
+    }
+
+    if (end == std::string::npos) {
+        return isInputOpen ? 0 : pending.size();
+    }
+
+    return end + 1;
+}
+
+/// \brief Hashes the key of a line
+/// \param text text containing the line
+/// \param begin index of the first character of the line
+/// \param end index past the last character of the line
+/// \param field one-based index of the whitespace-separated key field
+/// \return hash of the key of the line, which is empty if the line has too
+/// few fields
+std::size_t hashKeyOf(const std::string& text, std::size_t begin,
+        std::size_t end, std::size_t field)
+{
+    auto isSpace = [&](std::size_t i)
+    {
+        return text[i] == ' ' || text[i] == '\t' || text[i] == '\n' ||
+            text[i] == '\r';
+    };
+
+    auto keyBegin = begin;
+    auto keyEnd = begin;
+    for (; field > 0 && keyEnd < end; --field) {
+        for (keyBegin = keyEnd; keyBegin < end && isSpace(keyBegin);
+                ++keyBegin);
+        for (keyEnd = keyBegin; keyEnd < end && !isSpace(keyEnd); ++keyEnd);
+    }
+
+    if (field > 0) {
+        keyBegin = keyEnd;
+    }
+
+    return std::hash<std::string>{}(text.substr(keyBegin, keyEnd - keyBegin));
+}
+
+/// \brief Moves data to and from copies of the sharded program
+class Sharder
+{
+public:
+    /// \brief Constructs a new instance of the \ref Sharder class
+    /// \param executor executor to use for execution
+    /// \param context context to execute the copies within
+    /// \param command command of the program
+    /// \param copies number of copies running at once
+    /// \param field one-based index of the key field, or zero to cut the
+    /// input into blocks
+    /// \param blockSize size of each block in bytes
+    Sharder(Executor& executor, const ExecutionContext& context,
+            Command& command, std::size_t copies, std::size_t field,
+            std::size_t blockSize)
+        : _executor(executor)
+        , _context(context)
+        , _command(command)
+        , _copies(copies)
+        , _field(field)
+        , _blockSize(blockSize)
+    {
+    }
+
+    /// \brief Moves data until the input has ended and every copy has
+    /// terminated
+    /// \return exit code of the last copy to fail, or zero
+    int run();
+
+private:
+    Executor& _executor; //!< Executor to use for execution
+    const ExecutionContext& _context; //!< Context of the copies
+    Command& _command; //!< Command of the program
+    std::size_t _copies; //!< Number of copies running at once
+    std::size_t _field; //!< Key field, or zero to cut the input into blocks
+    std::size_t _blockSize; //!< Size of each block in bytes
+    std::deque<std::unique_ptr<Shard>> _shards; //!< Running copies
+    std::string _pending; //!< Input yet to be given to a copy
+    bool _isInputOpen{true}; //!< Whether or not more input may follow
+    bool _isOutputOpen{true}; //!< Whether or not the output is open
+    int _exitCode{0}; //!< Exit code of the last copy to fail
+
+    /// \brief Gives the pending input to the copies
+    void dispatch();
+
+    /// \brief Writes the output of the copies that is ready
+    void collect();
+
+    /// \brief Determines whether or not to read more input
+    /// \return whether or not to read more input
+    bool wantsInput() const;
+
+    /// \brief Records the exit code of a copy
+    /// \param exitCode exit code of the copy
+    void record(int exitCode);
+};
+
+int Sharder::run()
+{
+    if (_field > 0) {
+        for (std::size_t i = 0; i < _copies; ++i) {
+            _shards.push_back(startShard(_executor, _context, _command));
+        }
+    }
+
+    std::vector<char> buffer(bufferSize);
+    std::vector<pollfd> entries;
+    std::vector<Shard*> waiting;
+    while (true) {
+        collect();
+        dispatch();
+
+        entries.clear();
+        waiting.clear();
+        if (wantsInput()) {
+            entries.push_back({STDIN_FILENO, POLLIN, 0});
+            waiting.push_back(nullptr);
+        }
+
+        for (auto&& shard : _shards) {
+            if (shard->sink >= 0 && !shard->queued.empty()) {
+                entries.push_back({shard->sink, POLLOUT, 0});
+                waiting.push_back(shard.get());
+            }
+
+            if (shard->source >= 0) {
+                entries.push_back({shard->source, POLLIN, 0});
+                waiting.push_back(shard.get());
+            }
+        }
+
+        if (entries.empty()) {
+            break;
+        }
+
+        if (::poll(entries.data(), entries.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            std::perror("rshell: shard: unable to poll");
+            _exitCode = 1;
+            break;
+        }
+
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].revents == 0) {
+                continue;
+            }
+
+            auto shard = waiting[i];
+            ssize_t count;
+            if (shard == nullptr) {
+                count = ::read(STDIN_FILENO, buffer.data(), buffer.size());
+                if (count > 0) {
+                    _pending.append(buffer.data(), count);
+                }
+                else if (count == 0 || (errno != EINTR && errno != EAGAIN)) {
+                    if (count < 0) {
+                        std::perror("rshell: shard: unable to read input");
+                    }
+
+                    _isInputOpen = false;
+                }
+            }
+            else if (entries[i].fd == shard->sink) {
+                count = writePipe(shard->sink, shard->queued.data(),
+                        shard->queued.size());
+                if (count > 0) {
+                    shard->queued.erase(0, count);
+                }
+                else if (errno != EINTR && errno != EAGAIN) {
+                    // A copy may stop reading early, as head does
+                    if (errno != EPIPE) {
+                        std::perror("rshell: shard: unable to write copy");
+                    }
+
+                    closeSink(*shard);
+                }
+            }
+            else {
+                count = ::read(shard->source, buffer.data(), buffer.size());
+                if (count > 0) {
+                    shard->produced.append(buffer.data(), count);
+                }
+                else if (count == 0 || (errno != EINTR && errno != EAGAIN)) {
+                    if (count < 0) {
+                        std::perror("rshell: shard: unable to read copy");
+                    }
+
+                    closeSource(*shard);
+                }
+            }
+        }
+    }
+
+    for (auto&& shard : _shards) {
+        record(finishShard(*shard));
+    }
+
+    return _exitCode;
+}
+
+void Sharder::dispatch()
+{
+    if (_field == 0) {
+        // Start a copy for each block of input, up to the number of copies
+        // at once
+        while (_shards.size() < _copies && _isOutputOpen) {
+            auto length = blockLength(_pending, _blockSize, _isInputOpen);
+            if (length == 0) {
+                break;
+            }
+
+            _shards.push_back(startShard(_executor, _context, _command));
+            _shards.back()->queued = _pending.substr(0, length);
+            _pending.erase(0, length);
+        }
+    }
+    else {
+        // Give each whole line to the copy chosen by its key, and the
+        // unfinished last line once the input has ended
+        std::size_t begin = 0;
+        while (begin < _pending.size()) {
+            auto end = _pending.find('\n', begin);
+            if (end == std::string::npos) {
+                if (_isInputOpen) {
+                    break;
+                }
+
+                end = _pending.size() - 1;
+            }
+
+            auto hash = hashKeyOf(_pending, begin, end + 1, _field);
+            _shards[hash % _shards.size()]->queued.append(_pending, begin,
+                    end + 1 - begin);
+            begin = end + 1;
+        }
+
+        _pending.erase(0, begin);
+    }
+
+    // A copy whose input has all been written sees the end of its data
+    for (auto&& shard : _shards) {
+        if (shard->queued.empty() && (_field == 0 || !_isInputOpen)) {
+            closeSink(*shard);
+        }
+    }
+}
+
+void Sharder::collect()
+{
+    if (_field == 0) {
+        // Write the output of each block in input order once the copy of
+        // the block has finished
+        while (!_shards.empty() && _shards.front()->source < 0) {
+            auto& shard = *_shards.front();
+            if (_isOutputOpen) {
+                _isOutputOpen = writeOutput(shard.produced.data(),
+                        shard.produced.size());
+            }
+
+            record(finishShard(shard));
+            _shards.pop_front();
+        }
+    }
+    else {
+        // Write each whole line as soon as it is read, and the unfinished
+        // last line once the copy has finished
+        for (auto&& shard : _shards) {
+            auto end = shard->produced.rfind('\n');
+            end = shard->source < 0 ? shard->produced.size() :
+                end != std::string::npos ? end + 1 : 0;
+            if (_isOutputOpen && end > 0) {
+                _isOutputOpen = writeOutput(shard->produced.data(), end);
+            }
+
+            shard->produced.erase(0, end);
+        }
+    }
+
+    // Once the output has gone, the rest of the input is not needed
+    if (!_isOutputOpen) {
+        _isInputOpen = false;
+        _pending.clear();
+        for (auto&& shard : _shards) {
+            closeSink(*shard);
+            closeSource(*shard);
+            shard->produced.clear();
+        }
+    }
+}
+
+bool Sharder::wantsInput() const
+{
+    if (!_isInputOpen) {
+        return false;
+    }
+
+    // Hold no more than about a block of input for each copy
+    if (_field == 0) {
+        return _pending.size() < _blockSize ||
+            blockLength(_pending, _blockSize, true) == 0;
+    }
+
+    for (auto&& shard : _shards) {
+        if (shard->queued.size() >= _blockSize) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Sharder::record(int exitCode)
+{
+    if (exitCode != 0) {
+        _exitCode = exitCode;
+    }
+}
+
+}
+
+namespace rshell {
+
+ShardBuiltinCommand::~ShardBuiltinCommand() = default;
+
+int ShardBuiltinCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    // The command moves data through the standard streams of the process
+    // executing it, so should the context replace them, as for the last
+    // stage of a pipeline, it executes in a subshell where they are in
+    // place.  An executor without subshells executes it here regardless
+    auto isRedirected = context.stream(STDIN_FILENO) != nullptr ||
+        context.stream(STDOUT_FILENO) != nullptr;
+    if (isRedirected && !isInSubshell) {
+        isInSubshell = true;
+        try {
+            auto exitCode = executor.executeSubshell(*this, context,
+                    waitMode);
+            isInSubshell = false;
+            return exitCode;
+        }
+        catch (...) {
+            isInSubshell = false;
+            throw;
+        }
+    }
+
+    std::size_t copies = std::max(std::thread::hardware_concurrency(), 1u);
+    std::size_t field = 0;
+    auto blockSize = defaultBlockSize;
+
+    // Options precede the program, each with its value as the next argument
+    std::size_t index = 0;
+    for (; index + 1 < arguments.size() && arguments[index].size() == 2 &&
+            arguments[index][0] == '-'; index += 2) {
+        auto& option = arguments[index];
+        auto& value = arguments[index + 1];
+        auto isValid =
+            option == "-n" ? parseNumber(value, copies) :
+            option == "-k" ? parseNumber(value, field) :
+            option == "-b" ? utility::parse_size(value, blockSize) &&
+                blockSize > 0 :
+            false;
+        if (!isValid) {
+            std::cerr << "rshell: shard: " << option << ": invalid value\n";
+            return 1;
+        }
+    }
+
+    if (index >= arguments.size()) {
+        std::cerr << "rshell: shard: usage: shard [-n copies] [-k field] "
+            "[-b size] program [argument...]\n";
+        return 1;
+    }
+
+    auto command = Parser::createExecutableCommand(arguments[index]);
+    command->program = arguments[index];
+    command->arguments.assign(std::begin(arguments) + index + 1,
+            std::end(arguments));
+    command->prepare(executor);
+
+    // The output of the copies is written directly to standard output, so
+    // anything the shell has buffered there goes first
+    std::cout.flush();
+    return Sharder{executor, context, *command, copies, field,
+        blockSize}.run();
+}
+
+void ShardBuiltinCommand::prepare(Executor& executor)
+{
+    // Builtins execute within the shell and require no preparation
+}
+
+bool ShardBuiltinCommand::isExternal() const
+{
+    return false;
+}
+
+} // namespace rshell
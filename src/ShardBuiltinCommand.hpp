@@ -0,0 +1,74 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::ShardBuiltinCommand
+/// class
+
+#ifndef hpp_rshell_ShardBuiltinCommand
+#define hpp_rshell_ShardBuiltinCommand
+
+#include "ExecutableCommand.hpp"
+
+namespace rshell {
+
+/// \brief Represents an invocation of the shard builtin command
+///
+/// The shard command runs copies of a program side by side over the lines
+/// of its standard input, as in "a | shard -n 4 transform | c", so a filter
+/// bound to one processor scales across several.  By default the input is
+/// cut into blocks of whole lines, each block is filtered by a copy of its
+/// own with up to the given number at once, and the output of each block is
+/// written in input order.  With "-k field", the given number of copies run
+/// for the whole input instead, each line going to the copy chosen by the
+/// hash of its whitespace-separated field, so lines of one key keep their
+/// order; the output of the copies is merged a line at a time.
+///
+/// The options are as follows:
+///
+/// - -n copies: the number of copies running at once, by default the number
+///   of processors
+/// - -k field: the field whose hash chooses the copy of each line
+/// - -b size: the size of each block, in bytes with an optional K, M, or G
+///   suffix, by default 1M
+class ShardBuiltinCommand : public ExecutableCommand
+{
+public:
+    /// \brief Destructs the \ref ShardBuiltinCommand instance
+    virtual ~ShardBuiltinCommand();
+
+    /// \brief Executes the command using the given executor
+    /// \param executor executor to use for execution
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the last copy to fail, or zero
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Prepares the command for repeated execution using the given
+    /// executor
+    /// \param executor executor to prepare with
+    virtual void prepare(Executor& executor) override;
+
+    /// \brief Gets a value indicating whether or not the command only starts
+    /// an external program
+    /// \return \c false, as builtins execute within the shell
+    virtual bool isExternal() const override;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_ShardBuiltinCommand
@@ -15,15 +15,22 @@
 // SOFTWARE.
 
 #include "Shell.hpp"
+#include "Daemon.hpp"
 #include "ExitException.hpp"
+#include "JobBatch.hpp"
+#include "Journal.hpp"
 #include "Parser.hpp"
 #include "PosixExecutor.hpp"
+#include "RemoteWorker.hpp"
+#include "SetBuiltinCommand.hpp"
 #include "Tokenizer.hpp"
 #include "utility/make_unique.hpp"
 #include <cstdio>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
+#include <fcntl.h>
 #include <limits.h>
 #include <unistd.h>
 
@@ -46,6 +53,8 @@ Shell::Shell()
 {
 }
 
+Shell::~Shell() = default;
+
 void Shell::setInteractive(bool isInteractive)
 {
     _isInteractive = isInteractive;
@@ -56,12 +65,60 @@ void Shell::setInput(std::istream& input)
     _input = &input;
 }
 
+void Shell::setExecutor(std::unique_ptr<Executor> executor)
+{
+    executor->setConcurrency(_executor->concurrency());
+    executor->setPipefail(_executor->isPipefail());
+    executor->setPipeCapacity(_executor->pipeCapacity());
+    executor->setPipeGrowth(_executor->isPipeGrowth());
+    executor->setPipeProfile(_executor->isPipeProfile());
+    executor->setPipeBufferLimit(_executor->pipeBufferLimit());
+    executor->setCacheDirectory(_executor->cacheDirectory());
+    executor->setCacheLimit(_executor->cacheLimit());
+    _executor = std::move(executor);
+}
+
+void Shell::setConcurrency(std::size_t concurrency)
+{
+    _executor->setConcurrency(concurrency);
+}
+
+void Shell::setJournal(std::unique_ptr<Journal> journal)
+{
+    _journal = std::move(journal);
+}
+
 void Shell::process()
 {
     try {
-        auto command = getCommand();
-        if (command != nullptr) {
-            execute(*command);
+        if (_journal == nullptr) {
+            auto command = getCommand();
+            if (command != nullptr) {
+                execute(*command);
+            }
+
+            return;
+        }
+
+        auto tokens = promptCommand();
+        if (tokens.empty()) {
+            return;
+        }
+
+        auto index = _statement++;
+        auto hash = Journal::hash(tokens);
+        auto command = Parser{tokens}.apply();
+
+        // Skip the statements completed by an earlier run, stopping at the
+        // first which is not
+        _isResuming = _isResuming && _journal->isComplete(index, hash);
+        if (_isResuming &&
+                dynamic_cast<SetBuiltinCommand*>(command.get()) == nullptr) {
+            return;
+        }
+
+        if (execute(*command) == 0 && _isRunning && !_isResuming) {
+            _journal->complete(index, hash);
         }
     }
     catch (const std::exception& e) {
@@ -80,6 +137,51 @@ int Shell::run()
     return _exitCode;
 }
 
+int Shell::runBatch(std::size_t concurrency, bool haltsOnFailure)
+{
+    JobBatch batch{*_executor};
+    batch.setHaltsOnFailure(haltsOnFailure);
+
+    while (*_input) {
+        try {
+            auto command = getCommand();
+            if (command != nullptr) {
+                batch.insert(std::move(command));
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "rshell: error: " << e.what() << '\n';
+            return 1;
+        }
+    }
+
+    return batch.run(concurrency);
+}
+
+int Shell::serve(const std::string& path)
+{
+    return Daemon{*_executor}.serve(path);
+}
+
+int Shell::work()
+{
+    // Move the channel off of the standard streams so that the jobs, and any
+    // stray output of the shell, cannot corrupt it
+    auto input = ::fcntl(STDIN_FILENO, F_DUPFD_CLOEXEC, 0);
+    auto output = ::fcntl(STDOUT_FILENO, F_DUPFD_CLOEXEC, 0);
+    auto null = ::open("/dev/null", O_RDONLY);
+    if (input < 0 || output < 0 || null < 0) {
+        std::perror("rshell: unable to set up worker channel");
+        return 1;
+    }
+
+    ::dup2(null, STDIN_FILENO);
+    ::dup2(STDERR_FILENO, STDOUT_FILENO);
+    ::close(null);
+
+    return RemoteWorker{*_executor, input, output}.run();
+}
+
 std::string Shell::buildCommandPrompt() const
 {
     // The intended format for the command prompt is "username@hostname$ ",
@@ -135,6 +237,8 @@ std::vector<Token> Shell::readCommand() const
 
     std::vector<Token> tokens;
     std::string text;
+    auto inDocument = false;
+    std::string delimiter;
     while (true) {
         std::string line;
         if (!std::getline(*_input, line)) {
@@ -144,6 +248,18 @@ std::vector<Token> Shell::readCommand() const
 
         text += line;
 
+        // Within the body of a here-document, only a line consisting of its
+        // delimiter may complete the command, so that a long body is not
+        // tokenized again for every line of it
+        if (inDocument) {
+            line.erase(0, line.find_first_not_of('\t'));
+            if (line != delimiter) {
+                printContinuationPrompt();
+                text += '\n';
+                continue;
+            }
+        }
+
         std::istringstream is{text};
         Tokenizer tokenizer{is};
         tokenizer.apply();
@@ -157,9 +273,12 @@ std::vector<Token> Shell::readCommand() const
         if (tokenizer.inEscape()) {
             text.pop_back(); // Remove backslash
         }
-        else if (tokenizer.inQuote()) {
+        else if (tokenizer.inQuote() || tokenizer.inDocument()) {
             text += '\n';
         }
+
+        inDocument = tokenizer.inDocument();
+        delimiter = tokenizer.documentDelimiter();
     }
 
     return tokens;
@@ -23,6 +23,7 @@
 #include "Command.hpp"
 #include "Executor.hpp"
 #include "Token.hpp"
+#include <cstddef>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -30,6 +31,9 @@
 
 namespace rshell {
 
+// Forward declarations
+class Journal;
+
 /// \brief Presents a user-friendly interface and provides the point of
 /// interaction for accepting and executing user commands
 class Shell
@@ -38,6 +42,9 @@ public:
     /// \brief Constructs a new instance of the \ref Shell class
     Shell();
 
+    /// \brief Destructs the \ref Shell instance
+    ~Shell();
+
     /// \brief Gets a value indicating whether or not the shell is interactive
     /// \return whether or not the shell is interactive
     bool isInteractive() const noexcept { return _isInteractive; }
@@ -54,6 +61,27 @@ public:
     /// \param input reference to the command input stream
     void setInput(std::istream& input);
 
+    /// \brief Sets the executor strategy for commands
+    /// \param executor executor strategy for commands
+    void setExecutor(std::unique_ptr<Executor> executor);
+
+    /// \brief Sets the maximum number of independent sequential commands to
+    /// execute concurrently
+    /// \param concurrency maximum number of concurrent commands
+    /// \see Executor::setConcurrency
+    void setConcurrency(std::size_t concurrency);
+
+    /// \brief Sets the journal recording the statements of the input as they
+    /// complete
+    /// \param journal journal to record in, or \c null for none
+    ///
+    /// Statements which the journal records as complete are skipped until
+    /// the first which it does not, from which the input executes as usual.
+    /// Statements which set shell options are executed regardless, since
+    /// their effect does not outlive the shell.  A statement is complete
+    /// once it succeeds without exiting the shell.
+    void setJournal(std::unique_ptr<Journal> journal);
+
     /// \brief Gets a value indicating whether or not the shell is running
     /// \return whether or not the shell is running
     /// \see exitCode
@@ -77,6 +105,31 @@ public:
     /// \see process
     int run();
 
+    /// \brief Reads every command from the input, then executes them as a
+    /// batch of independent jobs
+    /// \param concurrency number of jobs to execute concurrently
+    /// \param haltsOnFailure whether or not to stop dispatching jobs after
+    /// the first failure
+    /// \return exit code of the batch
+    /// \see JobBatch::run
+    ///
+    /// Each command read from the input, which may be composite, is one job.
+    /// No job is executed if any command fails to parse.
+    int runBatch(std::size_t concurrency, bool haltsOnFailure);
+
+    /// \brief Serves commands submitted over a Unix domain socket until the
+    /// shell is terminated
+    /// \param path path of the socket to listen on
+    /// \return exit code of the shell process
+    /// \see Daemon::serve
+    int serve(const std::string& path);
+
+    /// \brief Executes the jobs of a remote executor connected to the
+    /// standard input and output until it disconnects
+    /// \return exit code of the shell process
+    /// \see RemoteWorker::run
+    int work();
+
 private:
     bool _isInteractive{true}; //!< Whether or not the shell is interactive
     std::istream* _input; //!< Command input stream
@@ -87,6 +140,10 @@ private:
     std::unique_ptr<Executor> _executor; //!< Executor strategy for commands
     std::string _commandPrompt; //!< Text for the command prompt
 
+    std::unique_ptr<Journal> _journal; //!< Journal of completed statements
+    std::size_t _statement{0}; //!< Index of the next statement of the input
+    bool _isResuming{true}; //!< Whether or not statements may be skipped
+
     /// \brief Builds the command prompt text
     /// \return command prompt text
     std::string buildCommandPrompt() const;
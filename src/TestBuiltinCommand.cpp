@@ -37,7 +37,8 @@ namespace rshell {
 
 TestBuiltinCommand::~TestBuiltinCommand() = default;
 
-int TestBuiltinCommand::execute(Executor& executor, WaitMode waitMode)
+int TestBuiltinCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
 {
     // If we are using the symbolic form of the command, we expect the last
     // argument to be a matching bracket.  The absence of this bracket is
@@ -116,4 +117,14 @@ int TestBuiltinCommand::report(bool result)
     }
 }
 
+void TestBuiltinCommand::prepare(Executor& executor)
+{
+    // Builtins execute within the shell and require no preparation
+}
+
+bool TestBuiltinCommand::isExternal() const
+{
+    return false;
+}
+
 } // namespace rshell
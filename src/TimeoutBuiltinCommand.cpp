@@ -0,0 +1,94 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "TimeoutBuiltinCommand.hpp"
+#include "Executor.hpp"
+#include "Parser.hpp"
+#include "utility/parse_duration.hpp"
+#include <chrono>
+#include <iostream>
+#include <utility>
+
+namespace rshell {
+
+TimeoutBuiltinCommand::~TimeoutBuiltinCommand() = default;
+
+int TimeoutBuiltinCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    // Options are those of the timeout program, which scripts written for
+    // other shells pass, so the program is executed in place of the builtin
+    if (!arguments.empty() && arguments[0].size() > 1 &&
+            arguments[0][0] == '-') {
+        ExecutableCommand program;
+        program.program = this->program;
+        program.arguments = arguments;
+        return program.execute(executor, context, waitMode);
+    }
+
+    if (arguments.size() < 2) {
+        std::cerr << "rshell: timeout: usage: timeout duration program "
+            "[argument...]\n";
+        return 1;
+    }
+
+    std::chrono::nanoseconds duration;
+    if (!utility::parse_duration(arguments[0], duration)) {
+        std::cerr << "rshell: timeout: " << arguments[0]
+            << ": invalid duration\n";
+        return 1;
+    }
+
+    auto command = Parser::createExecutableCommand(arguments[1]);
+    command->program = arguments[1];
+    command->arguments.assign(std::begin(arguments) + 2,
+            std::end(arguments));
+
+    // The executor enforces the deadline on the processes it starts, so a
+    // builtin is timed in a subshell of its own
+    auto timed = context.withDeadline(ExecutionContext::Clock::now() +
+            std::chrono::duration_cast<ExecutionContext::Clock::duration>(
+                duration));
+    if (command->isExternal()) {
+        return command->execute(executor, timed, waitMode);
+    }
+
+    return executor.executeSubshell(*command, timed, waitMode);
+}
+
+void TimeoutBuiltinCommand::prepare(Executor& executor)
+{
+    // Prepare the timed command, or the timeout program, in place of this
+    // one
+    if (!arguments.empty() && arguments[0].size() > 1 &&
+            arguments[0][0] == '-') {
+        ExecutableCommand program;
+        program.program = this->program;
+        program.prepare(executor);
+    }
+    else if (arguments.size() >= 2) {
+        auto command = Parser::createExecutableCommand(arguments[1]);
+        command->program = arguments[1];
+        command->prepare(executor);
+    }
+}
+
+bool TimeoutBuiltinCommand::isExternal() const
+{
+    return false;
+}
+
+} // namespace rshell
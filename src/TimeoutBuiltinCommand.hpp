@@ -0,0 +1,68 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::TimeoutBuiltinCommand
+/// class
+
+#ifndef hpp_rshell_TimeoutBuiltinCommand
+#define hpp_rshell_TimeoutBuiltinCommand
+
+#include "ExecutableCommand.hpp"
+
+namespace rshell {
+
+/// \brief Represents an invocation of the timeout builtin command
+///
+/// The timeout command executes another command with a deadline, as in
+/// "timeout 5s program argument...", after which the command is terminated,
+/// then killed if it outlasts a grace period, along with every process it
+/// started.  The duration is a decimal number with an optional ms, s, m, or
+/// h suffix, in seconds by default.  A deadline already set by an enclosing
+/// scope or command is kept if it is earlier.  A command stopped at its
+/// deadline exits with \ref ExecutorJob::timeoutExitCode.
+///
+/// Options, such as "-k 1" or "--preserve-status", are those of the
+/// coreutils timeout program, which is executed in place of the builtin
+/// when any is given.
+class TimeoutBuiltinCommand : public ExecutableCommand
+{
+public:
+    /// \brief Destructs the \ref TimeoutBuiltinCommand instance
+    virtual ~TimeoutBuiltinCommand();
+
+    /// \brief Executes the command using the given executor
+    /// \param executor executor to use for execution
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the timed command
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Prepares the command for repeated execution using the given
+    /// executor
+    /// \param executor executor to prepare with
+    virtual void prepare(Executor& executor) override;
+
+    /// \brief Gets a value indicating whether or not the command only starts
+    /// an external program
+    /// \return \c false, as builtins execute within the shell
+    virtual bool isExternal() const override;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_TimeoutBuiltinCommand
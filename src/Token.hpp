@@ -35,10 +35,17 @@ struct Token
         Sequence, //!< Sequential command delimiter
         Conjunction, //!< Conjunctive command delimiter
         Disjunction, //!< Disjunctive command delimiter
+        Race, //!< Racing command delimiter
         Pipe, //!< Piping command delimiter
+        FanOut, //!< Fan-out command delimiter
+        FanIn, //!< Fan-in command delimiter
         InputRedirection, //!< Input redirection delimiter
         OutputRedirection, //!< Output redirection delimiter
         AppendRedirection, //!< Append redirection delimiter
+        DuplicateRedirection, //!< Descriptor duplication delimiter
+        HereDocument, //!< Here-document delimiter
+        HereString, //!< Here-string delimiter
+        ProcessSubstitution, //!< Process substitution opening delimiter
         OpenScope, //!< Open scope character
         CloseScope, //!< Close scope character
     };
@@ -16,7 +16,9 @@
 
 #include "Tokenizer.hpp"
 #include <istream>
+#include <iterator>
 #include <locale>
+#include <string>
 #include <map>
 #include <stdexcept>
 
@@ -57,7 +59,7 @@ Tokenizer::Tokenizer(std::istream& input)
 
 bool Tokenizer::isValid() const noexcept
 {
-    return !(_inEscape || _inQuote || inScope());
+    return !(_inEscape || _inQuote || _inDocument || inScope());
 }
 
 const std::vector<Token>& Tokenizer::apply()
@@ -71,6 +73,12 @@ const std::vector<Token>& Tokenizer::apply()
         token = next();
     }
 
+    // A here-document whose body has not ended continues on the next line
+    if (!_pendingDocuments.empty()) {
+        delimiterOf(_pendingDocuments.front());
+        _inDocument = true;
+    }
+
     return _tokens;
 }
 
@@ -81,7 +89,7 @@ Token Tokenizer::next()
     // Ignore all white space and comments before the next token
     do {
         // Skip over white space between tokens
-        if (!(_input >> std::ws)) {
+        if (!skipSpace()) {
             return token;
         }
     } while (ignoreComment());
@@ -98,6 +106,10 @@ Token Tokenizer::next()
         return token;
     }
 
+    if (nextFanIn(token)) {
+        return token;
+    }
+
     if (nextInputRedirection(token)) {
         return token;
     }
@@ -117,16 +129,36 @@ Token Tokenizer::next()
     return token;
 }
 
+bool Tokenizer::skipSpace()
+{
+    // The body of a here-document begins on the line after its delimiter,
+    // so any pending bodies are read once the line ends
+
+    auto loc = _input.getloc();
+    auto c = _input.peek();
+    while (c != EOF && std::isspace<char>(c, loc)) {
+        if (_input.get() == '\n' && !_pendingDocuments.empty()) {
+            nextDocuments();
+        }
+
+        c = _input.peek();
+    }
+
+    return c != EOF;
+}
+
 bool Tokenizer::ignoreComment()
 {
     // Comments must start with a # symbol and continue until the next
-    // line feed character
+    // line feed character, which is left to end the line
 
     if (_input.peek() != '#') {
         return false;
     }
 
-    while (_input && _input.get() != '\n');
+    while (_input.peek() != EOF && _input.peek() != '\n') {
+        _input.get();
+    }
 
     return true;
 }
@@ -146,13 +178,27 @@ bool Tokenizer::nextSequence(Token& token)
 
 bool Tokenizer::nextConjunction(Token& token)
 {
-    // Conjunction tokens consists of two consecutive & symbols
+    // Conjunction tokens consists of two consecutive & symbols.  An &
+    // symbol followed by a | symbol is a race delimiter instead
 
     if (_input.peek() != '&') {
         return false;
     }
 
     token.text += _input.get();
+
+    // An & symbol followed by a > symbol redirects both the standard output
+    // and error, as in "&>" and "&>>"
+    if (_input.peek() == '>') {
+        return nextOutputRedirection(token);
+    }
+
+    if (_input.peek() == '|') {
+        token.text += _input.get();
+        token.type = Token::Type::Race;
+        return true;
+    }
+
     if (_input.peek() != '&') {
         throw std::runtime_error{"unexpected &"};
     }
@@ -173,7 +219,39 @@ bool Tokenizer::nextDisjunction(Token& token)
     token.text += _input.get();
     if (_input.peek() != '|') {
         // If there is a single pipe character, the delimiter is a pipe, not
-        // a disjunction
+        // a disjunction.  The pipe may be followed immediately by a +
+        // symbol, making it buffered, then by its capacity in braces, as in
+        // "|+{1M}", or by a * symbol, making it a fan-out
+
+        if (_input.peek() == '*') {
+            token.text += _input.get();
+            token.type = Token::Type::FanOut;
+            return true;
+        }
+
+        // A pipe followed by an & symbol carries the standard error along
+        // with the output, as in "|&"
+        if (_input.peek() == '&') {
+            token.text += _input.get();
+            token.type = Token::Type::Pipe;
+            return true;
+        }
+
+        if (_input.peek() == '+') {
+            token.text += _input.get();
+        }
+
+        if (_input.peek() == '{') {
+            while (_input.peek() != '}') {
+                if (_input.peek() == EOF) {
+                    throw std::runtime_error{"unterminated pipe capacity"};
+                }
+
+                token.text += _input.get();
+            }
+
+            token.text += _input.get();
+        }
 
         token.type = Token::Type::Pipe;
         return true;
@@ -184,28 +262,85 @@ bool Tokenizer::nextDisjunction(Token& token)
     return true;
 }
 
+bool Tokenizer::nextFanIn(Token& token)
+{
+    // Fan-in tokens consist of a * symbol followed by a | symbol, right
+    // after a closing scope character, as in "(foo; bar) *| baz".  A *
+    // symbol anywhere else begins a word instead, as in "echo *| cat"
+
+    if (_input.peek() != '*' || _tokens.empty() ||
+            _tokens.back().type != Token::Type::CloseScope) {
+        return false;
+    }
+
+    _input.get();
+    if (_input.peek() != '|') {
+        _input.putback('*');
+        return false;
+    }
+
+    _input.get();
+    token.text = "*|";
+    token.type = Token::Type::FanIn;
+    return true;
+}
+
 bool Tokenizer::nextInputRedirection(Token& token)
 {
-    // Input redirection tokens consist of a single < symbol
+    // Input redirection tokens consist of a single < symbol, following the
+    // descriptor it replaces, if any
 
     if (_input.peek() != '<') {
         return false;
     }
 
     token.text += _input.get();
+    if (nextDuplication(token) || nextSubstitution(token)) {
+        return true;
+    }
+
+    if (_input.peek() == '<') {
+        // Two consecutive < symbols begin a here-document, whose delimiter
+        // is the next word, and which a - symbol makes strip leading tabs
+        // from its body.  Three begin a here-string, whose text is the
+        // next word
+
+        token.text += _input.get();
+        if (_input.peek() == '<') {
+            token.text += _input.get();
+            token.type = Token::Type::HereString;
+            return true;
+        }
+
+        auto stripsTabs = _input.peek() == '-';
+        if (stripsTabs) {
+            token.text += _input.get();
+        }
+
+        _pendingDocuments.push_back({_tokens.size() + 1, stripsTabs});
+        token.type = Token::Type::HereDocument;
+        return true;
+    }
+
     token.type = Token::Type::InputRedirection;
     return true;
 }
 
 bool Tokenizer::nextOutputRedirection(Token& token)
 {
-    // Output redirection tokens consist of two consecutive > symbols
+    // Output redirection tokens consist of a single > symbol, following the
+    // descriptor it replaces, if any.  Append redirection tokens consist of
+    // two consecutive > symbols
 
     if (_input.peek() != '>') {
         return false;
     }
 
     token.text += _input.get();
+    if (nextDuplication(token) || nextSubstitution(token)) {
+        return true;
+    }
+
     if (_input.peek() != '>') {
         // If there is a single arrow character, the delimiter is an output
         // redirection, not an append redirection
@@ -219,6 +354,101 @@ bool Tokenizer::nextOutputRedirection(Token& token)
     return true;
 }
 
+bool Tokenizer::nextDuplication(Token& token)
+{
+    // Duplication tokens consist of a redirection symbol followed by an &
+    // symbol and the descriptor to copy, or a - symbol to close the
+    // descriptor instead, as in "2>&1" and "<&-".  A redirection combining
+    // the standard output and error, as in "&>", is never a duplication
+
+    if (_input.peek() != '&' || token.text.front() == '&') {
+        return false;
+    }
+
+    token.text += _input.get();
+
+    auto c = _input.peek();
+    if (!std::isdigit<char>(c, _input.getloc()) && c != '-') {
+        throw std::runtime_error{"expected descriptor after " + token.text};
+    }
+
+    token.text += _input.get();
+    token.type = Token::Type::DuplicateRedirection;
+    return true;
+}
+
+bool Tokenizer::nextSubstitution(Token& token)
+{
+    // Process substitution tokens consist of a lone redirection symbol
+    // followed by a left parenthesis, as in "<(" and ">(", and open a scope
+    // that a right parenthesis closes
+
+    if (_input.peek() != '(' || token.text.size() != 1) {
+        return false;
+    }
+
+    token.text += _input.get();
+    token.type = Token::Type::ProcessSubstitution;
+    ++_scopeLevel;
+    return true;
+}
+
+void Tokenizer::nextDocuments()
+{
+    // Each body continues until a line consisting of its delimiter, and
+    // replaces the delimiter word in the token sequence
+
+    while (!_pendingDocuments.empty()) {
+        auto pending = _pendingDocuments.front();
+        auto& delimiter = delimiterOf(pending);
+        std::string body;
+        std::string line;
+        while (true) {
+            if (!std::getline(_input, line)) {
+                return;
+            }
+
+            if (pending.stripsTabs) {
+                line.erase(0, line.find_first_not_of('\t'));
+            }
+
+            if (line == delimiter) {
+                break;
+            }
+
+            // A last line without a line feed may yet be continued
+            if (_input.eof()) {
+                return;
+            }
+
+            body += line;
+            body += '\n';
+        }
+
+        delimiter = std::move(body);
+        _pendingDocuments.erase(std::begin(_pendingDocuments));
+    }
+}
+
+std::string& Tokenizer::delimiterOf(const PendingDocument& pending)
+{
+    if (pending.index >= _tokens.size() ||
+            _tokens[pending.index].type != Token::Type::Word) {
+        throw std::runtime_error{"expected here-document delimiter"};
+    }
+
+    return _tokens[pending.index].text;
+}
+
+std::string Tokenizer::documentDelimiter() const
+{
+    if (!_inDocument) {
+        return {};
+    }
+
+    return _tokens[_pendingDocuments.front().index].text;
+}
+
 bool Tokenizer::nextScope(Token& token)
 {
     // Scope tokens are left and right parentheses
@@ -230,6 +460,20 @@ bool Tokenizer::nextScope(Token& token)
     }
 
     token.text += _input.get();
+
+    // An opening parenthesis may be followed by a deadline for the scope
+    if (token.type == Token::Type::OpenScope && _input.peek() == '{') {
+        while (_input.peek() != '}') {
+            if (_input.peek() == EOF) {
+                throw std::runtime_error{"unterminated scope timeout"};
+            }
+
+            token.text += _input.get();
+        }
+
+        token.text += _input.get();
+    }
+
     return true;
 }
 
@@ -239,8 +483,27 @@ bool Tokenizer::nextWord(Token& token)
     // words in sequence
 
     auto result = false;
-    while (nextDirectWord(token) || nextQuoteWord(token)) {
-        result = true;
+    auto isQuoted = false;
+    while (true) {
+        if (nextDirectWord(token)) {
+            result = true;
+        }
+        else if (nextQuoteWord(token)) {
+            result = true;
+            isQuoted = true;
+        }
+        else {
+            break;
+        }
+    }
+
+    // An unquoted, single digit immediately before a redirection symbol is
+    // the descriptor the redirection replaces, as in "2> foo"
+    if (result && !isQuoted && token.text.size() == 1 &&
+            std::isdigit<char>(token.text[0], _input.getloc())) {
+        if (nextInputRedirection(token) || nextOutputRedirection(token)) {
+            return true;
+        }
     }
 
     return result;
@@ -21,7 +21,9 @@
 #define hpp_rshell_Tokenizer
 
 #include "Token.hpp"
+#include <cstddef>
 #include <iosfwd>
+#include <string>
 #include <vector>
 
 namespace rshell {
@@ -62,12 +64,29 @@ public:
     /// \see isValid
     bool inScope() const noexcept { return _scopeLevel > 0; }
 
+    /// \brief Gets a value indicating whether or not the tokenization
+    /// terminated during the body of a here-document
+    /// \return whether or not the tokenization terminated during the body
+    /// of a here-document
+    /// \see isValid
+    bool inDocument() const noexcept { return _inDocument; }
+
+    /// \brief Gets the delimiter of the here-document the tokenization
+    /// terminated during the body of
+    /// \return delimiter, or an empty string if the tokenization did not
+    /// terminate during the body of a here-document
+    ///
+    /// The body cannot end before a line consisting of the delimiter, less
+    /// any leading tabs, so that lines before it need no tokenization.
+    std::string documentDelimiter() const;
+
     /// \brief Gets a value indicating whether or not the tokenization
     /// terminated normally
     /// \return whether or not the tokenization terminated normally
     /// \see inEscape
     /// \see inQuote
     /// \see inScope
+    /// \see inDocument
     bool isValid() const noexcept;
 
     /// \brief Repeatedly tokenizes the input stream until its end is reached
@@ -93,6 +112,20 @@ private:
     /// \brief Level of scope currently occupied
     int _scopeLevel{0};
 
+    /// \brief Whether or not the tokenization terminated during the body of
+    /// a here-document
+    bool _inDocument{false};
+
+    /// \brief Here-document whose body is yet to be read
+    struct PendingDocument
+    {
+        std::size_t index; //!< Index of the delimiter word in the sequence
+        bool stripsTabs; //!< Whether or not leading tabs are stripped
+    };
+
+    /// \brief Here-documents whose bodies begin on the next line
+    std::vector<PendingDocument> _pendingDocuments;
+
     /// \brief Obtains the next token from the stream
     /// \return next token from the stream
     ///
@@ -100,6 +133,11 @@ private:
     /// instance will have the \ref Token::Type::None classification.
     Token next();
 
+    /// \brief Skips white space, reading the bodies of pending
+    /// here-documents at the end of each line
+    /// \return whether or not any input remains
+    bool skipSpace();
+
     /// \brief Ignores a comment character and all subsequent characters for
     /// the remainder of the line
     /// \return whether or not a comment was ignored
@@ -110,7 +148,7 @@ private:
     /// \return whether or not the tokenization succeeded
     bool nextSequence(Token& token);
 
-    /// \brief Tokenizes a conjunctive command delimiter
+    /// \brief Tokenizes a conjunctive or racing command delimiter
     /// \param token token to output into
     /// \return whether or not the tokenization succeeded
     bool nextConjunction(Token& token);
@@ -120,6 +158,11 @@ private:
     /// \return whether or not the tokenization succeeded
     bool nextDisjunction(Token& token);
 
+    /// \brief Tokenizes a fan-in command delimiter
+    /// \param token token to output into
+    /// \return whether or not the tokenization succeeded
+    bool nextFanIn(Token& token);
+
     /// \brief Tokenizes an input redirection delimiter
     /// \param token token to input to
     /// \return whether or not the tokenization succeeded
@@ -130,6 +173,28 @@ private:
     /// \return whether or not the tokenization succeeded
     bool nextOutputRedirection(Token& token);
 
+    /// \brief Tokenizes the remainder of a descriptor duplication delimiter
+    /// following a redirection symbol
+    /// \param token redirection token to continue
+    /// \return whether or not the tokenization succeeded
+    bool nextDuplication(Token& token);
+
+    /// \brief Tokenizes the remainder of a process substitution delimiter
+    /// following a redirection symbol
+    /// \param token redirection token to continue
+    /// \return whether or not the tokenization succeeded
+    bool nextSubstitution(Token& token);
+
+    /// \brief Reads the bodies of pending here-documents into their
+    /// delimiter words, starting at the beginning of a line
+    void nextDocuments();
+
+    /// \brief Gets the delimiter word of a pending here-document
+    /// \param pending here-document to get the delimiter of
+    /// \return reference to the text of the delimiter word
+    /// \throw std::runtime_error if the here-document has no delimiter
+    std::string& delimiterOf(const PendingDocument& pending);
+
     /// \brief Tokenizes a scope character
     /// \param token token to output into
     /// \return whether or not the tokenization succeeded
@@ -0,0 +1,92 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+#include "UsesBuiltinCommand.hpp"
+#include "Executor.hpp"
+#include "Parser.hpp"
+#include <stdexcept>
+#include <utility>
+
+namespace rshell {
+
+UsesBuiltinCommand::~UsesBuiltinCommand() = default;
+
+UsesBuiltinCommand::Annotation UsesBuiltinCommand::annotation() const
+{
+    // Consume flag and path pairs until the first word that is not a flag,
+    // which begins the annotated command
+    Annotation result;
+    auto arg = std::begin(arguments);
+    while (arg != std::end(arguments)) {
+        if (*arg == "--") {
+            ++arg;
+            break;
+        }
+
+        if (*arg != "-r" && *arg != "-w") {
+            break;
+        }
+
+        auto flag = arg++;
+        if (arg == std::end(arguments)) {
+            throw std::runtime_error{"uses: " + *flag + ": path expected"};
+        }
+
+        auto& paths = *flag == "-r" ? result.reads : result.writes;
+        paths.push_back(*arg++);
+    }
+
+    if (arg == std::end(arguments)) {
+        throw std::runtime_error{"uses: command expected"};
+    }
+
+    result.program = *arg++;
+    result.arguments.assign(arg, std::end(arguments));
+    return result;
+}
+
+int UsesBuiltinCommand::execute(Executor& executor,
+        const ExecutionContext& context, WaitMode waitMode)
+{
+    // The annotation has no effect on execution, so simply execute the
+    // annotated command in place of this one
+    auto annotation = this->annotation();
+    auto command = Parser::createExecutableCommand(annotation.program);
+    command->program = std::move(annotation.program);
+    command->arguments = std::move(annotation.arguments);
+    return command->execute(executor, context, waitMode);
+}
+
+void UsesBuiltinCommand::prepare(Executor& executor)
+{
+    // Prepare the annotated command in place of this one, ignoring any
+    // malformed annotation until it is executed
+    try {
+        auto annotation = this->annotation();
+        auto command = Parser::createExecutableCommand(annotation.program);
+        command->program = std::move(annotation.program);
+        command->prepare(executor);
+    }
+    catch (const std::exception&) {
+    }
+}
+
+bool UsesBuiltinCommand::isExternal() const
+{
+    return false;
+}
+
+} // namespace rshell
@@ -0,0 +1,75 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Contains the interface to the \ref rshell::UsesBuiltinCommand class
+
+#ifndef hpp_rshell_UsesBuiltinCommand
+#define hpp_rshell_UsesBuiltinCommand
+
+#include "ExecutableCommand.hpp"
+#include <string>
+#include <vector>
+
+namespace rshell {
+
+/// \brief Represents an invocation of the uses builtin command
+///
+/// The uses command annotates another command with the paths it reads and
+/// writes so that concurrent execution can order it correctly.  It accepts
+/// any number of -r and -w flags, each followed by a path, then an optional
+/// -- separator, then the program and arguments of the annotated command.
+class UsesBuiltinCommand : public ExecutableCommand
+{
+public:
+    /// \brief Annotation given to the command
+    struct Annotation
+    {
+        std::vector<std::string> reads; //!< Paths read by the command
+        std::vector<std::string> writes; //!< Paths written by the command
+        std::string program; //!< Name of the annotated program
+        std::vector<std::string> arguments; //!< Arguments for the program
+    };
+
+    /// \brief Destructs the \ref UsesBuiltinCommand instance
+    virtual ~UsesBuiltinCommand();
+
+    /// \brief Extracts the annotation from the arguments of the command
+    /// \return annotation given to the command
+    Annotation annotation() const;
+
+    /// \brief Executes the command using the given executor
+    /// \param executor executor to use for execution
+    /// \param context context to execute the command within
+    /// \param waitMode wait mode to use when executing
+    /// \return exit code of the command
+    virtual int execute(Executor& executor, const ExecutionContext& context,
+            WaitMode waitMode) override;
+
+    /// \brief Prepares the command for repeated execution using the given
+    /// executor
+    /// \param executor executor to prepare with
+    virtual void prepare(Executor& executor) override;
+
+    /// \brief Gets a value indicating whether or not the command only starts
+    /// an external program
+    /// \return \c false, as builtins execute within the shell
+    virtual bool isExternal() const override;
+};
+
+} // namespace rshell
+
+#endif // hpp_rshell_UsesBuiltinCommand
@@ -14,17 +14,253 @@
 // ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
 // SOFTWARE.
 
+#include "DaemonConnection.hpp"
+#include "Journal.hpp"
+#include "RecordingExecutor.hpp"
+#include "RemoteExecutor.hpp"
+#include "ReplayExecutor.hpp"
 #include "Shell.hpp"
+#include "utility/make_unique.hpp"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+/// \brief Prints the command line usage of the shell
+/// \param program name the shell was invoked with
+void printUsage(const char* program)
+{
+    std::cerr << "usage: " << program
+        << " [-p concurrency] [-j jobs [-e]] [-s socket | -S] [-r transport]\n"
+        << "       " << std::string(std::strlen(program), ' ')
+        << " [-J journal] [-R record | -P record] [-c command | file]\n"
+        << "       " << program << " -w\n";
+}
+
+/// \brief Holds the descriptors that redirections may name, other than the
+/// standard streams, open on /dev/null, closed on exec
+///
+/// Files the shell opens for itself, such as the script it reads, then
+/// take higher descriptors, which "exec 3< file" cannot replace beneath it.
+void reserveDescriptors()
+{
+    auto null = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+    if (null < 0) {
+        return;
+    }
+
+    for (auto file = STDERR_FILENO + 1; file < 10; ++file) {
+        if (file != null && ::fcntl(file, F_GETFD) == -1) {
+            ::dup3(null, file, O_CLOEXEC);
+        }
+    }
+
+    if (null <= STDERR_FILENO || null >= 10) {
+        ::close(null);
+    }
+}
+
+/// \brief Parses a positive integer option argument
+/// \param argument option argument to parse
+/// \return parsed integer, or zero if the argument is not a positive integer
+int parseCount(const char* argument)
+{
+    try {
+        return std::max(std::stoi(argument), 0);
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+}
 
 int main(int argc, char** argv)
 {
+    reserveDescriptors();
+
     std::ifstream input;
+    std::istringstream commandInput;
     rshell::Shell shell;
+    auto jobs = 0;
+    auto haltsOnFailure = false;
+    auto hasCommand = false;
+    std::string socketPath;
+    std::string transport;
+    std::string journalPath;
+    std::string recordingPath;
+    std::string replayPath;
+    auto isWorker = false;
+
+    int option;
+    while ((option = getopt(argc, argv, "p:j:es:Sc:r:wJ:R:P:")) != -1) {
+        switch (option) {
+            case 'p': {
+                // Concurrent execution of independent sequential commands is
+                // opt-in, with the argument as the concurrency limit
+                auto concurrency = parseCount(optarg);
+                if (concurrency < 1) {
+                    std::cerr << "rshell: error: concurrency must be a "
+                        "positive integer\n";
+                    return 1;
+                }
+
+                shell.setConcurrency(concurrency);
+                break;
+            }
+
+            case 'j':
+                // Batch mode executes each command of the input as an
+                // independent job on the given number of workers
+                jobs = parseCount(optarg);
+                if (jobs < 1) {
+                    std::cerr << "rshell: error: jobs must be a positive "
+                        "integer\n";
+                    return 1;
+                }
+
+                break;
+
+            case 'e':
+                haltsOnFailure = true;
+                break;
+
+            case 's':
+                // Daemon mode serves commands submitted over the socket
+                socketPath = optarg;
+                break;
 
-    if (argc > 1) {
-        auto path = argv[1];
+            case 'S':
+                socketPath = rshell::DaemonConnection::defaultPath();
+                break;
+
+            case 'c':
+                hasCommand = true;
+                commandInput.str(optarg);
+                shell.setInteractive(false);
+                shell.setInput(commandInput);
+                break;
+
+            case 'r':
+                // Commands execute on a worker reached through the transport
+                transport = optarg;
+                break;
+
+            case 'w':
+                isWorker = true;
+                break;
+
+            case 'J':
+                // Statements are journaled as they complete, so that a
+                // failed script resumes where it stopped
+                journalPath = optarg;
+                break;
+
+            case 'R':
+                // Commands are recorded as they execute, so that a later
+                // run may replay their results without executing them
+                recordingPath = optarg;
+                break;
+
+            case 'P':
+                replayPath = optarg;
+                break;
+
+            default:
+                printUsage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (!journalPath.empty()) {
+        // Batch mode, the daemon, and the worker do not execute statements
+        // in order, so they cannot resume
+        if (jobs > 0 || !socketPath.empty() || isWorker) {
+            std::cerr << "rshell: error: a journal cannot be used in batch, "
+                "daemon, or worker mode\n";
+            return 1;
+        }
+
+        try {
+            shell.setJournal(utility::make_unique<rshell::Journal>(
+                        journalPath));
+        }
+        catch (const std::exception& e) {
+            std::cerr << "rshell: error: " << e.what() << '\n';
+            return 1;
+        }
+    }
+
+    rshell::ReplayExecutor* replay = nullptr;
+    if (!recordingPath.empty() || !replayPath.empty()) {
+        // The recording follows the commands of the shell in order, which
+        // other modes do not execute locally or in order
+        if (!recordingPath.empty() && !replayPath.empty()) {
+            std::cerr << "rshell: error: a recording cannot be made while "
+                "replaying\n";
+            return 1;
+        }
+
+        if (jobs > 0 || !socketPath.empty() || isWorker ||
+                !transport.empty()) {
+            std::cerr << "rshell: error: a recording cannot be used in "
+                "batch, daemon, worker, or remote mode\n";
+            return 1;
+        }
+
+        try {
+            if (!recordingPath.empty()) {
+                shell.setExecutor(utility::make_unique<
+                        rshell::RecordingExecutor>(recordingPath));
+            }
+            else {
+                auto executor = utility::make_unique<rshell::ReplayExecutor>(
+                        replayPath);
+                replay = executor.get();
+                shell.setExecutor(std::move(executor));
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "rshell: error: " << e.what() << '\n';
+            return 1;
+        }
+    }
+
+    if (isWorker) {
+        return shell.work();
+    }
+
+    if (!transport.empty()) {
+        // Batch mode and the daemon fork the shell, which cannot share the
+        // connection to the worker
+        if (jobs > 0 || !socketPath.empty()) {
+            std::cerr << "rshell: error: a remote executor cannot be used in "
+                "batch or daemon mode\n";
+            return 1;
+        }
+
+        try {
+            shell.setExecutor(rshell::RemoteExecutor::spawn(transport));
+        }
+        catch (const std::exception& e) {
+            std::cerr << "rshell: error: " << e.what() << '\n';
+            return 1;
+        }
+    }
+
+    if (!socketPath.empty()) {
+        return shell.serve(socketPath);
+    }
+
+    if (optind < argc && !hasCommand) {
+        auto path = argv[optind];
         input.open(path);
         if (!input) {
             std::cerr << "rshell: error: unable to open " << path << '\n';
@@ -35,5 +271,12 @@ int main(int argc, char** argv)
         shell.setInput(input);
     }
 
-    return shell.run();
+    if (jobs > 0) {
+        shell.setInteractive(false);
+        return shell.runBatch(jobs, haltsOnFailure);
+    }
+
+    // A replay leaving recorded commands unexecuted has diverged as well
+    auto exitCode = shell.run();
+    return replay != nullptr ? replay->finish(exitCode) : exitCode;
 }
@@ -0,0 +1,101 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Client which submits a command to the rshell daemon
+
+#include "DaemonConnection.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+/// \brief Prints the command line usage of the client
+/// \param program name the client was invoked with
+void printUsage(const char* program)
+{
+    std::cerr << "usage: " << program << " [-s socket] -c command\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    auto path = rshell::DaemonConnection::defaultPath();
+    std::string command;
+    auto hasCommand = false;
+
+    int option;
+    while ((option = getopt(argc, argv, "s:c:")) != -1) {
+        switch (option) {
+            case 's':
+                path = optarg;
+                break;
+
+            case 'c':
+                command = optarg;
+                hasCommand = true;
+                break;
+
+            default:
+                printUsage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (!hasCommand || optind < argc) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    auto socket = rshell::DaemonConnection::connect(path);
+    if (socket < 0) {
+        std::perror(("rshellc: unable to connect to " + path).c_str());
+        return 1;
+    }
+
+    rshell::DaemonConnection connection{socket};
+
+    // The daemon executes the command with the standard streams and working
+    // directory of the client
+    auto directory = ::open(".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directory < 0) {
+        std::perror("rshellc: unable to open working directory");
+        return 1;
+    }
+
+    std::vector<int> files{STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO,
+        directory};
+    if (!connection.sendRequest(command, files)) {
+        std::perror("rshellc: unable to send command");
+        return 1;
+    }
+
+    ::close(directory);
+
+    auto exitCode = 1;
+    if (!connection.receiveStatus(exitCode)) {
+        std::cerr << "rshellc: error: daemon closed the connection\n";
+        return 1;
+    }
+
+    return exitCode;
+}
@@ -0,0 +1,43 @@
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+// This file provides a helper blocking SIGPIPE in threads of the shell that
+// write to pipes and sockets on behalf of commands.
+
+#ifndef hpp_utility_block_sigpipe
+#define hpp_utility_block_sigpipe
+
+#include <pthread.h>
+#include <signal.h>
+
+namespace utility {
+
+/// \brief Blocks SIGPIPE in the calling thread
+///
+/// Writing to a pipe or socket whose reader has gone then fails with EPIPE
+/// rather than terminating the shell.  The mask is per thread, so threads
+/// which move data between commands call this before their first write and
+/// leave the signal disposition of the commands themselves untouched.
+inline void block_sigpipe()
+{
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+}
+
+} // namespace utility
+
+#endif // hpp_utility_block_sigpipe
@@ -0,0 +1,96 @@
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+// This file provides a parser for durations written with an optional unit
+// suffix, such as 500ms or 1.5m.
+
+#ifndef hpp_utility_parse_duration
+#define hpp_utility_parse_duration
+
+#include <chrono>
+#include <cctype>
+#include <string>
+
+namespace utility {
+
+/// \brief Parses a duration in seconds with an optional fraction and an
+/// optional ms, s, m, or h suffix
+/// \param text text to parse
+/// \param duration parsed duration
+/// \return whether the text is a valid duration
+inline bool parse_duration(const std::string& text,
+        std::chrono::nanoseconds& duration)
+{
+    // Whole and fractional digits are accumulated separately, so that
+    // fractions such as 0.1 are exact to the nanosecond
+    long long whole = 0;
+    long long fraction = 0;
+    long long scale = 1;
+    std::size_t i = 0;
+    for (; i < text.size() && std::isdigit(text[i]) != 0; ++i) {
+        if (whole > 1000000000000LL) {
+            return false;
+        }
+
+        whole = whole * 10 + (text[i] - '0');
+    }
+
+    auto digits = i;
+    if (i < text.size() && text[i] == '.') {
+        for (++i; i < text.size() && std::isdigit(text[i]) != 0; ++i) {
+            if (scale < 1000000000) {
+                fraction = fraction * 10 + (text[i] - '0');
+                scale *= 10;
+            }
+
+            ++digits;
+        }
+    }
+
+    if (digits == 0) {
+        return false;
+    }
+
+    long long unit;
+    auto suffix = text.substr(i);
+    if (suffix == "ms") {
+        unit = 1000000;
+    }
+    else if (suffix.empty() || suffix == "s") {
+        unit = 1000000000;
+    }
+    else if (suffix == "m") {
+        unit = 60LL * 1000000000;
+    }
+    else if (suffix == "h") {
+        unit = 3600LL * 1000000000;
+    }
+    else {
+        return false;
+    }
+
+    // The duration must fit in nanoseconds
+    if (whole > 1000000000000000000LL / unit) {
+        return false;
+    }
+
+    duration = std::chrono::nanoseconds{whole * unit +
+        fraction * (unit / scale) + fraction * (unit % scale) / scale};
+    return true;
+}
+
+} // namespace utility
+
+#endif // hpp_utility_parse_duration
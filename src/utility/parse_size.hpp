@@ -0,0 +1,70 @@
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+// This file provides a parser for byte sizes written with an optional
+// binary unit suffix, such as 64K or 1M.
+
+#ifndef hpp_utility_parse_size
+#define hpp_utility_parse_size
+
+#include <cctype>
+#include <cstddef>
+#include <limits>
+#include <string>
+
+namespace utility {
+
+/// \brief Parses a byte size with an optional K, M, or G suffix
+/// \param text text to parse
+/// \param size parsed size in bytes
+/// \return whether the text is a valid size
+inline bool parse_size(const std::string& text, std::size_t& size)
+{
+    std::size_t value = 0;
+    std::size_t i = 0;
+    for (; i < text.size() && std::isdigit(text[i]) != 0; ++i) {
+        auto digit = static_cast<std::size_t>(text[i] - '0');
+        if (value > (std::numeric_limits<std::size_t>::max() - digit) / 10) {
+            return false;
+        }
+
+        value = value * 10 + digit;
+    }
+
+    if (i == 0 || i + 1 < text.size()) {
+        return false;
+    }
+
+    auto shift = 0;
+    if (i < text.size()) {
+        switch (std::toupper(text[i])) {
+            case 'K': shift = 10; break;
+            case 'M': shift = 20; break;
+            case 'G': shift = 30; break;
+            default: return false;
+        }
+    }
+
+    if (value > (std::numeric_limits<std::size_t>::max() >> shift)) {
+        return false;
+    }
+
+    size = value << shift;
+    return true;
+}
+
+} // namespace utility
+
+#endif // hpp_utility_parse_size
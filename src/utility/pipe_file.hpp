@@ -0,0 +1,49 @@
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+// This file provides a helper getting the descriptor behind a stream of a
+// POSIX pipe, for the threads of the shell which move data through pipes
+// themselves rather than through a command.
+
+#ifndef hpp_utility_pipe_file
+#define hpp_utility_pipe_file
+
+#include "../ExecutorStream.hpp"
+#include "../PosixExecutorPipeStream.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace utility {
+
+/// \brief Gets the descriptor of a stream of a POSIX pipe
+/// \param stream stream of the pipe
+/// \param use adjective describing the use of the pipe in the error, such
+/// as "fanned"
+/// \return descriptor of the stream
+/// \throw std::runtime_error if the stream is not an open POSIX pipe
+inline int pipe_file(rshell::ExecutorStream& stream, const char* use)
+{
+    auto pipeStream = dynamic_cast<rshell::PosixExecutorPipeStream*>(&stream);
+    if (pipeStream == nullptr || pipeStream->file() < 0) {
+        throw std::runtime_error{std::string{use} +
+            " pipe is not an open POSIX pipe"};
+    }
+
+    return pipeStream->file();
+}
+
+} // namespace utility
+
+#endif // hpp_utility_pipe_file
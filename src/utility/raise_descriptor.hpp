@@ -0,0 +1,80 @@
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+// This file provides helpers keeping descriptors above those that
+// redirections and process substitutions may name, such as 2 in 2>&1.
+
+#ifndef hpp_utility_raise_descriptor
+#define hpp_utility_raise_descriptor
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace utility {
+
+/// \brief Lowest descriptor a stream of the shell is kept at, above every
+/// descriptor a redirection or process substitution may name
+constexpr int first_private_descriptor = 64;
+
+/// \brief Duplicates a descriptor at the lowest free descriptor at or above
+/// \ref first_private_descriptor, closed on exec
+/// \param file descriptor to duplicate
+/// \return duplicate, or -1 with errno set on failure
+///
+/// Should the descriptor limit of the shell leave no room at or above
+/// \ref first_private_descriptor, the duplicate is taken at the lowest free
+/// descriptor instead.
+inline int duplicate_descriptor(int file)
+{
+    auto duplicate = ::fcntl(file, F_DUPFD_CLOEXEC, first_private_descriptor);
+    if (duplicate < 0 && (errno == EINVAL || errno == EMFILE)) {
+        duplicate = ::fcntl(file, F_DUPFD_CLOEXEC, 0);
+    }
+
+    return duplicate;
+}
+
+/// \brief Moves a descriptor to the lowest free descriptor at or above
+/// \ref first_private_descriptor, closed on exec
+/// \param file descriptor to move, which is closed once moved
+/// \return moved descriptor, or -1 with errno set on failure
+///
+/// Descriptors already in place are returned as given.  Keeping the
+/// streams of the shell above the descriptors that redirections name lets
+/// a child place every stream on its descriptor in one pass, as placing one
+/// never overwrites another that is yet to be placed.  Should the
+/// descriptor limit of the shell leave no room for the move, the
+/// descriptor is left where it was opened.
+inline int raise_descriptor(int file)
+{
+    if (file < 0 || file >= first_private_descriptor) {
+        return file;
+    }
+
+    auto raised = ::fcntl(file, F_DUPFD_CLOEXEC, first_private_descriptor);
+    if (raised < 0 && (errno == EINVAL || errno == EMFILE)) {
+        return file;
+    }
+
+    auto error = errno;
+    ::close(file);
+    errno = error;
+    return raised;
+}
+
+} // namespace utility
+
+#endif // hpp_utility_raise_descriptor
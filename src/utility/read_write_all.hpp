@@ -0,0 +1,110 @@
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+// This file provides helpers reading and writing an exact number of bytes
+// through a descriptor, as the framed protocols and pipes of the shell
+// require, whatever the kind of the descriptor and its blocking mode.
+
+#ifndef hpp_utility_read_write_all
+#define hpp_utility_read_write_all
+
+#include <cerrno>
+#include <cstddef>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace utility {
+
+/// \brief Waits for a descriptor to become ready
+/// \param file descriptor to wait on
+/// \param events events to wait for
+inline void await_file(int file, short events)
+{
+    pollfd entry{file, events, 0};
+    ::poll(&entry, 1, -1);
+}
+
+/// \brief Reads exactly the given number of bytes from a descriptor
+/// \param file descriptor to read from
+/// \param data buffer to read into
+/// \param size number of bytes to read
+/// \return whether or not all of the bytes were read, which they are not if
+/// the descriptor fails or ends first
+///
+/// Interrupted reads are retried, and a non-blocking descriptor is read as
+/// if blocking.
+inline bool read_all(int file, void* data, std::size_t size)
+{
+    auto bytes = static_cast<char*>(data);
+    while (size > 0) {
+        auto count = ::read(file, bytes, size);
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            await_file(file, POLLIN);
+            continue;
+        }
+        else if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (count <= 0) {
+            return false;
+        }
+
+        bytes += count;
+        size -= count;
+    }
+
+    return true;
+}
+
+/// \brief Writes exactly the given number of bytes to a descriptor
+/// \param file descriptor to write to
+/// \param data buffer to write from
+/// \param size number of bytes to write
+/// \return whether or not all of the bytes were written
+///
+/// Interrupted writes are retried, and a non-blocking descriptor is written
+/// as if blocking.  Sockets are written without raising SIGPIPE when the
+/// peer is gone.
+inline bool write_all(int file, const void* data, std::size_t size)
+{
+    auto bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        auto count = ::send(file, bytes, size, MSG_NOSIGNAL);
+        if (count < 0 && errno == ENOTSOCK) {
+            count = ::write(file, bytes, size);
+        }
+
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            await_file(file, POLLOUT);
+            continue;
+        }
+        else if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (count < 0) {
+            return false;
+        }
+
+        bytes += count;
+        size -= count;
+    }
+
+    return true;
+}
+
+} // namespace utility
+
+#endif // hpp_utility_read_write_all
@@ -0,0 +1,184 @@
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+// This file provides an implementation of the SHA-256 hash function as
+// specified by FIPS 180-4.
+
+#ifndef hpp_utility_sha256
+#define hpp_utility_sha256
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace utility {
+
+/// \brief Computes the SHA-256 digest of data given in any number of parts
+class sha256
+{
+public:
+    /// \brief Appends data to the message
+    /// \param data data to append
+    /// \param size size of the data in bytes
+    void update(const void* data, std::size_t size)
+    {
+        auto bytes = static_cast<const unsigned char*>(data);
+        _length += size;
+        while (size > 0) {
+            auto count = std::min(size, sizeof(_block) - _used);
+            for (std::size_t i = 0; i < count; ++i) {
+                _block[_used + i] = bytes[i];
+            }
+
+            _used += count;
+            bytes += count;
+            size -= count;
+            if (_used == sizeof(_block)) {
+                compress();
+                _used = 0;
+            }
+        }
+    }
+
+    /// \brief Appends a string to the message
+    /// \param text string to append
+    void update(const std::string& text)
+    {
+        update(text.data(), text.size());
+    }
+
+    /// \brief Completes the message and gets its digest
+    /// \return digest as 64 lowercase hexadecimal digits
+    ///
+    /// No more data may be appended once the digest is taken.
+    std::string hex_digest()
+    {
+        // Pad the message with a one bit, zeros, and its length in bits
+        auto bits = _length * 8;
+        unsigned char one = 0x80;
+        update(&one, 1);
+        unsigned char zero = 0;
+        while (_used != sizeof(_block) - 8) {
+            update(&zero, 1);
+        }
+
+        for (auto shift = 56; shift >= 0; shift -= 8) {
+            auto byte = static_cast<unsigned char>(bits >> shift);
+            update(&byte, 1);
+        }
+
+        static const char digits[] = "0123456789abcdef";
+        std::string result;
+        for (auto word : _state) {
+            for (auto shift = 28; shift >= 0; shift -= 4) {
+                result += digits[(word >> shift) & 0xf];
+            }
+        }
+
+        return result;
+    }
+
+private:
+    /// \brief Intermediate hash value
+    std::uint32_t _state[8]{
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+
+    unsigned char _block[64]; //!< Block of the message being filled
+    std::size_t _used{0}; //!< Bytes of the block filled so far
+    std::uint64_t _length{0}; //!< Length of the message in bytes
+
+    /// \brief Rotates a word right
+    /// \param word word to rotate
+    /// \param count number of bits to rotate by
+    /// \return rotated word
+    static std::uint32_t rotate(std::uint32_t word, int count)
+    {
+        return (word >> count) | (word << (32 - count));
+    }
+
+    /// \brief Mixes the filled block into the intermediate hash value
+    void compress()
+    {
+        static const std::uint32_t constants[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+            0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+            0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+            0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+            0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+            0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+            0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+            0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+            0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+        };
+
+        std::uint32_t schedule[64];
+        for (auto i = 0; i < 16; ++i) {
+            schedule[i] = std::uint32_t{_block[i * 4]} << 24 |
+                std::uint32_t{_block[i * 4 + 1]} << 16 |
+                std::uint32_t{_block[i * 4 + 2]} << 8 |
+                std::uint32_t{_block[i * 4 + 3]};
+        }
+
+        for (auto i = 16; i < 64; ++i) {
+            auto s0 = rotate(schedule[i - 15], 7) ^
+                rotate(schedule[i - 15], 18) ^ (schedule[i - 15] >> 3);
+            auto s1 = rotate(schedule[i - 2], 17) ^
+                rotate(schedule[i - 2], 19) ^ (schedule[i - 2] >> 10);
+            schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+        }
+
+        auto a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+        auto e = _state[4], f = _state[5], g = _state[6], h = _state[7];
+        for (auto i = 0; i < 64; ++i) {
+            auto s1 = rotate(e, 6) ^ rotate(e, 11) ^ rotate(e, 25);
+            auto choice = (e & f) ^ (~e & g);
+            auto t1 = h + s1 + choice + constants[i] + schedule[i];
+            auto s0 = rotate(a, 2) ^ rotate(a, 13) ^ rotate(a, 22);
+            auto majority = (a & b) ^ (a & c) ^ (b & c);
+            auto t2 = s0 + majority;
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        _state[0] += a;
+        _state[1] += b;
+        _state[2] += c;
+        _state[3] += d;
+        _state[4] += e;
+        _state[5] += f;
+        _state[6] += g;
+        _state[7] += h;
+    }
+};
+
+} // namespace utility
+
+#endif // hpp_utility_sha256
@@ -21,12 +21,18 @@ run_test() {
     local test_file=$suites_dir/$test_name.sh
     local out_file=$suites_dir/$test_name.out
     local exit_file=$suites_dir/$test_name.exit
+    local args_file=$suites_dir/$test_name.args
+
+    local test_args=""
+    if [[ -f $args_file ]]; then
+        test_args=$(cat $args_file)
+    fi
 
     pushd $(dirname $test_file) > /dev/null
-    test_out="$($rshell $test_file 2>&1)"
+    test_out="$($rshell $test_args $test_file 2>&1)"
     test_exit=$?
     popd > /dev/null
-    rm -f $suites_dir/$test_name*.tmp
+    rm -rf $suites_dir/$test_name*.tmp
 
     local success=1
     if [[ -f $out_file && "$test_out" != "$(cat $out_file)" ]]; then
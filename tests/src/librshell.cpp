@@ -0,0 +1,122 @@
+// rshell
+// Copyright (c) Jeremiah Griffin <jgrif007@ucr.edu>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+// WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+// ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+// WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+// ACTION OF CONTRACT, NEGLIGENCE NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+// SOFTWARE.
+
+/// \file
+/// \brief Program which exercises the \ref rshell::CompiledCommand
+/// interface of the rshell library
+
+#include "rshell.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+/// \brief Executes a compiled command with its standard input and output
+/// connected to pipes
+/// \param command command to execute
+/// \param options options for the execution, whose input and output are
+/// replaced by the pipes
+/// \param input contents to write to the standard input
+/// \param output contents read from the standard output
+/// \return exit code of the command
+int executeWith(rshell::CompiledCommand& command,
+        rshell::CompiledCommand::Options options,
+        const std::string& input, std::string& output)
+{
+    int inputPipe[2];
+    int outputPipe[2];
+    if (::pipe(inputPipe) < 0 || ::pipe(outputPipe) < 0) {
+        std::perror("pipe");
+        std::exit(1);
+    }
+
+    // The input is small enough to fit in the pipe before the command runs
+    if (::write(inputPipe[1], input.data(), input.size()) < 0) {
+        std::perror("write");
+        std::exit(1);
+    }
+    ::close(inputPipe[1]);
+
+    options.input = inputPipe[0];
+    options.output = outputPipe[1];
+    auto exitCode = command.execute(options);
+    ::close(inputPipe[0]);
+    ::close(outputPipe[1]);
+
+    output.clear();
+    char buffer[256];
+    ssize_t count;
+    while ((count = ::read(outputPipe[0], buffer, sizeof(buffer))) > 0) {
+        output.append(buffer, count);
+    }
+    ::close(outputPipe[0]);
+
+    return exitCode;
+}
+
+}
+
+int main()
+{
+    // Compile once and execute repeatedly, with each execution given its
+    // own descriptors and environment
+    rshell::CompiledCommand command{"tr a-z A-Z && printenv SUFFIX"};
+    rshell::CompiledCommand::Options options;
+    options.replacesEnvironment = true;
+
+    auto executions = 50;
+    auto matches = 0;
+    for (auto i = 0; i < executions; ++i) {
+        auto suffix = std::to_string(i);
+        options.environment = {"PATH=" + std::string{std::getenv("PATH")},
+            "SUFFIX=" + suffix};
+
+        std::string output;
+        auto exitCode = executeWith(command, options, "line\n", output);
+        if (exitCode == 0 && output == "LINE\n" + suffix + "\n") {
+            ++matches;
+        }
+    }
+    std::cout << "matched " << matches << " of " << executions
+        << " executions\n";
+
+    rshell::CompiledCommand failing{"echo failing; exit 3"};
+    std::string output;
+    std::cout << "exit " << executeWith(failing, {}, "", output) << ": "
+        << output;
+
+    // A timeout terminates the whole process group, including programs
+    // which ignore the termination and would otherwise write afterward
+    rshell::CompiledCommand stubborn{
+        "sh -c \"trap '' TERM; sleep 2; echo survived\""};
+    rshell::CompiledCommand::Options timed;
+    timed.timeout = std::chrono::milliseconds{200};
+    auto start = std::chrono::steady_clock::now();
+    auto exitCode = executeWith(stubborn, timed, "", output);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "timeout " << exitCode << ": " << output
+        << (elapsed < std::chrono::seconds{2} ? "killed" : "late") << '\n';
+
+    timed.timeout = std::chrono::milliseconds{2000};
+    std::cout << "no timeout " << executeWith(failing, timed, "", output)
+        << ": " << output;
+
+    return 0;
+}
@@ -0,0 +1,4 @@
+echo one
+false
+echo three
+echo four
@@ -0,0 +1,4 @@
+(sleep 0.2; echo one)
+echo two
+(sleep 0.1; echo three); echo four
+echo five
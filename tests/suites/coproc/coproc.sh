@@ -0,0 +1,17 @@
+coproc echoer cat
+coproc prefix sed -u s/^/got:/
+echo hello > %echoer
+head -1 < %echoer
+echo world >> %echoer
+head -1 < %echoer
+echo one > %prefix
+echo two > %prefix
+head -2 < %prefix
+(echo four > %prefix; echo wrote four) | cat
+(head -1 < %prefix) | cat
+coproc > coproc.tmp; echo listed; cat coproc.tmp
+coproc -c echoer && echo closed echoer
+coproc
+echo three > %prefix
+coproc -c prefix && echo closed prefix
+cat < %prefix
@@ -0,0 +1 @@
+sh -c "../../../bin/rshell -s idle.tmp > /dev/null 2>&1 & daemon=$!; while [ ! -S idle.tmp ]; do sleep 0.1; done; ../../../bin/idleclient idle.tmp & idle=$!; sleep 0.2; timeout 2 ../../../bin/rshellc -s idle.tmp -c 'echo served'; echo $?; kill $idle $daemon"
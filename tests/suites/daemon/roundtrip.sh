@@ -0,0 +1 @@
+sh -c "../../../bin/rshell -s roundtrip.tmp > /dev/null 2>&1 & while [ ! -S roundtrip.tmp ]; do sleep 0.1; done; ../../../bin/rshellc -s roundtrip.tmp -c 'echo hello | rev'; echo $?; ../../../bin/rshellc -s roundtrip.tmp -c 'false || exit 7'; echo $?; echo abc | ../../../bin/rshellc -s roundtrip.tmp -c 'tr a-z A-Z'; kill $!"
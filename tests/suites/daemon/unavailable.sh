@@ -0,0 +1 @@
+../../../bin/rshellc -s unavailable.tmp -c "echo unreachable"
@@ -0,0 +1,12 @@
+echo "set -o pipefail" > resume_script.tmp
+echo "echo one | cat" >> resume_script.tmp
+echo "test -e resume_ok.tmp" >> resume_script.tmp
+echo "echo three" >> resume_script.tmp
+../../../bin/rshell -J resume.tmp resume_script.tmp
+touch resume_ok.tmp
+../../../bin/rshell -J resume.tmp resume_script.tmp
+../../../bin/rshell -J resume.tmp resume_script.tmp
+echo "echo four" >> resume_script.tmp
+../../../bin/rshell -J resume.tmp resume_script.tmp
+wc -l < resume.tmp
+../../../bin/rshell -J resume.tmp -j 2 resume_script.tmp
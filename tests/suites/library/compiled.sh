@@ -0,0 +1 @@
+../../../bin/librshell-test
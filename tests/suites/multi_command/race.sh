@@ -0,0 +1,7 @@
+sh -c "sleep 2; echo slow" &| sh -c "sleep 0.2; echo fast"
+(echo a; sleep 0.3; echo b) &| (sleep 2; echo c)
+false &| echo second &| false
+(false &| sh -c "exit 3") || echo all failed
+(seq 1 50000 &| (seq 1 10; sleep 2)) | wc -l
+(echo out &| false) > /dev/stdout
+&| echo invalid
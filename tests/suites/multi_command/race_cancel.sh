@@ -0,0 +1,5 @@
+(echo a) &| (sh -c "sleep 1; echo survived > race_cancel_1.tmp")
+(echo b) &| (sh -c "trap \"\" TERM; sleep 2; echo survived > race_cancel_2.tmp")
+echo c &| sh -c "trap \"\" TERM; sleep 2; echo survived > race_cancel_3.tmp"
+sleep 2.5
+find . -name "race_cancel_*.tmp" | wc -l
@@ -0,0 +1 @@
+echo a; echo b; exit 2; echo c
@@ -0,0 +1 @@
+coproc prefix sed -u s/^/got:/; echo one > %prefix; head -1 < %prefix; echo two > %prefix; echo three > %prefix; head -2 < %prefix; coproc -c prefix && echo closed
@@ -0,0 +1,2 @@
+echo foo > dependencies_1.tmp; cat < dependencies_1.tmp; echo bar >> dependencies_1.tmp; cat < dependencies_1.tmp
+uses -r dependencies_1.tmp -w dependencies_2.tmp cp dependencies_1.tmp dependencies_2.tmp; uses -r dependencies_2.tmp cat dependencies_2.tmp
@@ -0,0 +1,2 @@
+(sleep 0.2; echo first); echo second; echo third
+(sleep 0.1; echo fourth) && echo fifth; echo sixth
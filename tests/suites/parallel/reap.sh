@@ -0,0 +1,3 @@
+coproc quick sh -c "exit 3"
+sleep 0.2; echo a
+coproc -c quick || echo coprocess failed
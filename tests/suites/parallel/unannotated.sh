@@ -0,0 +1 @@
+echo one > unannotated.tmp; cat unannotated.tmp; rm unannotated.tmp; echo two > unannotated.tmp; cat unannotated.tmp; rm unannotated.tmp; cat unannotated.tmp 2> /dev/null || echo removed
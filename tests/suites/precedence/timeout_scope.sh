@@ -0,0 +1,7 @@
+({0.3s} sleep 5; echo skipped) || echo scope timed out
+({5s} echo a; echo b)
+({5s} timeout 0.2 sleep 5) || echo inner deadline
+({200ms} (timeout 5 sleep 5; echo skipped)) || echo outer deadline
+({0.2} sleep 5 | cat; echo skipped)
+pipestatus
+({x} echo invalid)
@@ -0,0 +1 @@
+../../../bin/rshell -r "../../../bin/rshell -w" -c "echo abc | rev | tr a-z A-Z; false || echo recovered"
@@ -0,0 +1 @@
+../../../bin/rshell -r "../../../bin/rshell -w" -c "echo remote > redirection_1.tmp; echo more >> redirection_1.tmp; tr a-z A-Z < redirection_1.tmp"
@@ -0,0 +1,21 @@
+echo "echo one" > diverge_script.tmp
+echo "ls /" >> diverge_script.tmp
+echo "echo three" >> diverge_script.tmp
+../../../bin/rshell -R diverge.tmp diverge_script.tmp > /dev/null
+echo "echo one" > diverge_script.tmp
+echo "ls /nonexistent" >> diverge_script.tmp
+echo "echo three" >> diverge_script.tmp
+../../../bin/rshell -P diverge.tmp diverge_script.tmp 2> diverge_error.tmp || echo replay failed
+cat diverge_error.tmp
+echo b > diverge_input.tmp
+echo "sort < diverge_input.tmp" > diverge_script.tmp
+../../../bin/rshell -R diverge.tmp diverge_script.tmp
+echo a > diverge_input.tmp
+../../../bin/rshell -P diverge.tmp diverge_script.tmp 2> diverge_error.tmp || echo replay failed
+cat diverge_error.tmp
+echo "echo one" > diverge_script.tmp
+echo "echo two" >> diverge_script.tmp
+../../../bin/rshell -R diverge.tmp diverge_script.tmp > /dev/null
+echo "echo one" > diverge_script.tmp
+../../../bin/rshell -P diverge.tmp diverge_script.tmp 2> diverge_error.tmp || echo replay failed
+cat diverge_error.tmp
@@ -0,0 +1,9 @@
+echo "echo one" > record_script.tmp
+echo "printf \"b\na\n\" | sort" >> record_script.tmp
+echo "touch record_side.tmp" >> record_script.tmp
+echo "false || echo fell back" >> record_script.tmp
+echo "yes | head -2" >> record_script.tmp
+../../../bin/rshell -R record.tmp record_script.tmp
+rm -f record_side.tmp
+../../../bin/rshell -P record.tmp record_script.tmp
+test -e record_side.tmp || echo replayed without executing
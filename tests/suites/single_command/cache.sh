@@ -0,0 +1,15 @@
+set -o cachedir=cache.tmp
+echo one > cache_input.tmp
+cache -i cache_input.tmp sh -c "echo ran; cat cache_input.tmp"
+cache -i cache_input.tmp sh -c "echo ran; cat cache_input.tmp" | tr a-z A-Z
+echo two > cache_input.tmp
+cache -i cache_input.tmp sh -c "echo ran; cat cache_input.tmp"
+cache sh -c "echo failed; exit 3" || echo first failure
+cache sh -c "echo failed; exit 3" || echo replayed failure
+cache timeout 0.1 sleep 2 || echo not cached
+set -o cachesize=32
+cache echo evicted
+cache echo kept
+ls cache.tmp | wc -l
+cache -i
+cache
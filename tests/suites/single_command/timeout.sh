@@ -0,0 +1,12 @@
+timeout 0.2 sleep 5 || echo timed out
+timeout 5 echo quick
+timeout 0.2 sh -c "trap '' TERM; sleep 5" || echo killed
+timeout 0.2 sh -c "sleep 5 & sleep 5" || echo group stopped
+timeout 0.3 timeout 5 sleep 5 || echo outer deadline kept
+(timeout 0.2 sleep 5 | cat)
+pipestatus
+timeout -k 1 0.2 sleep 5 || echo options timed out
+timeout -s KILL 0.2 sleep 5 || echo killed by option
+timeout --preserve-status 5 sh -c "exit 3" || echo status preserved
+timeout x sleep 1
+timeout 1
@@ -0,0 +1,20 @@
+echo line1 > exec_redirect_1.tmp
+echo line2 >> exec_redirect_1.tmp
+exec 3< exec_redirect_1.tmp
+head -n 1 <&3
+head -n 1 <&3
+exec 3<&-
+sh -c "(cat <&3) 2>/dev/null || echo closed"
+exec 5>&1 4>> exec_redirect_2.tmp
+exec >&4
+echo logged
+sh -c "echo also logged"
+exec >&5 4>&-
+echo restored
+cat exec_redirect_2.tmp
+exec 6> exec_redirect_3.tmp
+(echo composite >&6; echo stage) | tr a-z A-Z
+(echo nested >&6) | (cat; echo piped >&6)
+exec 6>&-
+cat exec_redirect_3.tmp
+exec ls
@@ -0,0 +1 @@
+sh -c "ulimit -Sn 64; ../../../bin/rshell -c 'echo a | cat | rev; echo b > file_limit.tmp; cat < file_limit.tmp; echo c 2>&1 | cat'"
@@ -0,0 +1,24 @@
+cat <<EOF
+hello
+  world
+EOF
+tr a-z A-Z <<< "here string"
+cat <<-END | rev
+	tabbed
+	END
+wc -c <<< ""
+(cat; echo in scope) << X # comment
+a
+X
+sh -c "cat <&3" 3<<EOF
+three
+EOF
+cat <<A; cat <<B
+one
+A
+two
+B
+seq 1 5000 > here_document_1.tmp
+sh -c "(echo \"cksum <<EOF\"; cat here_document_1.tmp; echo EOF) > here_document_2.tmp"
+../../../bin/rshell here_document_2.tmp 2>&1 | grep -v username
+cksum < here_document_1.tmp
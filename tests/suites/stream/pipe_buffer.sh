@@ -0,0 +1,9 @@
+seq 1 100000 |+ cat | cksum
+seq 1 5 |+{64K} rev
+set -o pipebuffer=4K
+seq 1 200000 |+ cat |+ cat | cksum
+seq 1 1000 |+ head -n 2
+seq 1 50000 |+ sh -c "sleep 1; wc -l"
+set -o
+set +o pipebuffer
+set -o pipebuffer=lots
@@ -0,0 +1,13 @@
+echo abc |{1M} rev
+seq 1 100000 |{256K} cat |{4K} wc -l
+dd if=/dev/zero bs=1K count=1024 oflag=nonblock 2> /dev/null |{256K} sh -c "sleep 0.5; wc -c"
+dd if=/dev/zero bs=1K count=1024 oflag=nonblock 2> /dev/null |{4K} sh -c "sleep 0.5; wc -c"
+set -o pipesize=128K
+dd if=/dev/zero bs=1K count=1024 oflag=nonblock 2> /dev/null | sh -c "sleep 0.5; wc -c"
+set -o pipegrow
+seq 1 100000 | cat | wc -l
+set -o
+set +o pipegrow
+set +o pipesize
+set -o pipesize=large
+echo def |{} rev
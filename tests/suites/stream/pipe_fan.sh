@@ -0,0 +1,13 @@
+(echo abc |* (rev; tr a-z A-Z)) | sort
+(seq 1 100000 |* (wc -l; tail -n 1 | rev; cksum)) | sort
+(echo a; echo b; echo c) *| sort
+(seq 1 50000; seq 50001 100000) *| sort -n | cksum
+echo abc |* (rev; cat; tr a-z A-Z) *| sort
+seq 1 100000 |* (grep 7; grep -v 7) *| sort -n | cksum
+yes |* (head -n 1 > /dev/null; true)
+pipestatus
+(false; true) *| cat
+pipestatus
+echo *| cat
+|* cat
+echo abc |* rev
@@ -0,0 +1,3 @@
+(echo abc | rev) | rev
+(echo def | rev) | (rev; echo ghi) | tr a-z A-Z
+test -e /. | rev
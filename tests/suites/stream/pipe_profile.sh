@@ -0,0 +1,6 @@
+set -o pipeprofile
+exec 2> pipe_profile.tmp
+seq 100000 | (sleep 1; cat) | wc -l
+exec 2>&1
+set +o pipeprofile
+sed -E "s#[0-9.]+ s#N s#g; s#[0-9.]+ MiB/s#N MiB/s#g; s#[0-9.]+%#N%#g" < pipe_profile.tmp
@@ -0,0 +1,11 @@
+seq 1 200000 | shard -n 4 -b 64K sed s/1/one/ | cksum
+seq 1 200000 | shard -n 3 -b 10K grep 7 | cksum
+seq 1 100000 | shard -n 2 -b 1K head -n 1 | wc -l
+(seq 1 1000 | awk "{print \$1 % 7, \$1}" | shard -n 3 -k 1 cat) | sort -n -k 1 -s | cksum
+yes | shard -n 2 cat | head -n 3
+printf abc | shard -n 2 rev
+echo
+seq 1 3 | shard -n 2 sh -c "cat; exit 3"
+pipestatus
+shard
+shard -n 0 cat
@@ -0,0 +1,16 @@
+false | true
+pipestatus
+true | (echo abc; exit 3) | rev | grep -q xyz
+pipestatus
+(false | true) || echo pipeline failed
+set -o pipefail
+(false | true) || echo pipeline failed
+(false | exit 4 | true) || pipestatus
+set +o pipefail
+false | (exit 5) | true
+pipestatus > pipe_status.tmp; echo written; cat pipe_status.tmp
+false | (exit 5) | true
+pipestatus | rev
+set -o
+set -o > pipe_status.tmp; echo listed; grep pipefail pipe_status.tmp
+set -o nonexistent
@@ -0,0 +1,11 @@
+diff <(seq 1 5) <(seq 1 6)
+paste <(seq 1 3) <(seq 4 6) | sort -r
+cat <(echo a) - <(echo c) <<< b
+seq 1 3 | tee >(tr 1-3 a-c) > /dev/null
+cat <(cat <(echo nested))
+head -n 1 <(seq 1 1000000)
+echo <(true) <(true) after
+sh -c "cat \$0 > process_substitution_1.tmp" <(echo redirected)
+cat process_substitution_1.tmp
+cat <(echo scoped; echo twice) | tr a-z A-Z
+cat > <(true)
@@ -0,0 +1,22 @@
+echo one >> redirect_cache_1.tmp
+echo two >> redirect_cache_1.tmp
+echo three >> redirect_cache_1.tmp
+cat < redirect_cache_1.tmp
+head -1 < redirect_cache_1.tmp
+head -1 < redirect_cache_1.tmp
+cat < redirect_cache_1.tmp | cat - redirect_cache_1.tmp | wc -l
+paste <(cat < redirect_cache_1.tmp) <(cat < redirect_cache_1.tmp)
+mv redirect_cache_1.tmp redirect_cache_2.tmp
+echo four >> redirect_cache_1.tmp
+cat < redirect_cache_1.tmp
+rm redirect_cache_1.tmp
+echo five >> redirect_cache_1.tmp
+cat < redirect_cache_1.tmp
+echo six > redirect_cache_1.tmp
+cat < redirect_cache_1.tmp
+echo hidden > /dev/null
+cat < /dev/null
+exec 3< redirect_cache_2.tmp
+head -1 <&3
+head -1 < redirect_cache_2.tmp
+head -1 <&3
@@ -0,0 +1,15 @@
+sh -c "echo out; echo err >&2" 2> redirect_descriptor_1.tmp
+cat redirect_descriptor_1.tmp
+sh -c "echo out; echo err >&2" > redirect_descriptor_2.tmp 2>&1
+sort redirect_descriptor_2.tmp
+sh -c "echo out; echo err >&2" 2>&1 > redirect_descriptor_3.tmp | tr a-z A-Z
+cat redirect_descriptor_3.tmp
+sh -c "echo out; echo err >&2" &> redirect_descriptor_4.tmp
+sh -c "echo more >&2" &>> redirect_descriptor_4.tmp
+sort redirect_descriptor_4.tmp
+sh -c "echo out; echo err >&2" |& sort
+sh -c "echo out; echo err >&2" 2> redirect_descriptor_5.tmp |& tr a-z A-Z
+sh -c "cat <&3" 3< redirect_descriptor_1.tmp
+sh -c "echo out 2>/dev/null || echo closed >&2" 2>&1 >&-
+echo 2 > redirect_descriptor_6.tmp
+cat redirect_descriptor_6.tmp